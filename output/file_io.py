@@ -112,4 +112,28 @@ def dic2file(outputFile, D):
         f.writelines(Text)
         f.close()
 
+########################################################################
+
+def csv2dic(inputFile):
+
+        """
+        Reads a CSV file written by cyder_reduce into a dictionary of
+        column name to list. Every column but File is converted to float.
+        inputs:
+        input file
+        """
+
+        f = open(inputFile, 'r')
+        labels = f.readline().strip().split(',')
+        D = dict((label, []) for label in labels)
+        for line in f:
+                values = line.strip().split(',')
+                for label, value in zip(labels, values):
+                        if label == 'File':
+                                D[label].append(value)
+                        else:
+                                D[label].append(float(value))
+        f.close()
+        return D
+
 #dic2file('test.txt', {'sdrg':[0,4,2,8,28,5,1,5], 'sdfrg':[1,2,58,21,5,5]})
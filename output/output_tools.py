@@ -503,6 +503,12 @@ class Query(object):
             c.execute("SELECT CyderParams.capacity " +
                 "FROM CyderParams ")
         else :
+            # copies of a template share the params recorded for the template
+            c.execute("SELECT components.paramsID FROM components " +
+                "WHERE components.CompID=" + str(compID))
+            for row in c :
+                if row[0] >= 0 :
+                    compID = row[0]
             c.execute("SELECT NuclideModelParams.ParamVal " +
                 "FROM NuclideModelParams "+
                 "WHERE NuclideModelParams.CompID=" + str(compID) + " " +
@@ -1,5 +1,6 @@
 import matplotlib
 import os
+import sqlite3
 from output_tools import Query
 from numpy import cumsum
 from file_io import list2file
@@ -37,6 +38,47 @@ def plot_contaminants(dbname, plttype, pltname, stream_dim='IsoID', select_dim=N
     query.clear_fig()
 
 
+def repo_totals(dbname, comp_type, iso):
+    """
+    Returns the (time, mass) rows of one isotope in one component type, from
+    the repoTotals table that Cyder aggregates during the run.
+    """
+    conn = sqlite3.connect(dbname)
+    c = conn.cursor()
+    c.execute("SELECT Time, MassKG FROM repoTotals " +
+              "WHERE CompType = ? AND IsoID = ? ORDER BY Time",
+              (comp_type, iso))
+    return c.fetchall()
+
+
+def cumulative_release(dbname, iso):
+    """
+    Returns the (time, cumulative kg) rows of one isotope's release to the
+    far field, from the repoReleases table.
+    """
+    conn = sqlite3.connect(dbname)
+    c = conn.cursor()
+    c.execute("SELECT Time, CumulativeKG FROM repoReleases " +
+              "WHERE IsoID = ? ORDER BY Time", (iso,))
+    return c.fetchall()
+
+
+def peak_concentrations(dbname):
+    """
+    Returns the peak concentration of each isotope in each component type
+    over the run as a dict of (CompType, IsoID) to (time, conc), from the
+    repoPeaks table, whose last row for each pair is its peak.
+    """
+    conn = sqlite3.connect(dbname)
+    c = conn.cursor()
+    c.execute("SELECT CompType, IsoID, Time, PeakConc FROM repoPeaks " +
+              "ORDER BY Time")
+    peaks = {}
+    for row in c:
+        peaks[(row[0], row[1])] = (row[2], row[3])
+    return peaks
+
+
 def plot_all_comps(dbname, plttype, pltroot):
     query = query_contaminants(dbname)
     comps = query.get_comp_list()
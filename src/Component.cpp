@@ -3,6 +3,7 @@
  * \author Kathryn D. Huff
  */
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -36,10 +37,16 @@ Component::Component(Model* creator) :
   nuclide_model_(StubNuclide::create()),
   mat_table_(),
   parent_(),
+  fill_(0),
+  inert_kg_(0),
   temp_(0),
   peak_inner_temp_(0),
   peak_outer_temp_(0),
-  temp_lim_(373){
+  temp_lim_(373),
+  delta_encoded_(false),
+  rel_tol_(0),
+  abs_tol_(0),
+  abs_conc_tol_(0){
 
   creator_ = creator;
   set_geom(GeometryPtr(new Geometry()));
@@ -76,11 +83,46 @@ void Component::initModuleMembers(QueryEngine* qe){
   double ref_sol = NULL;
   if( n_sol!=0 ) { ref_sol=lexical_cast<double>(mat_data->getElementContent("ref_sol_lim")); };
 
+  int n_step = qe->nElementsMatchingQuery("step_size");
+  int step_size = 1;
+  if( n_step!=0 ) { step_size=lexical_cast<int>(qe->getElementContent("step_size")); };
+
+  int n_adaptive = qe->nElementsMatchingQuery("adaptive");
+  double step_tol = 0;
+  int max_step_size = step_size;
+  if( n_adaptive!=0 ) { 
+    QueryEngine* adaptive = qe->queryElement("adaptive");
+    step_tol=lexical_cast<double>(adaptive->getElementContent("tolerance")); 
+    max_step_size=lexical_cast<int>(adaptive->getElementContent("max_step_size")); 
+  };
+
+  bool sensitivities = (qe->nElementsMatchingQuery("sensitivities") != 0);
+
+  int n_tol = qe->nElementsMatchingQuery("contaminant_tolerance");
+  double rel_tol = 0;
+  double abs_tol = 0;
+  double abs_conc_tol = 0;
+  if( n_tol!=0 ) { 
+    QueryEngine* tol = qe->queryElement("contaminant_tolerance");
+    if( tol->nElementsMatchingQuery("relative")!=0 ) {
+      rel_tol=lexical_cast<double>(tol->getElementContent("relative")); 
+    }
+    if( tol->nElementsMatchingQuery("absolute")!=0 ) {
+      abs_tol=lexical_cast<double>(tol->getElementContent("absolute")); 
+    }
+    if( tol->nElementsMatchingQuery("absolute_conc")!=0 ) {
+      abs_conc_tol=lexical_cast<double>(tol->getElementContent("absolute_conc")); 
+    }
+  };
 
   LOG(LEV_DEBUG2,"GRComp") << "The Component Class init(qe) function has been called.";;
 
   shared_from_this()->init(name, type, mat, ref_disp, ref_kd, ref_sol, inner_radius, outer_radius, 
       thermal_model(qe->queryElement("thermalmodel")), nuclide_model(qe->queryElement("nuclidemodel")));
+  nuclide_model()->set_step_size(step_size);
+  if( n_adaptive!=0 ) { nuclide_model()->set_adaptive(step_tol, max_step_size); };
+  nuclide_model()->set_sensitivities(sensitivities);
+  if( n_tol!=0 ) { set_contaminant_tol(rel_tol, abs_tol, abs_conc_tol); };
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -111,6 +153,9 @@ void Component::init(string name, ComponentType type, string mat, double
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Component::copy(const ComponentPtr& src){
   ID_=nextID_++;
+  if ( src.get() != this ) {
+    prototype_ = src->prototype();
+  }
 
   set_name(src->name());
   set_type(src->type());
@@ -143,6 +188,9 @@ void Component::copy(const ComponentPtr& src){
 
   temp_ = src->temp_;
   temp_lim_ = src->temp_lim_ ;
+  if( src->delta_encoded() ) {
+    set_contaminant_tol(src->rel_tol(), src->abs_tol(), src->abs_conc_tol());
+  }
 
   comp_hist_ = CompHistory();
   mass_hist_ = MassHistory();
@@ -167,14 +215,73 @@ void Component::updateContaminantTable(int the_time){
   // iterate over the vec_hist IsoVector
   std::map<int, double>::iterator entry;
 
-  for( entry=comp->begin(); entry!=comp->end(); ++entry ){
-    EM->newEvent("contaminants")
-      ->addVal( "CompID", ID())
-      ->addVal( "Time", the_time)
-      ->addVal( "IsoID", (*entry).first)
-      ->addVal( "MassKG", (*entry).second*mass)
-      ->addVal( "AvailConc", nuclide_model()->conc_hist(the_time, (*entry).first))
-      ->record();
+  if( !delta_encoded_ ) {
+    for( entry=comp->begin(); entry!=comp->end(); ++entry ){
+      EB->addContaminant(the_time, ID(), (*entry).first, (*entry).second*mass, 
+          nuclide_model()->conc_hist(the_time, (*entry).first));
+    }
+  } else {
+    std::map<Iso, recorded_contaminant_t> current;
+    for( entry=comp->begin(); entry!=comp->end(); ++entry ){
+      recorded_contaminant_t row = {(*entry).second*mass, 
+        nuclide_model()->conc_hist(the_time, (*entry).first)};
+      current[(*entry).first] = row;
+    }
+    // an isotope that has vanished is held at zero from here on
+    std::map<Iso, recorded_contaminant_t>::iterator last;
+    for( last=recorded_.begin(); last!=recorded_.end(); ++last ){
+      if( current.find((*last).first) == current.end() ) {
+        recorded_contaminant_t zero = {0, 0};
+        current[(*last).first] = zero;
+      }
+    }
+    std::map<Iso, recorded_contaminant_t>::const_iterator now;
+    for( now=current.begin(); now!=current.end(); ++now ){
+      last = recorded_.find((*now).first);
+      if( last == recorded_.end() || 
+          fabs((*now).second.kg - (*last).second.kg) > 
+            abs_tol_ + rel_tol_*fabs((*last).second.kg) ||
+          fabs((*now).second.conc - (*last).second.conc) > 
+            abs_conc_tol_ + rel_tol_*fabs((*last).second.conc) ) {
+        EB->addContaminant(the_time, ID(), (*now).first, (*now).second.kg, 
+            (*now).second.conc);
+        recorded_[(*now).first] = (*now).second;
+      }
+    }
+  }
+
+  // the instantaneous partials of the source term, if they were requested
+  if( nuclide_model()->sensitivities() ) {
+    vector<Iso> isos;
+    vector<double> dkg = nuclide_model()->source_term_sensitivities(isos);
+    for(size_t i = 0; i < isos.size(); ++i){
+      for(int p = 0; p < LAST_SENS_PARAM; ++p){
+        EB->addSensitivity(the_time, ID(), isos[i], 
+            NuclideModel::sens_param_name(SensParam(p)), 
+            dkg[i*LAST_SENS_PARAM + p]);
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Component::set_contaminant_tol(double rel_tol, double abs_tol, 
+    double abs_conc_tol){
+  MatTools::validate_finite_pos(rel_tol);
+  MatTools::validate_finite_pos(abs_tol);
+  MatTools::validate_finite_pos(abs_conc_tol);
+  delta_encoded_ = true;
+  rel_tol_ = rel_tol;
+  abs_tol_ = abs_tol;
+  abs_conc_tol_ = abs_conc_tol;
+  recorded_.clear();
+  // the tolerances tell the reader to hold each row until the next. they 
+  // are recorded once, with the parameters the prototype's copies share.
+  int params_id = nuclide_model() ? nuclide_model()->params_id() : -1;
+  if( params_id < 0 || params_id == ID() ) {
+    EB->addParam(ID(), rel_tol_param(), rel_tol_);
+    EB->addParam(ID(), abs_tol_param(), abs_tol_);
+    EB->addParam(ID(), abs_conc_tol_param(), abs_conc_tol_);
   }
 }
 
@@ -187,6 +294,11 @@ void Component::absorb(mat_rsrc_ptr mat_to_add){
   }
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Component::absorb_inert(double kg){
+  MatTools::validate_finite_pos(kg);
+  inert_kg_ += kg;
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Component::extract(CompMapPtr comp_to_rem, double kg_to_rem){
   try{
     nuclide_model()->extract(comp_to_rem, kg_to_rem);
@@ -206,15 +318,32 @@ void Component::transportHeat(int time){
 void Component::transportNuclides(int the_time){
   if ( !nuclide_model() ) {
     LOG(LEV_ERROR, "GRComp") << "Error, no nuclide_model_ loaded before Component::transportNuclides." ;
-  } else { 
+  } else if ( nuclide_model()->transport_due(the_time) || 
+      nuclide_model()->refine(daughter_release()) ) { 
+    // a slow model catches up on the whole interval since its last step
+    nuclide_model()->start_transport(the_time);
     nuclide_model()->update_inner_bc(the_time, nuclide_daughters());
     nuclide_model()->transportNuclides(the_time);
+    nuclide_model()->end_transport();
   }
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Component::daughter_release(){
+  double to_ret = 0;
+  if ( nuclide_model()->adaptive() ) {
+    vector<NuclideModelPtr> daughters = nuclide_daughters();
+    vector<NuclideModelPtr>::iterator daughter;
+    for( daughter = daughters.begin(); daughter != daughters.end(); ++daughter){
+      to_ret += (*daughter)->bc_snapshot().source_term.second;
+    }
+  }
+  return to_ret;
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentPtr Component::load(ComponentType type, ComponentPtr to_load) {
   to_load->set_parent(ComponentPtr(shared_from_this()));
   daughters_.push_back(to_load);
+  fill_ += to_load->geom()->length();
   return shared_from_this();
 }
 
@@ -222,14 +351,9 @@ ComponentPtr Component::load(ComponentType type, ComponentPtr to_load) {
 bool Component::isFull() {
   // @TODO imperative, add better logic here 
   bool to_ret;
-  double wp_len(0);
-  std::vector<ComponentPtr>::iterator it;
   switch(type()) {
     case BUFFER : 
-      for(it=daughters_.begin(); it!=daughters_.end(); ++it){
-        wp_len += (*it)->geom()->length();
-      }
-      to_ret = (wp_len >= geom()->length());
+      to_ret = (fill_ >= geom()->length());
       break;
     default : 
       to_ret=true;
@@ -242,12 +366,17 @@ bool Component::isFull() {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentType Component::type(){return type_;}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string Component::componentTypeName(ComponentType type) {
+  string component_type_names[] = {"BUFFER", "FF", "WF", "WP"};
+  return (type < LAST_EBS) ? component_type_names[type] : "LAST_EBS";
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentType Component::componentEnum(std::string type_name) {
   ComponentType toRet = LAST_EBS;
-  string component_type_names[] = {"BUFFER", "FF", "WF", "WP"};
   for(int type = 0; type < LAST_EBS; type++){
-    if(component_type_names[type] == type_name){
+    if(componentTypeName((ComponentType)type) == type_name){
       toRet = (ComponentType)type;
     } 
   }
@@ -257,7 +386,7 @@ ComponentType Component::componentEnum(std::string type_name) {
     err_msg += "' does not name a valid ComponentType.\n";
     err_msg += "Options are:\n";
     for(int name=0; name < LAST_EBS; name++){
-      err_msg += component_type_names[name];
+      err_msg += componentTypeName((ComponentType)name);
       err_msg += "\n";
     }
     throw CycException(err_msg);
@@ -303,6 +432,7 @@ void Component::addComponentToTable(ComponentPtr comp){
     ->addVal("name", comp->name())
     ->addVal("material_data", comp->mat_table()->mat())
     ->addVal("nuclidemodel", comp->nuclide_model()->name())
+    ->addVal("paramsID", comp->nuclide_model()->params_id())
     //->addVal("thermalmodel", comp->thermal_model()->name())
     //->addVal("innerradius", comp->inner_radius())
     //->addVal("outerradius", comp->outer_radius())
@@ -316,6 +446,11 @@ void Component::addComponentToTable(ComponentPtr comp){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const int Component::ID(){return ID_;}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+ComponentPtr Component::prototype(){
+  return prototype_ ? prototype_ : ComponentPtr(shared_from_this());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const std::string Component::name(){return name_;} 
 
@@ -39,6 +39,16 @@ typedef std::map<int, Concentration> ConcMap;
 /// type definition for Temperature in Kelvin 
 typedef double Temp;
 
+/**
+   The last recorded contaminants row of one isotope in a component, 
+   against which the change-threshold encoding is measured.
+ */
+typedef struct recorded_contaminant_t
+{
+  double kg; /**< the recorded mass of the isotope [kg] >**/
+  Concentration conc; /**< the recorded available concentration [kg/m^3] >**/
+} recorded_contaminant_t;
+
 /// type definition for Power in Watts
 typedef double Power;
 
@@ -111,9 +121,48 @@ public:
 
   /**
      Updates the gen_repo_contaminant_table_ for this component.
+
+     If a contaminant tolerance is set, the row of an isotope is recorded 
+     only when its mass has moved by more than abs_tol + rel_tol*|recorded 
+     mass|, or its concentration by more than abs_conc_tol + 
+     rel_tol*|recorded concentration|, from its last recorded row, and a 
+     vanished isotope is recorded once at zero. Holding each recorded value 
+     until the next then reproduces every step to within that bound, which 
+     is what ContaminantReader does.
     */
   void updateContaminantTable(int the_time);
 
+  /**
+     Turns on the change-threshold encoding of the contaminants table.
+     The tolerances are recorded in the NuclideModelParams table under the 
+     paramsID of the component, so a copy that shares the parameters of its 
+     prototype records none of its own.
+
+     @param rel_tol the relative change that is recorded [-]
+     @param abs_tol the absolute change in mass that is recorded [kg]
+     @param abs_conc_tol the absolute change in concentration that is 
+     recorded [kg/m^3]
+    */
+  void set_contaminant_tol(double rel_tol, double abs_tol, 
+      double abs_conc_tol);
+
+  /// returns true if the contaminants table is change-threshold encoded
+  bool delta_encoded(){return delta_encoded_;};
+
+  /// returns the relative change of the encoding [-]
+  double rel_tol(){return rel_tol_;};
+
+  /// returns the absolute change in mass of the encoding [kg]
+  double abs_tol(){return abs_tol_;};
+
+  /// returns the absolute change in concentration of the encoding [kg/m^3]
+  double abs_conc_tol(){return abs_conc_tol_;};
+
+  /// the NuclideModelParams names under which the tolerances are recorded
+  static std::string rel_tol_param(){return "contaminant_rel_tol";};
+  static std::string abs_tol_param(){return "contaminant_abs_tol";};
+  static std::string abs_conc_tol_param(){return "contaminant_abs_conc_tol";};
+
   /**
      Absorbs the contents of the given Material into this Component.
      
@@ -121,6 +170,18 @@ public:
    */
   void absorb(mat_rsrc_ptr mat_to_add);
 
+  /**
+     Holds mass in this Component apart from its nuclide model, such as 
+     the screened remainder of a waste stream. It is never transported or 
+     released.
+
+     @param kg the mass to hold [kg]
+   */
+  void absorb_inert(double kg);
+
+  /// returns the mass held apart from the nuclide model [kg]
+  double inert_kg(){return inert_kg_;};
+
   /**
      Extracts the contents of the given composition from this Component. Use this 
      function for decrementing a Component's mass balance after transferring 
@@ -147,6 +208,15 @@ public:
    */
   void transportNuclides(int time);
 
+  /**
+     Returns the mass that the daughters offer at their source term bcs, 
+     which lets an adaptive nuclide model step early when it jumps. 
+     Returns zero if the nuclide model is not adaptive.
+
+     @return the mass offered by the daughters [kg]
+   */
+  double daughter_release();
+
   /** 
      Loads this component with another component.
      
@@ -162,6 +232,15 @@ public:
    */
   bool isFull() ;
 
+  /**
+     Reports the summed length of the daughters loaded into this component. 
+     It is kept as daughters are loaded, so that isFull() need not revisit 
+     them.
+     
+     @return fill_ the length of this component that is filled [m]
+   */
+  const Length fill(){return fill_;};
+
   /**
      Returns the ComponentType of this component (WF, WP, etc.)
      
@@ -169,6 +248,14 @@ public:
    */
   ComponentType type();
 
+  /**
+     Names a ComponentType, the inverse of componentEnum
+     
+     @param type the ComponentType
+     @return the name of the ComponentType (i.e. FF)
+   */
+  static std::string componentTypeName(ComponentType type);
+
   /**
      set the ComponentType
    */
@@ -217,6 +304,16 @@ public:
      */
   const std::vector<NuclideModelPtr> nuclide_daughters();
 
+  /**
+     Returns the template this component was copied from, directly or 
+     through other copies. Templates are not modified once copied, so a 
+     copy shares the template's static parameters, including its recorded 
+     nuclide model parameters. A template is its own prototype.
+     
+     @return prototype_ the template of this component
+   */
+  ComponentPtr prototype();
+
   /**
      Adds a component to the components table.
    */
@@ -433,11 +530,26 @@ protected:
    */
   ComponentPtr parent_;
 
+  /**
+     The template this component was copied from, null for a template.
+   */
+  ComponentPtr prototype_;
+
   /**
      The immediate daughter components of this component.
    */
   std::vector<ComponentPtr> daughters_;
 
+  /**
+     The summed length of the daughter components [m]
+   */
+  Length fill_;
+
+  /**
+     The mass held apart from the nuclide model, never transported [kg]
+   */
+  double inert_kg_;
+
   /**
      The name of this component, a string
    */
@@ -463,6 +575,24 @@ protected:
    */
   Temp temp_lim_;
 
+  /**
+     True if the contaminants table records only changes beyond the 
+     tolerances
+   */
+  bool delta_encoded_;
+
+  /// the relative change that is recorded [-]
+  double rel_tol_;
+
+  /// the absolute change in mass that is recorded [kg]
+  double abs_tol_;
+
+  /// the absolute change in concentration that is recorded [kg/m^3]
+  double abs_conc_tol_;
+
+  /// the last recorded row of each isotope, when delta_encoded_
+  std::map<Iso, recorded_contaminant_t> recorded_;
+
   /**
      The peak temp achieved at the outer boundary 
    */
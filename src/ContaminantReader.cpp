@@ -0,0 +1,138 @@
+/*! \file ContaminantReader.cpp
+    \brief Implements the ContaminantReader class, which rebuilds the full
+    contaminant histories of a run database
+    \author Kathryn D. Huff
+ */
+#include <boost/bind.hpp>
+
+#include "ContaminantReader.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ContaminantReader::ContaminantReader(string file) :
+  reader_(file),
+  read_tolerances_(false),
+  last_time_(-1)
+{
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ContaminantReader::readTolerances(){
+  if( read_tolerances_ ) {
+    return;
+  }
+  // matches Component::rel_tol_param()
+  sqlite3_stmt* stmt = reader_.prepare("SELECT CompID FROM "
+      "NuclideModelParams WHERE ParamName = 'contaminant_rel_tol'");
+  set<int> params;
+  while( reader_.step(stmt) ) {
+    params.insert(sqlite3_column_int(stmt, 0));
+  }
+  encoded_ = params;
+  // a copy shares the parameters, and so the tolerances, of its prototype
+  stmt = reader_.prepare("SELECT compID, paramsID FROM components");
+  while( reader_.step(stmt) ) {
+    if( params.count(sqlite3_column_int(stmt, 1)) > 0 ) {
+      encoded_.insert(sqlite3_column_int(stmt, 0));
+    }
+  }
+  // no held row outlives the run
+  stmt = reader_.prepare("SELECT MAX(Time) FROM contaminants");
+  if( reader_.step(stmt) && sqlite3_column_type(stmt, 0) != SQLITE_NULL ) {
+    last_time_ = sqlite3_column_int(stmt, 0);
+  }
+  read_tolerances_ = true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ContaminantReader::encoded(int comp_id){
+  readTolerances();
+  return encoded_.find(comp_id) != encoded_.end();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int ContaminantReader::last_time(){
+  readTolerances();
+  return last_time_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+contaminant_series_t ContaminantReader::series(int comp_id, int iso, int t0,
+    int tf){
+  bool hold = encoded(comp_id);
+  // a held history needs the last row before t0
+  sqlite3_stmt* stmt = reader_.prepare("SELECT Time, MassKG, AvailConc "
+      "FROM contaminants WHERE CompID = ? AND IsoID = ? AND Time < ? "
+      "ORDER BY Time");
+  sqlite3_bind_int(stmt, 1, comp_id);
+  sqlite3_bind_int(stmt, 2, iso);
+  sqlite3_bind_int(stmt, 3, tf);
+  vector<contaminant_point_t> points;
+  while( reader_.step(stmt) ) {
+    contaminant_point_t point = {sqlite3_column_int(stmt, 0),
+      sqlite3_column_double(stmt, 1), sqlite3_column_double(stmt, 2)};
+    points.push_back(point);
+  }
+  return rebuild(points, hold, t0, tf, last_time());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ContaminantReader::each(int t0, int tf, history_visitor_t visit){
+  readTolerances();
+  sqlite3_stmt* stmt = reader_.prepare("SELECT CompID, IsoID, Time, MassKG, "
+      "AvailConc FROM contaminants WHERE Time < ? "
+      "ORDER BY CompID, IsoID, Time");
+  sqlite3_bind_int(stmt, 1, tf);
+  comp_iso_t key(0, 0);
+  vector<contaminant_point_t> points;
+  bool more = reader_.step(stmt);
+  while( more ) {
+    key = make_pair(sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1));
+    points.clear();
+    // gather the rows of this history, then rebuild and hand it on
+    while( more && sqlite3_column_int(stmt, 0) == key.first &&
+        sqlite3_column_int(stmt, 1) == key.second ) {
+      contaminant_point_t point = {sqlite3_column_int(stmt, 2),
+        sqlite3_column_double(stmt, 3), sqlite3_column_double(stmt, 4)};
+      points.push_back(point);
+      more = reader_.step(stmt);
+    }
+    visit(key, rebuild(points, encoded_.count(key.first) > 0, t0, tf,
+          last_time_));
+  }
+}
+
+/// adds a history to the map of histories
+static void collect(map<comp_iso_t, contaminant_series_t>* histories,
+    const comp_iso_t& key, const contaminant_series_t& history){
+  (*histories)[key] = history;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+map<comp_iso_t, contaminant_series_t> ContaminantReader::all(int t0, int tf){
+  map<comp_iso_t, contaminant_series_t> to_ret;
+  each(t0, tf, boost::bind(&collect, &to_ret, _1, _2));
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+contaminant_series_t ContaminantReader::rebuild(
+    const vector<contaminant_point_t>& points, bool hold, int t0, int tf,
+    int last){
+  contaminant_series_t to_ret;
+  to_ret.kg.assign(tf - t0, 0);
+  to_ret.conc.assign(tf - t0, 0);
+  for(size_t p = 0; p < points.size(); ++p){
+    int begin = points[p].time;
+    int end = begin + 1;
+    if( hold ) {
+      end = (p + 1 < points.size()) ? points[p + 1].time : last + 1;
+    }
+    for(int t = max(begin, t0); t < end && t < tf; ++t){
+      to_ret.kg[t - t0] = points[p].kg;
+      to_ret.conc[t - t0] = points[p].conc;
+    }
+  }
+  return to_ret;
+}
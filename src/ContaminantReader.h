@@ -0,0 +1,146 @@
+/*! \file ContaminantReader.h
+  \brief Declares the ContaminantReader class, which rebuilds the full
+  contaminant histories of a run database
+  \author Kathryn D. Huff
+ */
+#if !defined(_CONTAMINANTREADER_H)
+#define _CONTAMINANTREADER_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/function.hpp>
+
+#include "SqliteReader.h"
+
+/**
+   The history of one isotope in one component, one entry per timestep.
+ */
+typedef struct contaminant_series_t
+{
+  std::vector<double> kg; /**< the mass of the isotope [kg] >**/
+  std::vector<double> conc; /**< the available concentration [kg/m^3] >**/
+} contaminant_series_t;
+
+/**
+   A recorded row of the contaminants table, less its component and
+   isotope.
+ */
+typedef struct contaminant_point_t
+{
+  int time; /**< the timestep of the row >**/
+  double kg; /**< the mass of the isotope [kg] >**/
+  double conc; /**< the available concentration [kg/m^3] >**/
+} contaminant_point_t;
+
+/// the key of a history, a component id and an isotope
+typedef std::pair<int, int> comp_iso_t;
+
+/// a function called with each history as it is rebuilt
+typedef boost::function<void (const comp_iso_t&, 
+    const contaminant_series_t&)> history_visitor_t;
+
+/**
+   @class ContaminantReader
+   The ContaminantReader rebuilds the contaminant histories of a run
+   database at every timestep, whichever way each component recorded them.
+
+   A component with a contaminant_tolerance records an isotope only when
+   it has changed beyond the tolerance, and its tolerances are in the
+   NuclideModelParams table under its paramsID in the components table,
+   which the copies of a prototype share. Each of its rows is held until
+   the next, and its last through the last timestep recorded in the run,
+   which reproduces every timestep to within the tolerances.
+   Every other component records every isotope it holds at every
+   timestep, so a timestep without a row is zero.
+ */
+class ContaminantReader {
+public:
+  /**
+     The constructor for the ContaminantReader.
+
+     @param file the path to the run database
+   */
+  ContaminantReader(std::string file);
+
+  /**
+     Returns true if the component's rows are change-threshold encoded.
+
+     @param comp_id the id of the component
+   */
+  bool encoded(int comp_id);
+
+  /**
+     Rebuilds the history of one isotope in one component.
+
+     @param comp_id the id of the component
+     @param iso the isotope
+     @param t0 the first timestep, inclusive
+     @param tf the last timestep, exclusive
+     @return the history over [t0, tf)
+   */
+  contaminant_series_t series(int comp_id, int iso, int t0, int tf);
+
+  /**
+     Rebuilds the history of every isotope in every component, in a single
+     ordered pass over the contaminants table, and hands each to visit as 
+     soon as it is rebuilt. Only one history is held at a time.
+
+     @param t0 the first timestep, inclusive
+     @param tf the last timestep, exclusive
+     @param visit called with the key and history of each component and 
+     isotope over [t0, tf), in order of component id and isotope
+   */
+  void each(int t0, int tf, history_visitor_t visit);
+
+  /**
+     Rebuilds the history of every isotope in every component, as each() 
+     does, and gathers them all. Prefer each() for large runs.
+
+     @param t0 the first timestep, inclusive
+     @param tf the last timestep, exclusive
+     @return the history of each component and isotope over [t0, tf)
+   */
+  std::map<comp_iso_t, contaminant_series_t> all(int t0, int tf);
+
+  /**
+     Rebuilds a history from its recorded rows.
+
+     @param points the rows, in order of time, none later than tf
+     @param hold true to hold each row until the next, false for zero
+     @param t0 the first timestep, inclusive
+     @param tf the last timestep, exclusive
+     @param last the last timestep recorded in the run, through which the
+     last row is held
+     @return the history over [t0, tf)
+   */
+  static contaminant_series_t rebuild(
+      const std::vector<contaminant_point_t>& points, bool hold, int t0,
+      int tf, int last);
+
+  /// returns the last timestep recorded in the contaminants table
+  int last_time();
+
+protected:
+  /**
+     Reads the components whose parameters include tolerances, and the last
+     recorded timestep, once.
+   */
+  void readTolerances();
+
+  /// the connection to the run database
+  SqliteReader reader_;
+
+  /// true once encoded_ has been read
+  bool read_tolerances_;
+
+  /// the components whose rows are change-threshold encoded
+  std::set<int> encoded_;
+
+  /// the last timestep recorded in the contaminants table
+  int last_time_;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <string>
 #include <deque>
 #include <vector>
+#include <boost/thread/thread.hpp>
 
 #include "GenericResource.h"
 #include "CycException.h"
@@ -14,6 +15,10 @@
 #include "Cyder.h"
 #include "EventManager.h"
 #include "StubThermal.h"
+#include "STCThermal.h"
+#include "MatTools.h"
+#include "MaterialDB.h"
+#include "STCDB.h"
 
 
 
@@ -76,8 +81,11 @@ Cyder::Cyder() :
   commod_wf_map_(std::map< std::string, ComponentPtr >()),
   wf_wp_map_(std::map< std::string, ComponentPtr >()),
   far_field_(ComponentPtr(new Component(this))),
+  totals_(RepoTotals::create()),
   buffer_template_(ComponentPtr(new Component(this))),
-  thermal_model_(StubThermal::create())
+  thermal_model_(StubThermal::create()),
+  thermal_cutoff_(0),
+  request_policy_(PROPORTIONAL)
 {
 
   mapVars("x", &x_);
@@ -97,6 +105,10 @@ Cyder::Cyder() :
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cyder::initModuleMembers(QueryEngine* qe) { 
+  // the databases are populated as the components are read
+  MDB->thaw();
+  SDB->thaw();
+
   // initialize ordinary objects
   std::map<const char*, boost::any>::iterator item;
   for (item = member_refs_.begin(); item != member_refs_.end(); ++item) {
@@ -122,11 +134,91 @@ void Cyder::initModuleMembers(QueryEngine* qe) {
     in_commods_.push_back(qe->getElementContent("incommodity",i));
   }
 
+  // the capacity is split among the incommodities by the request policy
+  if (qe->nElementsMatchingQuery("request_policy") > 0) {
+    std::string policy_name = qe->getElementContent("request_policy");
+    request_policy_ = requestPolicyEnum(policy_name);
+    if (request_policy_ == LAST_REQUEST_POLICY) {
+      std::string err = "The request policy '";
+      err += policy_name;
+      err += "' is not supported by Cyder.";
+      LOG(LEV_ERROR,"GenRepoFac")<<err;;
+      throw CycException(err);
+    }
+  }
+
   // get thermal_model_ for capacity estimation
   QueryEngine* thermal_model_input;
   thermal_model_input = qe->queryElement("thermalmodel");
   thermal_model_ = ThermalModelFactory::thermalModel(thermal_model_input); /// @TODO has no geom
-  thermal_model_->initModuleMembers(thermal_model_input);
+
+  // the heat of neighboring packages is superposed by the thermal field
+  if (qe->nElementsMatchingQuery("thermal_cutoff") > 0) {
+    thermal_cutoff_ = lexical_cast<double>(qe->getElementContent("thermal_cutoff"));
+  } else {
+    thermal_cutoff_ = 5*std::max(dx_, dy_);
+  }
+  if (thermal_model_->type() == STC_THERMAL) {
+    thermal_field_ = ThermalField::create(
+        boost::dynamic_pointer_cast<STCThermal>(thermal_model_), thermal_cutoff_);
+  }
+
+  // the far field may be resolved on a grid over the whole repository
+  if (qe->nElementsMatchingQuery("far_field_grid") > 0) {
+    QueryEngine* grid_input = qe->queryElement("far_field_grid");
+    int nx = lexical_cast<int>(grid_input->getElementContent("nx"));
+    int ny = lexical_cast<int>(grid_input->getElementContent("ny"));
+    int nz = lexical_cast<int>(grid_input->getElementContent("nz"));
+    double disp = lexical_cast<double>(grid_input->getElementContent("dispersion"));
+    int n_blocks = std::max(1, int(boost::thread::hardware_concurrency()));
+    if (grid_input->nElementsMatchingQuery("n_blocks") > 0) {
+      n_blocks = lexical_cast<int>(grid_input->getElementContent("n_blocks"));
+    }
+    far_field_grid_ = FarFieldGrid::create(x_, y_, z_, nx, ny, nz, adv_vel_, 
+        disp, n_blocks);
+    if (grid_input->nElementsMatchingQuery("record_tol") > 0) {
+      far_field_grid_->set_record_tol(lexical_cast<double>(
+            grid_input->getElementContent("record_tol")));
+    }
+  }
+
+  // the emplaced waste may be screened down to its significant isotopes
+  if (qe->nElementsMatchingQuery("nuclide_screening") > 0) {
+    QueryEngine* screen_input = qe->queryElement("nuclide_screening");
+    std::string criterion_name = screen_input->getElementContent("criterion");
+    ScreenCriterion criterion = NuclideScreen::criterionEnum(criterion_name);
+    if (criterion == LAST_SCREEN_CRITERION) {
+      std::string err = "The screening criterion '";
+      err += criterion_name;
+      err += "' is not supported by Cyder.";
+      LOG(LEV_ERROR,"GenRepoFac")<<err;;
+      throw CycException(err);
+    }
+    double keep_fraction = lexical_cast<double>(
+        screen_input->getElementContent("keep_fraction"));
+    double min_half_life = 0;
+    if (screen_input->nElementsMatchingQuery("min_half_life") > 0) {
+      min_half_life = lexical_cast<double>(
+          screen_input->getElementContent("min_half_life"));
+    }
+    Iso remainder = lexical_cast<Iso>(
+        screen_input->getElementContent("remainder"));
+    nuclide_screen_ = NuclideScreen::create(criterion, keep_fraction, 
+        min_half_life, remainder);
+    int n_nuclides = screen_input->nElementsMatchingQuery("nuclide");
+    for (int i = 0; i < n_nuclides; i++) {
+      QueryEngine* nuclide_input = screen_input->queryElement("nuclide", i);
+      double dose_coef = 0;
+      if (nuclide_input->nElementsMatchingQuery("dose_coef") > 0) {
+        dose_coef = lexical_cast<double>(
+            nuclide_input->getElementContent("dose_coef"));
+      }
+      nuclide_screen_->set_nuclide(
+          lexical_cast<Iso>(nuclide_input->getElementContent("iso")), 
+          lexical_cast<double>(nuclide_input->getElementContent("half_life")), 
+          dose_coef);
+    }
+  }
 
   // get components
   int n_components = qe->nElementsMatchingQuery("component");
@@ -135,6 +227,11 @@ void Cyder::initModuleMembers(QueryEngine* qe) {
     component_input = qe->queryElement("component",i);
     initComponent(component_input);
   }
+
+  // copies share the tables of their templates, so none are read after this,
+  // and the frozen databases may be read by many threads at once
+  MDB->freeze();
+  SDB->freeze();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -209,8 +306,34 @@ void Cyder::cloneModuleMembersFrom(FacilityModel* source)
   start_op_yr_ = src->start_op_yr_;
   start_op_mo_ = src->start_op_mo_;
   in_commods_ = src->in_commods_;
-  thermal_model_->copy(*(src->thermal_model_));
+  thermal_model_ = ThermalModelFactory::thermalModel(src->thermal_model_, 
+      MatDataTablePtr(), GeometryPtr(new Geometry()));
+  thermal_cutoff_ = src->thermal_cutoff_;
+  request_policy_ = src->request_policy_;
+  if (thermal_model_->type() == STC_THERMAL) {
+    thermal_field_ = ThermalField::create(
+        boost::dynamic_pointer_cast<STCThermal>(thermal_model_), thermal_cutoff_);
+  }
   far_field_->copy(src->far_field_);
+  if (src->far_field_grid_) {
+    far_field_grid_ = FarFieldGrid::create(x_, y_, z_, 
+        src->far_field_grid_->nx(), src->far_field_grid_->ny(), 
+        src->far_field_grid_->nz(), adv_vel_, 
+        src->far_field_grid_->dispersion(), src->far_field_grid_->n_blocks());
+    far_field_grid_->set_record_tol(src->far_field_grid_->record_tol());
+  }
+  if (src->nuclide_screen_) {
+    nuclide_screen_ = NuclideScreen::create(src->nuclide_screen_->criterion(), 
+        src->nuclide_screen_->keep_fraction(), 
+        src->nuclide_screen_->min_half_life(), 
+        src->nuclide_screen_->remainder());
+    std::map<Iso, nuclide_data_t>::const_iterator nuclide;
+    for (nuclide = src->nuclide_screen_->nuclides().begin(); 
+        nuclide != src->nuclide_screen_->nuclides().end(); ++nuclide) {
+      nuclide_screen_->set_nuclide((*nuclide).first, 
+          (*nuclide).second.half_life, (*nuclide).second.dose_coef);
+    }
+  }
   buffer_template_ = src->buffer_template_;
   wp_templates_ = src->wp_templates_;
   wf_templates_ = src->wf_templates_;
@@ -221,6 +344,12 @@ void Cyder::cloneModuleMembersFrom(FacilityModel* source)
   // initialize empty structures instead
   stocks_ = std::deque< WasteStream >();
   inventory_ = std::deque< WasteStream >();
+  stocks_total_.clear();
+  stocks_totals_.clear();
+  inventory_total_.clear();
+  inventory_totals_.clear();
+  last_received_.clear();
+  open_wps_.clear();
   is_full_ = false;
 
   addRowToParamsTable();
@@ -284,6 +413,10 @@ void Cyder::addResource(Transaction trans, std::vector<rsrc_ptr> manifest) {
         << (*this_rsrc)->quantity();
     if ((*this_rsrc)->type()==MATERIAL_RES){
       stocks_.push_front(std::make_pair(boost::dynamic_pointer_cast<Material>(*this_rsrc), trans.commod()));
+      stocks_total_.add((*this_rsrc)->quantity());
+      stocks_totals_[trans.commod()].add((*this_rsrc)->quantity());
+      last_received_[trans.commod()] = 
+        boost::dynamic_pointer_cast<Material>(*this_rsrc);
     } else {
       std::string err = "The Cyder only accepts Material-type Resources.";
       LOG(LEV_ERROR, "GenRepoFac")<< err ;
@@ -322,103 +455,245 @@ void Cyder::handleTock(int time) {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cyder::makeRequests(int time){
-
-  // should this model make requests for all of the commodities it accepts?
   // there should be a section of the repository for each accepted commodity
- 
-  // right now it picks one commodity per month and asks for that.
-  // It chooses the next incommodity in the preference lineup
-  std::string in_commod;
-  if(!in_commods_.empty()) {
-    in_commod = in_commods_.front();
-
-    // It then moves that commodity from the front to the back of the preference 
-    // lineup
-    in_commods_.push_back(in_commod);
-    in_commods_.pop_front();
-  
-    // It will need to figure out its capacity
-    double requestAmt;
-    // Perform the task of figuring out the capacity for this commod
-    requestAmt = getCapacity(in_commod);
-    
-    // make requests
+  // each month, every incommodity gets its share of the capacity 
+  std::map<std::string, double> plan = planRequests();
+
+  // It can accept amounts however small
+  double minAmt = 0;
+  // this will be a request for free stuff
+  double commod_price = 0;
+
+  // build the whole batch of requests before sending any of them
+  std::vector<msg_ptr> requests;
+  std::map<std::string, double>::iterator it;
+  for (it = plan.begin(); it != plan.end(); ++it) {
+    std::string in_commod = (*it).first;
+    double requestAmt = (*it).second;
     if (requestAmt == 0){
       // don't request anything
-    } else {
-      // It can accept amounts however small
-      double minAmt = 0;
-      // this will be a request for free stuff
-      double commod_price = 0;
-      MarketModel* market = MarketModel::marketForCommod(in_commod);
-      Communicator* recipient = dynamic_cast<Communicator*>(market);
-  
-      // create a generic resource
-      gen_rsrc_ptr request_res = gen_rsrc_ptr(new GenericResource("kg",in_commod,requestAmt));
-  
-      // build the transaction and message
-      Transaction trans(this, REQUEST);
-      trans.setCommod(in_commod);
-      trans.setMinFrac(minAmt/requestAmt);
-      trans.setPrice(commod_price);
-      trans.setResource(request_res); 
-  
-      msg_ptr request = msg_ptr(new Message(this, recipient, trans)); 
-      request->sendOn();
-      LOG(LEV_INFO3, "GenRepoFac") << " requests " << requestAmt << " kg of " << in_commod << ".";
+      continue;
+    }
+    MarketModel* market = MarketModel::marketForCommod(in_commod);
+    Communicator* recipient = dynamic_cast<Communicator*>(market);
+
+    // create a generic resource
+    gen_rsrc_ptr request_res = gen_rsrc_ptr(new GenericResource("kg",in_commod,requestAmt));
+
+    // build the transaction and message
+    Transaction trans(this, REQUEST);
+    trans.setCommod(in_commod);
+    trans.setMinFrac(minAmt/requestAmt);
+    trans.setPrice(commod_price);
+    trans.setResource(request_res); 
+
+    requests.push_back(msg_ptr(new Message(this, recipient, trans)));
+    LOG(LEV_INFO3, "GenRepoFac") << " requests " << requestAmt << " kg of " << in_commod << ".";
+  }
+
+  // and send them together
+  for (int i = 0; i < requests.size(); ++i) {
+    requests[i]->sendOn();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::map<std::string, double> Cyder::planRequests(){
+  std::map<std::string, double> to_ret;
+  int n = in_commods_.size();
+  if (n == 0) {
+    return to_ret;
+  }
+
+  // the capacity to split among the commodities, and the most each may have
+  double budget = getCapacity();
+  std::vector<double> weights = requestWeights();
+  std::vector<double> caps(n, 0);
+  for (int i = 0; i < n; ++i) {
+    caps[i] = requestCap(in_commods_[i]);
+    to_ret[in_commods_[i]] = 0;
+  }
+
+  // fill the shares by weight. A commodity whose share exceeds its cap gets 
+  // its cap, and what it leaves unused is split again among the others.
+  std::vector<bool> capped(n, false);
+  bool filled = false;
+  while (!filled && budget > 0) {
+    double total_weight = 0;
+    for (int i = 0; i < n; ++i) {
+      if (!capped[i]) {
+        total_weight += weights[i];
+      }
+    }
+    if (total_weight <= 0) {
+      break;
+    }
+    filled = true;
+    for (int i = 0; i < n; ++i) {
+      if (!capped[i] && budget*weights[i]/total_weight >= caps[i]) {
+        capped[i] = true;
+        to_ret[in_commods_[i]] = caps[i];
+        budget -= caps[i];
+        filled = false;
+      }
+    }
+    if (filled) {
+      for (int i = 0; i < n; ++i) {
+        if (!capped[i]) {
+          to_ret[in_commods_[i]] = budget*weights[i]/total_weight;
+        }
+      }
     }
   }
+  return to_ret;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> Cyder::requestWeights(){
+  int n = in_commods_.size();
+  std::vector<double> weights(n, 1);
+  switch (request_policy_) {
+    case PRIORITY :
+      for (int i = 0; i < n; ++i) {
+        weights[i] = n - i;
+      }
+      break;
+    case PROPORTIONAL :
+      {
+        // each commodity's share follows how much of it has been received. 
+        // The mean is added to every weight so that a commodity not yet 
+        // received is still requested.
+        double total = 0;
+        for (int i = 0; i < n; ++i) {
+          weights[i] = checkInventory(in_commods_[i]) + 
+            checkStocks(in_commods_[i]);
+          total += weights[i];
+        }
+        for (int i = 0; i < n; ++i) {
+          weights[i] = (total > 0) ? weights[i] + total/n : 1;
+        }
+      }
+      break;
+    default :
+      break;
+  }
+  return weights;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Cyder::requestCap(std::string commod){
+  double to_ret = getCapacity(commod);
+  if (request_policy_ != THERMAL || !thermal_field_ || t_lim_ <= 0) {
+    return to_ret;
+  }
+  // judge the heat of the commodity by the last material received of it. 
+  // Until one arrives, only the capacity bounds it.
+  std::map<std::string, mat_rsrc_ptr>::iterator found = 
+    last_received_.find(commod);
+  if (found == last_received_.end() || (*found).second->quantity() <= 0) {
+    return to_ret;
+  }
+  mat_rsrc_ptr mat = (*found).second;
+  point_t loc = nextPlacement();
+  int the_time = TI->time();
+  Temp ambient = thermal_field_->projected_peak(loc, the_time);
+  Temp rise = thermal_field_->projected_peak(loc, the_time, mat) - ambient;
+  if (rise > 0) {
+    // the mass of it that the headroom at the next placement could hold
+    double fits = std::max(0.0, t_lim_ - ambient)*mat->quantity()/rise;
+    to_ret = std::min(to_ret, fits);
+  }
+  return to_ret;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RequestPolicy Cyder::requestPolicyEnum(std::string policy_name){
+  RequestPolicy toRet = LAST_REQUEST_POLICY;
+  std::string policy_names[] = {"PROPORTIONAL", "PRIORITY", "THERMAL"};
+  for (int policy = 0; policy < LAST_REQUEST_POLICY; policy++){
+    if (policy_names[policy] == policy_name){
+      toRet = (RequestPolicy)policy;
+    }
+  }
+  return toRet;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double Cyder::getCapacity(std::string commod){
   double toRet=0;
+  // while the next placement is projected to reach the thermal limit, the 
+  // repository accepts nothing
+  if (thermalLimitReached()) {
+    return toRet;
+  }
   // if the overall repo has a legislative limit, report it
-  // eventually, this will report the commodity dependent capacity
   // The Cyder should ask for material unless it's full
   double inv = this->checkInventory();
   // including how much is already in its stocks
   double sto = this->checkStocks(); 
   // subtract inv and sto from inventory max size to get total empty space
   double space = inventory_size_- inv - sto;
-  // if empty space is less than monthly acceptance capacity
-  if (space <= capacity_){
-    toRet = space;
-    // otherwise
-  } else if (space >= capacity_){
-    // the upper bound is the monthly acceptance capacity
-    toRet = capacity_;
-  } 
+  // the monthly acceptance capacity, less what of this commodity is 
+  // already waiting to be emplaced
+  double accept = capacity_ - this->checkStocks(commod);
+  // the lesser of the two bounds the request
+  toRet = std::max(0.0, std::min(space, accept));
   return toRet;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Cyder::checkInventory(){
-  double total = 0;
+double Cyder::getCapacity(){
+  double toRet=0;
+  // while the next placement is projected to reach the thermal limit, the 
+  // repository accepts nothing
+  if (thermalLimitReached()) {
+    return toRet;
+  }
+  // the empty space left in the inventory
+  double space = inventory_size_ - this->checkInventory() - this->checkStocks();
+  // the monthly acceptance capacity, less everything already waiting to be 
+  // emplaced
+  double accept = capacity_ - this->checkStocks();
+  toRet = std::max(0.0, std::min(space, accept));
+  return toRet;
+}
 
-  // Iterate through the inventory and sum the amount of whatever
-  // material unit is in each object.
-  for (std::deque< WasteStream >::iterator iter = inventory_.begin(); iter != 
-      inventory_.end(); ++iter){
-    total += iter->first->quantity();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cyder::thermalLimitReached(){
+  if (!thermal_field_ || t_lim_ <= 0) {
+    return false;
+  }
+  Temp projected = thermal_field_->projected_peak(nextPlacement(), TI->time());
+  if (projected >= t_lim_) {
+    LOG(LEV_INFO3, "GenRepoFac") << "The projected peak temperature change " 
+      << projected << " at the next placement has reached the limit " << t_lim_;
+    return true;
   }
+  return false;
+}
 
-  return total;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Cyder::checkInventory(){
+  return inventory_total_.sum;
 }
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Cyder::checkStocks(){
-  double total = 0;
+double Cyder::checkInventory(std::string commod){
+  std::map<std::string, kahan_sum_t>::iterator found = 
+    inventory_totals_.find(commod);
+  return (found == inventory_totals_.end()) ? 0 : (*found).second.sum;
+}
 
-  // Iterate through the stocks and sum the amount of whatever
-  // material unit is in each object.
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Cyder::checkStocks(){
+  return stocks_total_.sum;
+}
 
-  if (!stocks_.empty()){
-    for (std::deque< WasteStream >::iterator iter = stocks_.begin(); iter != 
-        stocks_.end(); ++iter) {
-        total += iter->first->quantity();
-    };
-  };
-  return total;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Cyder::checkStocks(std::string commod){
+  std::map<std::string, kahan_sum_t>::iterator found = 
+    stocks_totals_.find(commod);
+  return (found == stocks_totals_.end()) ? 0 : (*found).second.sum;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -452,8 +727,8 @@ void Cyder::emplaceWaste(){
       // try to load each package in the current buffer 
       // if the package is full
       if ( iter->isFull()
-          // and not too hot
-          //&& (*iter)->peak_temp(OUTER) <= current_buffer->temp_lim() or 
+          // and not too hot, given the heat of the packages already emplaced
+          && packageAcceptable(iter)
           //too toxic
           //&& (*iter)->peak_tox() <= current_buffer->tox_lim()
           ) {
@@ -468,10 +743,21 @@ void Cyder::emplaceWaste(){
         current_waste_packages_.push_back(iter);
         current_waste_packages_.pop_front();
       }
-      inventory_.push_back(stocks_.front());
+      WasteStream emplaced = stocks_.front();
+      double kg = emplaced.first->quantity();
+      inventory_.push_back(emplaced);
+      inventory_total_.add(kg);
+      inventory_totals_[emplaced.second].add(kg);
       stocks_.pop_front();
+      stocks_total_.add(-kg);
+      stocks_totals_[emplaced.second].add(-kg);
       // once the waste is emplaced, is there anything else to do?
     }
+    // empty stocks hold exactly nothing
+    if (stocks_.empty()) {
+      stocks_total_.clear();
+      stocks_totals_.clear();
+    }
   }
 }
 
@@ -494,48 +780,57 @@ ComponentPtr Cyder::conditionWaste(WasteStream waste_stream){
   // create that waste form
   current_waste_forms_.push_back(ComponentPtr(new Component(this)));
   current_waste_forms_.back()->copy(chosen_wf_template);
-  // and load in the waste stream
-  current_waste_forms_.back()->absorb(waste_stream.first);
+  // and load in the waste stream, screened down to its significant isotopes
+  mat_rsrc_ptr waste = waste_stream.first;
+  if (nuclide_screen_) {
+    // the screened remainder stays in the waste form, out of transport
+    std::pair<mat_rsrc_ptr, double> screened = nuclide_screen_->screen(waste);
+    waste = screened.first;
+    current_waste_forms_.back()->absorb_inert(screened.second);
+  }
+  if (waste) {
+    current_waste_forms_.back()->absorb(waste);
+  }
   return current_waste_forms_.back();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentPtr Cyder::packageWaste(ComponentPtr waste_form){
   // figure out what waste package to put the waste form in
-  bool loaded = false;
   ComponentPtr chosen_wp_template;
-  std::string name = waste_form->name();
-  chosen_wp_template = wf_wp_map_[name];
+  std::map<std::string, ComponentPtr>::iterator found_wp;
+  found_wp = wf_wp_map_.find(waste_form->name());
+  if (found_wp != wf_wp_map_.end()){
+    chosen_wp_template = (*found_wp).second;
+  }
   if (chosen_wp_template == NULL){
     std::string err_msg = "The waste form '";
     err_msg += (waste_form)->name();
     err_msg +="' does not have a matching WP in Cyder.";
     throw CycException(err_msg);
   }
-  ComponentPtr toRet;
-  // until the waste form has been loaded into a package
-  while (!loaded){
-    // look through the current waste packages 
-    for (std::deque<ComponentPtr>::const_iterator iter= 
-        current_waste_packages_.begin();
-        iter != current_waste_packages_.end();
-        ++iter){
-      // if there already exists an only partially full one of the right kind
-      if ( !(*iter)->isFull() && (*iter)->name() == 
-          chosen_wp_template->name()){
-        // fill it
-        (*iter)->load(WP, waste_form);
-        toRet = (*iter);
-        loaded = true;
-      } }
-    // if no currently unfilled waste packages match, create a new waste package
-    current_waste_packages_.push_back(ComponentPtr( new Component(this) ));
-    current_waste_packages_.back()->copy(chosen_wp_template);
-    // and load in the waste form
-    toRet = current_waste_packages_.back()->load(WP, waste_form); 
-    loaded = true;
+  // if there already exists an only partially full one of the right kind, 
+  // it is the open package indexed by the template's ID
+  ComponentPtr chosen_wp;
+  std::map<int, ComponentPtr>::iterator found_open;
+  found_open = open_wps_.find(chosen_wp_template->ID());
+  if (found_open != open_wps_.end()){
+    chosen_wp = (*found_open).second;
+  } else {
+    // otherwise, create a new waste package
+    chosen_wp = ComponentPtr(new Component(this));
+    chosen_wp->copy(chosen_wp_template);
+    current_waste_packages_.push_back(chosen_wp);
   }
-  return toRet;
+  // and load in the waste form
+  chosen_wp->load(WP, waste_form); 
+  // a full package no longer has an open slot
+  if (chosen_wp->isFull()){
+    open_wps_.erase(chosen_wp_template->ID());
+  } else {
+    open_wps_[chosen_wp_template->ID()] = chosen_wp;
+  }
+  return chosen_wp;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -568,6 +863,8 @@ ComponentPtr Cyder::loadBuffer(ComponentPtr waste_package){
       ++iter){
     setPlacement(*iter);
   }
+  // the package now heats its surroundings
+  addHeatSource(waste_package);
   return buffers_.front();
 }
 
@@ -615,9 +912,68 @@ ComponentPtr Cyder::setPlacement(ComponentPtr comp){
   comp->addComponentToTable(comp);
   return comp; 
 }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+point_t Cyder::nextPlacement(){
+  // mirror the WP placement in setPlacement, including a new buffer if the 
+  // current one is full
+  double n_buffers = buffers_.size();
+  if (buffers_.empty() || buffers_.front()->isFull()) {
+    n_buffers += 1;
+  }
+  point_t to_ret = {(emplaced_waste_packages_.size()+1)*dx_ - dx_/2, 
+    (n_buffers - .5)*dy_, dz_};
+  return to_ret;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cyder::addHeatSource(ComponentPtr waste_package){
+  if (!thermal_field_) {
+    return;
+  }
+  mat_rsrc_ptr mat = packageMat(waste_package);
+  if (mat) {
+    thermal_field_->addSource(waste_package->centroid(), TI->time(), mat);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+mat_rsrc_ptr Cyder::packageMat(ComponentPtr waste_package){
+  std::deque<mat_rsrc_ptr> mats = waste_package->wastes();
+  std::vector<ComponentPtr> daughters = waste_package->daughters();
+  for (std::vector<ComponentPtr>::iterator iter = daughters.begin();  
+      iter != daughters.end(); 
+      ++iter){
+    std::deque<mat_rsrc_ptr> wf_mats = (*iter)->wastes();
+    mats.insert(mats.end(), wf_mats.begin(), wf_mats.end());
+  }
+  std::pair<IsoVector, double> sum = MatTools::sum_mats(mats);
+  mat_rsrc_ptr to_ret;
+  if (sum.second > 0) {
+    to_ret = mat_rsrc_ptr(new Material(sum.first.comp()));
+    to_ret->setQuantity(sum.second);
+  }
+  return to_ret;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cyder::packageAcceptable(ComponentPtr waste_package){
+  // without a thermal field and a limit, there is no thermal constraint
+  if (!thermal_field_ || t_lim_ <= 0) {
+    return true;
+  }
+  mat_rsrc_ptr mat = packageMat(waste_package);
+  return !mat || mat_acceptable(mat);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cyder::mat_acceptable(mat_rsrc_ptr mat){
-  return thermal_model_->mat_acceptable(mat, r_lim_, t_lim_);
+  bool to_ret = thermal_model_->mat_acceptable(mat, r_lim_, t_lim_);
+  // account for the heat of the packages that are already emplaced
+  if (to_ret && thermal_field_) {
+    to_ret = thermal_field_->mat_acceptable(nextPlacement(), TI->time(), mat, 
+        t_lim_);
+  }
+  return to_ret;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -642,6 +998,10 @@ void Cyder::transportHeat(int time){
   if ( far_field_){
     far_field_->transportHeat(time);
   }
+  // superpose the heat of all of the emplaced packages
+  if (thermal_field_) {
+    thermal_field_->transportHeat(time);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -663,32 +1023,142 @@ void Cyder::transportNuclides(int the_time){
       ++iter){
     (*iter)->transportNuclides(the_time);
   }
+  // a far field grid replaces the far_field_ component. Each buffer releases 
+  // into the grid cell at its centroid, which sets its outer boundary.
+  if (far_field_grid_) {
+    for (std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
+        iter != buffers_.end();
+        ++iter){
+      releaseToGrid(*iter);
+    }
+    far_field_grid_->transportNuclides(the_time);
+    updateContaminantTable(the_time);
+    return;
+  }
+  // otherwise what the far field draws from each buffer is tallied
+  std::vector<IsoConcMap> before;
+  for ( std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
+      iter != buffers_.end();
+      ++iter){
+    before.push_back(bufferMasses(*iter));
+  }
   if (far_field_){
     far_field_->transportNuclides(the_time);
   }
+  for (size_t i = 0; i < before.size(); ++i){
+    IsoConcMap after = bufferMasses(buffers_[i]);
+    for (IsoConcMap::const_iterator it = before[i].begin(); 
+        it != before[i].end(); ++it){
+      double lost = (*it).second - after[(*it).first];
+      if (lost > 0) {
+        totals_->addRelease((*it).first, lost);
+      }
+    }
+  }
   updateContaminantTable(the_time);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoConcMap Cyder::bufferMasses(ComponentPtr buffer){
+  std::pair<IsoVector, double> sum = MatTools::sum_mats(buffer->wastes());
+  if (sum.second <= 0) {
+    return IsoConcMap();
+  }
+  return MatTools::comp_to_conc_map(sum.first.comp(), sum.second, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cyder::releaseToGrid(ComponentPtr buffer){
+  NuclideModelPtr model = buffer->nuclide_model();
+  std::pair<IsoVector, double> source_term = model->source_term_bc();
+  if (source_term.second <= 0) {
+    return;
+  }
+  // the buffer releases its source term only while its boundary 
+  // concentration exceeds that of the cell, in proportion to the difference
+  point_t loc = buffer->centroid();
+  CompMapPtr comp = source_term.first.comp();
+  IsoConcMap released;
+  for (CompMap::const_iterator it = comp->begin(); it != comp->end(); ++it){
+    Iso iso = (*it).first;
+    double kg = source_term.first.massFraction(iso)*source_term.second;
+    Concentration c_cell = far_field_grid_->conc(loc, iso);
+    Concentration c_bc = model->dirichlet_bc(iso);
+    if (c_cell > 0) {
+      kg = (c_bc > c_cell) ? kg*(1 - c_cell/c_bc) : 0;
+    }
+    if (kg > 0) {
+      released[iso] = kg;
+    }
+  }
+  if (released.empty()) {
+    return;
+  }
+  std::pair<CompMapPtr, double> comp_pair = 
+    MatTools::conc_to_comp_map(released, 1);
+  mat_rsrc_ptr mat = model->extract(comp_pair.first, comp_pair.second);
+  CompMapPtr extracted = mat->isoVector().comp();
+  for (CompMap::const_iterator it = extracted->begin(); 
+      it != extracted->end(); ++it){
+    totals_->addRelease((*it).first, 
+        mat->isoVector().massFraction((*it).first)*mat->quantity());
+  }
+  far_field_grid_->addRelease(loc, extracted, mat->quantity());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cyder::tallyTotals(ComponentPtr comp, int the_time){
+  NuclideModelPtr model = comp->nuclide_model();
+  std::pair<IsoVector, double> vec_pair = model->vec_hist(the_time);
+  CompMapPtr comp_map = vec_pair.first.comp();
+  for (CompMap::const_iterator entry = comp_map->begin(); 
+      entry != comp_map->end(); ++entry){
+    totals_->addMass(the_time, comp->type(), (*entry).first, 
+        (*entry).second*vec_pair.second, 
+        model->conc_hist(the_time, (*entry).first));
+  }
+  // the screened remainder is tallied where it is held, and never released
+  if (nuclide_screen_ && comp->inert_kg() > 0) {
+    totals_->addMass(the_time, comp->type(), nuclide_screen_->remainder(), 
+        comp->inert_kg(), 0);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cyder::updateContaminantTable(int the_time) {
   for ( std::deque< ComponentPtr >::const_iterator iter = waste_forms_.begin();
       iter != waste_forms_.end();
       ++iter){
     (*iter)->updateContaminantTable(the_time);
+    tallyTotals(*iter, the_time);
   }
   for ( std::deque< ComponentPtr >::const_iterator iter = waste_packages_.begin();
       iter != waste_packages_.end();
       ++iter){
     (*iter)->updateContaminantTable(the_time);
+    tallyTotals(*iter, the_time);
   }
   for ( std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
       iter != buffers_.end();
       ++iter){
     (*iter)->updateContaminantTable(the_time);
+    tallyTotals(*iter, the_time);
   }
-  if (far_field_){
+  if (far_field_grid_) {
+    // the grid stands in for the far field in the totals
+    std::vector<Iso> isos = far_field_grid_->isos();
+    for (size_t i = 0; i < isos.size(); ++i){
+      totals_->addMass(the_time, FF, isos[i], far_field_grid_->mass(isos[i]), 
+          far_field_grid_->peak(isos[i]));
+    }
+    far_field_grid_->record(the_time);
+  } else if (far_field_){
     far_field_->updateContaminantTable(the_time);
+    tallyTotals(far_field_, the_time);
   }
+  totals_->record(the_time);
+  // record the rows of every thread, in order
+  EB->flush();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
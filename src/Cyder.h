@@ -12,12 +12,25 @@
 
 #include "FacilityModel.h"
 #include "Component.h"
+#include "FarFieldGrid.h"
+#include "NuclideScreen.h"
+#include "RepoTotals.h"
+#include "ThermalField.h"
 
 /**
    type definition for waste stream objects
  */
 typedef std::pair<mat_rsrc_ptr, std::string> WasteStream;
 
+/**
+   enumerated list of policies splitting the capacity among the commodities
+ */
+enum RequestPolicy {
+  PROPORTIONAL, /**< shares weighted by the mass received of each commodity >**/
+  PRIORITY, /**< shares weighted by the order of the incommodities >**/
+  THERMAL, /**< equal shares, each capped by the mass the headroom could hold >**/
+  LAST_REQUEST_POLICY};
+
 /*! Cyder
     This FacilityModel seeks to provide a generic disposal system model
    
@@ -56,15 +69,21 @@ typedef std::pair<mat_rsrc_ptr, std::string> WasteStream;
    The Cyder is under development at this time. 
    
    In general, it starts operation when the simulation reaches the month specified 
-   as the startDate. Each month, the Cyder makes a request for the 
+   as the startDate. Each month, the Cyder makes a request for each of the 
    inCommod commodity types at a rate corresponding to the calculated capacity less 
    the amount it currently has in its stocks (which begins the simulation empty). 
+   The capacity is split among the commodities according to the optional 
+   request_policy: PROPORTIONAL (the default), PRIORITY, or THERMAL.
    
    If a request is matched with an offer, the Cyder receives that 
    order from the supplier and adds the quantity to its stocks. 
    
    At the end of the month, it then proceeds to condition, package, and load the 
    material into the repository according to thermal and nuclide constraints. 
+   If a nuclide_screening is given, each waste stream is first reduced to its 
+   significant isotopes, ranked by MASS, ACTIVITY or TOXICITY, with the mass 
+   of the rest lumped into a remainder that the waste form holds apart 
+   from transport. 
    
    During each month, nuclide and heat transport calculations are completed within 
    the repository in order to determine useful fuel cycle metrics.
@@ -187,6 +206,25 @@ protected:
      */
     ThermalModelPtr thermal_model_;
 
+    /**
+       When the thermal_model_ is an STCThermal model, this field superposes 
+       the heat of every emplaced waste package. Its peak temperature limits 
+       the capacity of the repository.
+     */
+    ThermalFieldPtr thermal_field_;
+
+    /**
+       The radius beyond which packages do not heat one another [m]. 
+       Optional, defaulting to five times the larger of dx_ and dy_.
+     */
+    double thermal_cutoff_;
+
+    /**
+       The policy splitting the monthly capacity among the incommodities. 
+       Optional, defaulting to PROPORTIONAL.
+     */
+    RequestPolicy request_policy_;
+
     /**
        A limit to how quickly the Cyder can accept waste.
        Units vary. It will be in the commodity unit per month.
@@ -221,6 +259,27 @@ protected:
      */
     std::deque<WasteStream> inventory_;
 
+    /**
+       The running total mass of the stocks, overall and per commodity [kg]. 
+       These are updated as materials are received and emplaced, so that 
+       the capacity is known without iterating over the stocks.
+     */
+    kahan_sum_t stocks_total_;
+    std::map<std::string, kahan_sum_t> stocks_totals_;
+
+    /**
+       The running total mass of the inventory, overall and per commodity, 
+       as it was emplaced [kg]. 
+     */
+    kahan_sum_t inventory_total_;
+    std::map<std::string, kahan_sum_t> inventory_totals_;
+
+    /**
+       The last material received of each commodity, which stands for the 
+       heat of that commodity when the THERMAL policy plans the requests.
+     */
+    std::map<std::string, mat_rsrc_ptr> last_received_;
+
     /**
        The maximum size to which the inventory may grow..
        The Cyder must stop processing the material in its stocks 
@@ -266,6 +325,28 @@ protected:
      */
     ComponentPtr far_field_;
 
+    /**
+       When a far_field_grid is given, this grid resolves the far field in 
+       three dimensions in place of the far_field_ component, which is then 
+       neither transported nor recorded. Each buffer releases into the cell 
+       at its centroid, which advects and disperses it.
+     */
+    FarFieldGridPtr far_field_grid_;
+
+    /**
+       When a nuclide_screening is given, this screen reduces each waste 
+       stream to its significant isotopes as it is conditioned. The mass of 
+       the rest is held inert in the waste form, tallied in the repoTotals 
+       under the remainder isotope, and never transported or released.
+     */
+    NuclideScreenPtr nuclide_screen_;
+
+    /**
+       The running aggregates of the contaminants, by component type, and of 
+       the releases to the far field, recorded each tock to compact tables
+     */
+    RepoTotalsPtr totals_;
+
     /**
        The buffer template before initialization.
        This will be copied and initialized before use.
@@ -289,6 +370,13 @@ protected:
      */
     std::deque<ComponentPtr> current_waste_packages_;
 
+    /**
+       The only partially full waste package of each kind, keyed by the ID 
+       of its waste package template. A kind has at most one open package, 
+       so the next open slot is found without scanning the current packages.
+     */
+    std::map<int, ComponentPtr> open_wps_;
+
     /**
        The waste package components that have been emplaced
      */
@@ -368,6 +456,36 @@ protected:
      */
     ComponentPtr setPlacement(ComponentPtr comp);
 
+    /**
+       Returns the location at which the next waste package will be placed
+     */
+    point_t nextPlacement();
+
+    /**
+       Adds the waste in an emplaced waste package to the thermal field
+       
+       @param waste_package the package that has just been placed
+     */
+    void addHeatSource(ComponentPtr waste_package);
+
+    /**
+       Returns the waste in a waste package and its waste forms as a single 
+       material, or a null pointer if the package is empty
+       
+       @param waste_package the package
+     */
+    mat_rsrc_ptr packageMat(ComponentPtr waste_package);
+
+    /**
+       Returns true if a waste package may be placed next without the 
+       projected peak temperature change, including the heat of the packages 
+       already emplaced, reaching the limiting temperature. Always true 
+       without a thermal field.
+       
+       @param waste_package the package to place next
+     */
+    bool packageAcceptable(ComponentPtr waste_package);
+
     /**
        Initializes the name and model type of the component
        
@@ -391,6 +509,34 @@ protected:
      */
     void transportNuclides(int the_time) ;
 
+    /**
+       Releases the source term of a buffer into the cell of the 
+       far_field_grid_ at its centroid, which serves as the buffer's outer 
+       boundary. Each isotope is released in proportion to how far the 
+       buffer's boundary concentration exceeds the cell's, and not at all 
+       once the cell has caught up. The release is tallied in the totals.
+
+       @param buffer the buffer to release from
+     */
+    void releaseToGrid(ComponentPtr buffer) ;
+
+    /**
+       Returns the mass of each isotope in a buffer, to tally its release to 
+       the far field
+
+       @param buffer the buffer whose wastes are summed
+       @return the mass of each isotope in the buffer [kg]
+     */
+    IsoConcMap bufferMasses(ComponentPtr buffer) ;
+
+    /**
+       Adds the state of a component to the running totals
+
+       @param comp the component whose isotopes are tallied
+       @param the_time the timestep at which to tally its state
+     */
+    void tallyTotals(ComponentPtr comp, int the_time) ;
+
     /**
        Record the state of each component, radially outward
 
@@ -452,12 +598,82 @@ public:
     void addRowToParamsTable();
 
     /**
-       get the commodity-specific capacity of the Cyder
+       get the commodity-specific capacity of the Cyder.
+       This is the monthly acceptance capacity less what is already in the 
+       stocks of this commodity, bounded by the empty space left in the 
+       inventory. This is zero while thermalLimitReached().
        
        @param commod the commodity
      */
     double getCapacity(std::string commod) ;
 
+    /**
+       get the capacity of the Cyder for all commodities together. 
+       This is the monthly acceptance capacity less everything already in 
+       the stocks, bounded by the empty space left in the inventory. This is 
+       zero while thermalLimitReached().
+     */
+    double getCapacity() ;
+
+    /**
+       Returns true if the heat of the packages already emplaced is projected
+       to reach t_lim_ at the next placement. This gates on the projection 
+       rather than the historical peak, so the repository accepts waste 
+       again once the field has cooled.
+     */
+    bool thermalLimitReached() ;
+
+    /**
+       Plans the requests for this month, splitting the capacity among all 
+       of the incommodities by the weights of the request_policy_. No 
+       commodity is planned more than its own requestCap(commod), and what 
+       a capped commodity leaves unused is split again among the others.
+
+       @return the amount to request of each incommodity
+     */
+    std::map<std::string, double> planRequests() ;
+
+    /**
+       The weight of each incommodity's share of the capacity, in the order 
+       of in_commods_. 
+
+       PROPORTIONAL weights each commodity by the mass of it received so 
+       far, plus the mean of those masses so that none is starved, and 
+       weights them equally until anything is received. PRIORITY weights 
+       the shares by the order of the incommodities, the first having the 
+       largest. THERMAL weights them equally and bounds them by 
+       requestCap() instead.
+
+       @return the weights, one per incommodity
+     */
+    std::vector<double> requestWeights() ;
+
+    /**
+       The most of a commodity that planRequests() may request this month. 
+       This is its getCapacity(commod) and, under the THERMAL policy, no 
+       more than the mass of it that the headroom between t_lim_ and the 
+       projected peak at the next placement could hold, judged by the last 
+       material received of it.
+
+       @param commod the incommodity
+       @return the cap on the request of that commodity [kg]
+     */
+    double requestCap(std::string commod) ;
+
+    /**
+       Returns the RequestPolicy enum associated with the name. 
+
+       @param policy_name the name of the policy (e.g. PROPORTIONAL)
+       @return the RequestPolicy, LAST_REQUEST_POLICY if the name is unknown
+     */
+    static RequestPolicy requestPolicyEnum(std::string policy_name);
+
+    /// get the policy splitting the capacity among the incommodities
+    RequestPolicy request_policy(){return request_policy_;};
+
+    /// set the policy splitting the capacity among the incommodities
+    void set_request_policy(RequestPolicy policy){request_policy_ = policy;};
+
     /**
        get the total mass of the stuff in the inventory
        
@@ -465,6 +681,14 @@ public:
      */
     double checkInventory();
 
+    /**
+       get the total mass of a commodity in the inventory
+       
+       @param commod the commodity
+       @return the total mass of the commodity as it was emplaced
+     */
+    double checkInventory(std::string commod);
+
     /**
        get the total mass of the stuff in the stocks
        
@@ -472,11 +696,39 @@ public:
      */
     double checkStocks();
 
+    /**
+       get the total mass of a commodity in the stocks
+       
+       @param commod the commodity
+       @return the total mass of the commodity awaiting emplacement
+     */
+    double checkStocks(std::string commod);
+
     /**
       get the advective velocity [m/s] of water movement in the repository
      */
     double adv_vel(){return adv_vel_;};
 
+    /**
+      get the repository-scale thermal field, if the thermal model is STCThermal
+     */
+    ThermalFieldPtr thermal_field(){return thermal_field_;};
+
+    /**
+      get the resolved far field, if a far_field_grid was given
+     */
+    FarFieldGridPtr far_field_grid(){return far_field_grid_;};
+
+    /**
+      get the screen of the emplaced isotopes, if a nuclide_screening was given
+     */
+    NuclideScreenPtr nuclide_screen(){return nuclide_screen_;};
+
+    /**
+      get the running totals of the contaminants
+     */
+    RepoTotalsPtr totals(){return totals_;};
+
 /* ------------------- */ 
 
 };
@@ -0,0 +1,126 @@
+/*! \file CyderReduce.cpp
+    \brief The cyder_reduce tool, which reduces the output databases of many
+    Cyder runs to the compact tables read by the plotting scripts
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Reducer.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+/**
+   Returns the databases whose paths begin with root and end with .sqlite,
+   as collect_filenames does in the plotting scripts.
+ */
+vector<string> collectFilenames(string root){
+  fs::path root_path(root);
+  fs::path dir = root_path.parent_path();
+  if( dir.empty() ) {
+    dir = ".";
+  }
+  string prefix = root_path.filename().string();
+  vector<string> to_ret;
+  for(fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it){
+    string name = (*it).path().filename().string();
+    if( name.compare(0, prefix.size(), prefix) == 0 &&
+        name.size() >= 7 && name.compare(name.size() - 7, 7, ".sqlite") == 0 ) {
+      to_ret.push_back((*it).path().string());
+    }
+  }
+  sort(to_ret.begin(), to_ret.end());
+  return to_ret;
+}
+
+/**
+   Writes the output of one reduction to out_root + suffix.
+ */
+void writeFile(string out_root, string suffix, const vector<run_summary_t>& runs,
+    void (*write)(ostream&, const vector<run_summary_t>&)){
+  ofstream out((out_root + suffix).c_str());
+  write(out, runs);
+}
+
+int main(int argc, char* argv[]){
+  po::options_description desc("Reduces the contaminants, components and "
+      "NuclideModelParams tables of many Cyder output databases to CSV "
+      "tables for the plotting scripts.\nOptions");
+  desc.add_options()
+    ("help,h", "produce this help message")
+    ("root,r", po::value<string>(), "reduce every root*.sqlite database")
+    ("files", po::value<vector<string> >(), "the databases to reduce")
+    ("out,o", po::value<string>()->default_value("reduced"),
+     "the root of the output files")
+    ("threads,j", po::value<int>()->default_value(
+        max(1, int(boost::thread::hardware_concurrency()))),
+     "the number of databases to reduce at once")
+    ("t0", po::value<int>()->default_value(0),
+     "the first timestep, inclusive")
+    ("tf", po::value<int>()->default_value(-1),
+     "the last timestep, exclusive, or -1 through the last timestep of "
+     "each database")
+    ("comp,c", po::value<int>(), "the component id of the pivot")
+    ("xp", po::value<string>(), "the first swept parameter of the pivot")
+    ("yp", po::value<string>()->default_value(""),
+     "the second swept parameter of the pivot, if any")
+    ("time,t", po::value<int>()->default_value(-1),
+     "the timestep of the pivot's mass, or -1 for its peak")
+    ;
+  po::positional_options_description positional;
+  positional.add("files", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc)
+        .positional(positional).run(), vm);
+    po::notify(vm);
+  } catch ( exception& e ) {
+    cerr << e.what() << endl << desc << endl;
+    return 1;
+  }
+  if( vm.count("help") ) {
+    cout << desc << endl;
+    return 0;
+  }
+
+  vector<string> files;
+  if( vm.count("root") ) {
+    files = collectFilenames(vm["root"].as<string>());
+  }
+  if( vm.count("files") ) {
+    vector<string> listed = vm["files"].as<vector<string> >();
+    files.insert(files.end(), listed.begin(), listed.end());
+  }
+  if( files.empty() ) {
+    cerr << "No databases to reduce." << endl << desc << endl;
+    return 1;
+  }
+
+  string out_root = vm["out"].as<string>();
+  try {
+    Reducer reducer(vm["t0"].as<int>(), vm["tf"].as<int>(),
+        vm["threads"].as<int>());
+    vector<run_summary_t> runs = reducer.reduce(files);
+    writeFile(out_root, "_comp_series.csv", runs, &Reducer::writeCompSeries);
+    writeFile(out_root, "_iso_series.csv", runs, &Reducer::writeIsoSeries);
+    if( vm.count("comp") && vm.count("xp") ) {
+      ofstream out((out_root + "_pivot.csv").c_str());
+      Reducer::writePivot(out, runs, vm["comp"].as<int>(),
+          vm["xp"].as<string>(), vm["yp"].as<string>(),
+          vm["time"].as<int>());
+    }
+  } catch ( exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -95,6 +95,8 @@ NuclideModelPtr DegRateNuclide::copy(const NuclideModel& src){
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 
+  invalidate_bc();
+
   return shared_from_this();
 }
 
@@ -109,6 +111,7 @@ void DegRateNuclide::updateNuclideParamsTable(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void DegRateNuclide::update(int the_time){
+  invalidate_bc();
   update_vec_hist(the_time);
   update_conc_hist(the_time);
   set_last_updated(the_time);
@@ -128,6 +131,7 @@ void DegRateNuclide::absorb(mat_rsrc_ptr matToAdd)
   LOG(LEV_DEBUG2,"GRDRNuc") << "DegRateNuclide is absorbing material: ";
   matToAdd->print();
   wastes_.push_back(matToAdd);
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,6 +144,7 @@ mat_rsrc_ptr DegRateNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_
   comp_to_rem->print() ;
   mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, 
         wastes_, 1e-16));
+  invalidate_bc();
   update(last_updated());
   return to_ret;
 }
@@ -164,6 +169,7 @@ void DegRateNuclide::set_deg_rate(double cur_rate){
     throw CycRangeException(msg_ss.str());
   } else {
     deg_rate_ = cur_rate;
+    invalidate_bc();
   }
   assert((cur_rate >=0) && (cur_rate <= 1));
 }
@@ -180,6 +186,28 @@ pair<IsoVector, double> DegRateNuclide::source_term_bc(){
   return make_pair(curr_mats.first, tot_deg()*curr_mats.second);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<double> DegRateNuclide::source_term_sensitivities(vector<Iso>& isos){
+  isos.clear();
+  vector<double> to_ret;
+  pair<IsoVector, double> curr_mats = MatTools::sum_mats(wastes_);
+  if( curr_mats.second > 0 ) {
+    CompMapPtr comp = curr_mats.first.comp();
+    comp->massify();
+    sens_t d(tot_deg());
+    d.set_d(SENS_DEG_RATE, (tot_deg() < 1 && deg_rate() > 0) ? tot_deg()/deg_rate() : 0);
+    CompMap::const_iterator it;
+    for(it = (*comp).begin(); it != (*comp).end(); ++it){
+      sens_t m_iso = d*((*it).second*curr_mats.second);
+      isos.push_back((*it).first);
+      for(int p = 0; p < LAST_SENS_PARAM; ++p){
+        to_ret.push_back(m_iso.d(p));
+      }
+    }
+  }
+  return to_ret;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap DegRateNuclide::dirichlet_bc(){
   IsoConcMap dirichlet;
@@ -192,7 +220,7 @@ IsoConcMap DegRateNuclide::dirichlet_bc(){
 ConcGradMap DegRateNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
   ConcGradMap to_ret;
 
-  IsoConcMap c_int = dirichlet_bc();
+  IsoConcMap c_int = bc_snapshot().dirichlet_map;
   Radius r_int = geom_->radial_midpoint();
 
   int iso; 
@@ -296,16 +324,11 @@ void DegRateNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr>
 
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     pair<CompMapPtr, double> comp_pair;
-    std::pair<IsoVector, double> source_term;
     CompMapPtr comp_to_ext;
     double kg_to_ext=0;
     switch (bc_type_) {
       case SOURCE_TERM :
-        source_term = (*daughter)->source_term_bc();
-        if(source_term.second > 1e-30){
-          comp_to_ext = CompMapPtr(source_term.first.comp());
-          kg_to_ext=source_term.second;
-        }
+        absorb_source_term(*daughter);
         break;
       case DIRICHLET :
         comp_pair = inner_dirichlet(*daughter);
@@ -325,8 +348,9 @@ void DegRateNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr>
         // throw an error
         break;
     }
+    // a flux over a long interval can not take more than the daughter offers
+    kg_to_ext = min(kg_to_ext, (*daughter)->bc_snapshot().source_term.second);
     if(kg_to_ext > 0) {
-      assert(kg_to_ext <= (*daughter)->source_term_bc().second);
       shared_from_this()->absorb(mat_rsrc_ptr((*daughter)->extract(CompMapPtr(comp_to_ext), kg_to_ext)));
     }
   }
@@ -338,8 +362,8 @@ pair<CompMapPtr, double> DegRateNuclide::inner_neumann(NuclideModelPtr daughter)
   ConcGradMap grad_map;
   pair<CompMapPtr, double> comp_pair;
   //flux area perpendicular to flow, timeps porosit, times D.
-  double int_factor =2*SECSPERMONTH*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
-  grad_map = daughter->neumann_bc(dirichlet_bc(), geom()->radial_midpoint());
+  double int_factor =2*SECSPERMONTH*interval()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
+  grad_map = daughter->neumann_bc(bc_snapshot().dirichlet_map, geom()->radial_midpoint());
   conc_map = MatTools::scaleConcMap(grad_map, tot_deg()*int_factor);
   IsoConcMap disp_map;
   IsoConcMap::iterator it;
@@ -360,8 +384,8 @@ pair<CompMapPtr, double> DegRateNuclide::inner_dirichlet(NuclideModelPtr daughte
   pair<CompMapPtr, double> comp_pair;
   //flux area perpendicular to flow, times v.
   
-  double int_factor =2*SECSPERMONTH*v()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
-  conc_map = MatTools::scaleConcMap(daughter->dirichlet_bc(), int_factor);
+  double int_factor =2*SECSPERMONTH*interval()*v()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
+  conc_map = MatTools::scaleConcMap(daughter->bc_snapshot().dirichlet_map, int_factor);
   IsoConcMap::iterator it;
   for(it=conc_map.begin(); it!=conc_map.end(); ++it) {
     if((*it).second < 0.0){
@@ -133,6 +133,18 @@ public:
    */
   virtual std::pair<IsoVector, double> source_term_bc();
 
+  /**
+     returns the instantaneous partial derivatives of the source term bc 
+     with respect to each SensParam. Only the degradation rate, taken to have been constant, 
+     affects this model's source term.
+
+     @param isos is filled with the isotopes of the source term
+     @return the derivative of the mass of each of isos with respect to 
+     each SensParam, those of isotope i at [i*LAST_SENS_PARAM, 
+     (i+1)*LAST_SENS_PARAM)
+   */
+  virtual std::vector<double> source_term_sensitivities(std::vector<Iso>& isos);
+
   /**
      returns the prescribed concentration at the boundary, the dirichlet bc
      in kg/m^3
@@ -272,12 +284,12 @@ public:
   const double tot_deg() const {return tot_deg_;};
 
   /// sets the total degradation of the component
-  void set_tot_deg(const double tot_deg){tot_deg_=tot_deg;};
+  void set_tot_deg(const double tot_deg){tot_deg_=tot_deg; invalidate_bc(); invalidate_volumes();};
 
   /**
     Set the advective velocity v_ through this component. [m/s] 
    */
-  void set_v(const double v){v_ = v;};
+  void set_v(const double v){v_ = v; invalidate_bc();};
 
   /**
     The advective velocity through this component. [m/s] 
@@ -297,7 +309,7 @@ public:
   /**
     Returns the last timestamp at which this component was last degraded [integer timestamp]
    */
-  virtual double V_ff(){return MatTools::V_ff(geom_->volume(), 1, tot_deg());};
+  virtual double V_ff(){return volumes().V_ff;};
   virtual double V_T(){return geom_->volume();};
 
   /// Sets the boundary condition type used on the inner boundary 
@@ -308,6 +320,15 @@ public:
 
 
 protected:
+  /// Derives the free fluid volume from the degradation
+  virtual pore_volumes_t calc_volumes(){
+    pore_volumes_t to_ret;
+    to_ret.V_f = geom_->volume();
+    to_ret.V_s = 0;
+    to_ret.V_ff = MatTools::V_ff(geom_->volume(), 1, tot_deg());
+    return to_ret;
+  };
+
   /**
     The advective velocity through this component [m/s]
    */
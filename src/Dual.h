@@ -0,0 +1,182 @@
+/*! \file Dual.h
+  \brief Declares the Dual class, a forward mode automatic differentiation
+  scalar used to propagate parameter sensitivities
+  \author Kathryn D. Huff
+ */
+#if !defined(_DUAL_H)
+#define _DUAL_H
+
+#include <cmath>
+
+/**
+   @brief Dual is a number that carries, along with its value, its
+   derivatives with respect to N parameters.
+
+   The transport math of MatTools and SolLim is templated on its scalar
+   type. Evaluated on doubles it is unchanged, and evaluated on Duals whose
+   parameters have been seeded with seed() it returns, in the same single
+   pass, the derivative of every result with respect to every parameter.
+   This replaces the 2N reruns of a finite difference study at a cost of
+   about N additional multiplications per operation.
+
+   Comparisons compare values only, so a min() or a branch follows the
+   branch that the double evaluation would take.
+ */
+template <int N>
+class Dual {
+public:
+  /// the constructor for a constant, whose derivatives are zero
+  Dual(double val=0) : val_(val) {
+    for(int p = 0; p < N; ++p){ d_[p] = 0; }
+  };
+
+  /**
+     Creates a parameter, whose derivative with respect to itself is one.
+
+     @param val the value of the parameter
+     @param p the index of the parameter, from 0 to N-1
+     @return the seeded parameter
+   */
+  static Dual seed(double val, int p){
+    Dual to_ret(val);
+    to_ret.d_[p] = 1;
+    return to_ret;
+  };
+
+  /// returns the value
+  double val() const {return val_;};
+
+  /// returns the derivative with respect to parameter p
+  double d(int p) const {return d_[p];};
+
+  /// sets the derivative with respect to parameter p
+  void set_d(int p, double d) {d_[p] = d;};
+
+  /// the number of parameters carried
+  static int n_params() {return N;};
+
+  Dual& operator+=(const Dual& b){
+    val_ += b.val_;
+    for(int p = 0; p < N; ++p){ d_[p] += b.d_[p]; }
+    return *this;
+  };
+
+  Dual& operator-=(const Dual& b){
+    val_ -= b.val_;
+    for(int p = 0; p < N; ++p){ d_[p] -= b.d_[p]; }
+    return *this;
+  };
+
+  Dual& operator*=(const Dual& b){
+    for(int p = 0; p < N; ++p){ d_[p] = d_[p]*b.val_ + val_*b.d_[p]; }
+    val_ *= b.val_;
+    return *this;
+  };
+
+  Dual& operator/=(const Dual& b){
+    double inv = 1/b.val_;
+    val_ *= inv;
+    for(int p = 0; p < N; ++p){ d_[p] = (d_[p] - val_*b.d_[p])*inv; }
+    return *this;
+  };
+
+  Dual operator-() const {
+    Dual to_ret(*this);
+    to_ret.val_ = -val_;
+    for(int p = 0; p < N; ++p){ to_ret.d_[p] = -d_[p]; }
+    return to_ret;
+  };
+
+private:
+  /// the value
+  double val_;
+
+  /// the derivative with respect to each parameter
+  double d_[N];
+};
+
+template <int N>
+Dual<N> operator+(Dual<N> a, const Dual<N>& b) {return a += b;}
+template <int N>
+Dual<N> operator+(Dual<N> a, double b) {return a += Dual<N>(b);}
+template <int N>
+Dual<N> operator+(double a, const Dual<N>& b) {return Dual<N>(a) += b;}
+
+template <int N>
+Dual<N> operator-(Dual<N> a, const Dual<N>& b) {return a -= b;}
+template <int N>
+Dual<N> operator-(Dual<N> a, double b) {return a -= Dual<N>(b);}
+template <int N>
+Dual<N> operator-(double a, const Dual<N>& b) {return Dual<N>(a) -= b;}
+
+template <int N>
+Dual<N> operator*(Dual<N> a, const Dual<N>& b) {return a *= b;}
+template <int N>
+Dual<N> operator*(Dual<N> a, double b) {return a *= Dual<N>(b);}
+template <int N>
+Dual<N> operator*(double a, const Dual<N>& b) {return Dual<N>(a) *= b;}
+
+template <int N>
+Dual<N> operator/(Dual<N> a, const Dual<N>& b) {return a /= b;}
+template <int N>
+Dual<N> operator/(Dual<N> a, double b) {return a /= Dual<N>(b);}
+template <int N>
+Dual<N> operator/(double a, const Dual<N>& b) {return Dual<N>(a) /= b;}
+
+template <int N>
+bool operator<(const Dual<N>& a, const Dual<N>& b) {return a.val() < b.val();}
+template <int N>
+bool operator>(const Dual<N>& a, const Dual<N>& b) {return a.val() > b.val();}
+template <int N>
+bool operator<=(const Dual<N>& a, const Dual<N>& b) {return a.val() <= b.val();}
+template <int N>
+bool operator>=(const Dual<N>& a, const Dual<N>& b) {return a.val() >= b.val();}
+template <int N>
+bool operator==(const Dual<N>& a, const Dual<N>& b) {return a.val() == b.val();}
+template <int N>
+bool operator!=(const Dual<N>& a, const Dual<N>& b) {return a.val() != b.val();}
+
+template <int N>
+bool operator<(const Dual<N>& a, double b) {return a.val() < b;}
+template <int N>
+bool operator>(const Dual<N>& a, double b) {return a.val() > b;}
+template <int N>
+bool operator<=(const Dual<N>& a, double b) {return a.val() <= b;}
+template <int N>
+bool operator>=(const Dual<N>& a, double b) {return a.val() >= b;}
+template <int N>
+bool operator==(const Dual<N>& a, double b) {return a.val() == b;}
+template <int N>
+bool operator!=(const Dual<N>& a, double b) {return a.val() != b;}
+
+/// the exponential of a Dual
+template <int N>
+Dual<N> exp(const Dual<N>& a) {
+  Dual<N> to_ret(std::exp(a.val()));
+  for(int p = 0; p < N; ++p){ to_ret.set_d(p, to_ret.val()*a.d(p)); }
+  return to_ret;
+}
+
+/// a Dual raised to a constant power
+template <int N>
+Dual<N> pow(const Dual<N>& a, double b) {
+  Dual<N> to_ret(std::pow(a.val(), b));
+  double slope = b*std::pow(a.val(), b-1);
+  for(int p = 0; p < N; ++p){ to_ret.set_d(p, slope*a.d(p)); }
+  return to_ret;
+}
+
+/// the square root of a Dual
+template <int N>
+Dual<N> sqrt(const Dual<N>& a) {
+  return pow(a, 0.5);
+}
+
+/// returns the value of a double, for code templated on the scalar type
+inline double primal(double a) {return a;}
+
+/// returns the value of a Dual, for code templated on the scalar type
+template <int N>
+double primal(const Dual<N>& a) {return a.val();}
+
+#endif
@@ -0,0 +1,364 @@
+/*! \file EventBuffer.cpp
+    \brief Implements the EventBuffer class, which gathers the output rows of
+    the Cyder on each thread and records them in a deterministic order
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+
+#include "EventBuffer.h"
+#include "EventManager.h"
+
+using namespace std;
+
+EventBuffer* EventBuffer::instance_ = 0;
+boost::once_flag EventBuffer::instance_flag_ = BOOST_ONCE_INIT;
+
+/// orders contaminant rows by time, then component id, then isotope
+static bool contaminantLess(const contaminant_row_t& a,
+    const contaminant_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  if( a.comp_id != b.comp_id ) { return a.comp_id < b.comp_id; };
+  return a.iso < b.iso;
+}
+
+/// orders sensitivity rows by time, then component id, then isotope, then
+/// parameter
+static bool sensitivityLess(const sensitivity_row_t& a,
+    const sensitivity_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  if( a.comp_id != b.comp_id ) { return a.comp_id < b.comp_id; };
+  if( a.iso != b.iso ) { return a.iso < b.iso; };
+  return a.param < b.param;
+}
+
+/// orders param rows by component id, then name
+static bool paramLess(const param_row_t& a, const param_row_t& b){
+  if( a.comp_id != b.comp_id ) { return a.comp_id < b.comp_id; };
+  return a.name < b.name;
+}
+
+/// orders repoTotals rows by time, then component type, then isotope
+static bool repoTotalLess(const repo_total_row_t& a, 
+    const repo_total_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  if( a.comp_type != b.comp_type ) { return a.comp_type < b.comp_type; };
+  return a.iso < b.iso;
+}
+
+/// orders repoReleases rows by time, then isotope
+static bool repoReleaseLess(const repo_release_row_t& a, 
+    const repo_release_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  return a.iso < b.iso;
+}
+
+/// orders repoPeaks rows by time, then component type, then isotope
+static bool repoPeakLess(const repo_peak_row_t& a, const repo_peak_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  if( a.comp_type != b.comp_type ) { return a.comp_type < b.comp_type; };
+  return a.iso < b.iso;
+}
+
+/// orders farFieldConc rows by time, then isotope, then cell
+static bool farFieldLess(const far_field_row_t& a, const far_field_row_t& b){
+  if( a.time != b.time ) { return a.time < b.time; };
+  if( a.iso != b.iso ) { return a.iso < b.iso; };
+  if( a.i != b.i ) { return a.i < b.i; };
+  if( a.j != b.j ) { return a.j < b.j; };
+  return a.k < b.k;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EventBuffer* EventBuffer::Instance() {
+  boost::call_once(&EventBuffer::createInstance, instance_flag_);
+  return instance_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::createInstance() {
+  instance_ = new EventBuffer();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+row_buffer_t& EventBuffer::local() {
+  if( local_.get() == NULL ) {
+    boost::mutex::scoped_lock lock(mutex_);
+    buffers_.push_back(boost::shared_ptr<row_buffer_t>(new row_buffer_t()));
+    buffers_.back()->retired = false;
+    local_.reset(buffers_.back().get());
+  }
+  return *local_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::release(row_buffer_t* buffer) {
+  // the rows of an exited thread wait for the next take, so the buffer is 
+  // only marked here
+  boost::mutex::scoped_lock lock(EB->mutex_);
+  buffer->retired = true;
+  EB->prune();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::prune() {
+  vector<boost::shared_ptr<row_buffer_t> >::iterator it = buffers_.begin();
+  while( it != buffers_.end() ) {
+    if( (*it)->retired && (*it)->contaminants.empty() && 
+        (*it)->sensitivities.empty() && (*it)->params.empty() && 
+        (*it)->totals.empty() && (*it)->releases.empty() && 
+        (*it)->peaks.empty() && (*it)->far_field.empty() ) {
+      it = buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addContaminant(int the_time, int comp_id, Iso iso, double kg,
+    Concentration conc) {
+  contaminant_row_t row = {the_time, comp_id, iso, kg, conc};
+  local().contaminants.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addSensitivity(int the_time, int comp_id, Iso iso, 
+    string param, double dkg) {
+  sensitivity_row_t row = {the_time, comp_id, iso, param, dkg};
+  local().sensitivities.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addParam(int comp_id, string name, double val) {
+  param_row_t row = {comp_id, name, val};
+  local().params.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addRepoTotal(int the_time, string comp_type, Iso iso, 
+    double kg) {
+  repo_total_row_t row = {the_time, comp_type, iso, kg};
+  local().totals.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addRepoRelease(int the_time, Iso iso, double kg, 
+    double cumulative) {
+  repo_release_row_t row = {the_time, iso, kg, cumulative};
+  local().releases.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addRepoPeak(int the_time, string comp_type, Iso iso, 
+    Concentration conc) {
+  repo_peak_row_t row = {the_time, comp_type, iso, conc};
+  local().peaks.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::addFarFieldConc(int the_time, int i, int j, int k, Iso iso,
+    Concentration conc) {
+  far_field_row_t row = {the_time, i, j, k, iso, conc};
+  local().far_field.push_back(row);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<contaminant_row_t> EventBuffer::takeContaminants() {
+  vector<contaminant_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<contaminant_row_t>& rows = buffers_[b]->contaminants;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  // the threads' rows interleave arbitrarily, the sort makes them canonical
+  stable_sort(to_ret.begin(), to_ret.end(), contaminantLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<sensitivity_row_t> EventBuffer::takeSensitivities() {
+  vector<sensitivity_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<sensitivity_row_t>& rows = buffers_[b]->sensitivities;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), sensitivityLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<param_row_t> EventBuffer::takeParams() {
+  vector<param_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<param_row_t>& rows = buffers_[b]->params;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), paramLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<repo_total_row_t> EventBuffer::takeRepoTotals() {
+  vector<repo_total_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<repo_total_row_t>& rows = buffers_[b]->totals;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), repoTotalLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<repo_release_row_t> EventBuffer::takeRepoReleases() {
+  vector<repo_release_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<repo_release_row_t>& rows = buffers_[b]->releases;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), repoReleaseLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<repo_peak_row_t> EventBuffer::takeRepoPeaks() {
+  vector<repo_peak_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<repo_peak_row_t>& rows = buffers_[b]->peaks;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), repoPeakLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<far_field_row_t> EventBuffer::takeFarFieldConcs() {
+  vector<far_field_row_t> to_ret;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    vector<far_field_row_t>& rows = buffers_[b]->far_field;
+    to_ret.insert(to_ret.end(), rows.begin(), rows.end());
+    rows.clear();
+  }
+  stable_sort(to_ret.begin(), to_ret.end(), farFieldLess);
+  prune();
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int EventBuffer::size() {
+  int to_ret = 0;
+  boost::mutex::scoped_lock lock(mutex_);
+  for(size_t b = 0; b < buffers_.size(); ++b){
+    to_ret += buffers_[b]->contaminants.size() + 
+      buffers_[b]->sensitivities.size() + buffers_[b]->params.size() + 
+      buffers_[b]->totals.size() + buffers_[b]->releases.size() + 
+      buffers_[b]->peaks.size() + buffers_[b]->far_field.size();
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int EventBuffer::n_buffers() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return buffers_.size();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventBuffer::flush() {
+  vector<param_row_t> params = takeParams();
+  vector<param_row_t>::const_iterator param;
+  for(param = params.begin(); param != params.end(); ++param){
+    EM->newEvent("NuclideModelParams")
+      ->addVal("CompID", (*param).comp_id)
+      ->addVal("ParamName", (*param).name)
+      ->addVal("ParamVal", (*param).val)
+      ->record();
+  }
+
+  vector<contaminant_row_t> contaminants = takeContaminants();
+  vector<contaminant_row_t>::const_iterator row;
+  for(row = contaminants.begin(); row != contaminants.end(); ++row){
+    EM->newEvent("contaminants")
+      ->addVal("CompID", (*row).comp_id)
+      ->addVal("Time", (*row).time)
+      ->addVal("IsoID", (*row).iso)
+      ->addVal("MassKG", (*row).kg)
+      ->addVal("AvailConc", (*row).conc)
+      ->record();
+  }
+
+  vector<sensitivity_row_t> sensitivities = takeSensitivities();
+  vector<sensitivity_row_t>::const_iterator sens;
+  for(sens = sensitivities.begin(); sens != sensitivities.end(); ++sens){
+    EM->newEvent("sourceTermPartials")
+      ->addVal("CompID", (*sens).comp_id)
+      ->addVal("Time", (*sens).time)
+      ->addVal("IsoID", (*sens).iso)
+      ->addVal("ParamName", (*sens).param)
+      ->addVal("InstantPartialKG", (*sens).dkg)
+      ->record();
+  }
+
+  vector<repo_total_row_t> totals = takeRepoTotals();
+  vector<repo_total_row_t>::const_iterator total;
+  for(total = totals.begin(); total != totals.end(); ++total){
+    EM->newEvent("repoTotals")
+      ->addVal("Time", (*total).time)
+      ->addVal("CompType", (*total).comp_type)
+      ->addVal("IsoID", (*total).iso)
+      ->addVal("MassKG", (*total).kg)
+      ->record();
+  }
+
+  vector<repo_release_row_t> releases = takeRepoReleases();
+  vector<repo_release_row_t>::const_iterator release;
+  for(release = releases.begin(); release != releases.end(); ++release){
+    EM->newEvent("repoReleases")
+      ->addVal("Time", (*release).time)
+      ->addVal("IsoID", (*release).iso)
+      ->addVal("ReleasedKG", (*release).kg)
+      ->addVal("CumulativeKG", (*release).cumulative)
+      ->record();
+  }
+
+  vector<repo_peak_row_t> peaks = takeRepoPeaks();
+  vector<repo_peak_row_t>::const_iterator peak;
+  for(peak = peaks.begin(); peak != peaks.end(); ++peak){
+    EM->newEvent("repoPeaks")
+      ->addVal("Time", (*peak).time)
+      ->addVal("CompType", (*peak).comp_type)
+      ->addVal("IsoID", (*peak).iso)
+      ->addVal("PeakConc", (*peak).conc)
+      ->record();
+  }
+
+  vector<far_field_row_t> far_field = takeFarFieldConcs();
+  vector<far_field_row_t>::const_iterator cell;
+  for(cell = far_field.begin(); cell != far_field.end(); ++cell){
+    EM->newEvent("farFieldConc")
+      ->addVal("Time", (*cell).time)
+      ->addVal("I", (*cell).i)
+      ->addVal("J", (*cell).j)
+      ->addVal("K", (*cell).k)
+      ->addVal("IsoID", (*cell).iso)
+      ->addVal("Conc", (*cell).conc)
+      ->record();
+  }
+}
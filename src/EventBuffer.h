@@ -0,0 +1,317 @@
+/*! \file EventBuffer.h
+  \brief Declares the EventBuffer class, which gathers the output rows of
+  the Cyder on each thread and records them in a deterministic order
+  \author Kathryn D. Huff
+ */
+#if !defined(_EVENTBUFFER_H)
+#define _EVENTBUFFER_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "MatTools.h"
+
+#define EB EventBuffer::Instance()
+
+/**
+   A row of the contaminants table, the mass and concentration of one
+   isotope in one component at one time.
+ */
+typedef struct contaminant_row_t
+{
+  int time; /**< the timestep of the row >**/
+  int comp_id; /**< the id of the component >**/
+  Iso iso; /**< the isotope >**/
+  double kg; /**< the mass of the isotope in the component [kg] >**/
+  Concentration conc; /**< the available concentration [kg/m^3] >**/
+} contaminant_row_t;
+
+/**
+   A row of the sourceTermPartials table, the instantaneous partial
+   derivative of the available mass of one isotope in one component with
+   respect to one parameter, holding the contained inventory fixed.
+ */
+typedef struct sensitivity_row_t
+{
+  int time; /**< the timestep of the row >**/
+  int comp_id; /**< the id of the component >**/
+  Iso iso; /**< the isotope >**/
+  std::string param; /**< the name of the parameter >**/
+  double dkg; /**< the partial derivative of the available mass [kg/unit of param] >**/
+} sensitivity_row_t;
+
+/**
+   A row of the NuclideModelParams table, one parameter of the nuclide
+   model of one component.
+ */
+typedef struct param_row_t
+{
+  int comp_id; /**< the id of the component >**/
+  std::string name; /**< the name of the parameter >**/
+  double val; /**< the value of the parameter >**/
+} param_row_t;
+
+/**
+   A row of the repoTotals table, the mass of one isotope in one component
+   type at one time.
+ */
+typedef struct repo_total_row_t
+{
+  int time; /**< the timestep of the row >**/
+  std::string comp_type; /**< the name of the component type >**/
+  Iso iso; /**< the isotope >**/
+  double kg; /**< the mass of the isotope in the component type [kg] >**/
+} repo_total_row_t;
+
+/**
+   A row of the repoReleases table, the mass of one isotope released to the
+   far field at one time and so far.
+ */
+typedef struct repo_release_row_t
+{
+  int time; /**< the timestep of the row >**/
+  Iso iso; /**< the isotope >**/
+  double kg; /**< the mass released this timestep [kg] >**/
+  double cumulative; /**< the mass released so far [kg] >**/
+} repo_release_row_t;
+
+/**
+   A row of the repoPeaks table, a rise of the peak concentration of one
+   isotope in one component type.
+ */
+typedef struct repo_peak_row_t
+{
+  int time; /**< the timestep at which the peak was reached >**/
+  std::string comp_type; /**< the name of the component type >**/
+  Iso iso; /**< the isotope >**/
+  Concentration conc; /**< the peak concentration [kg/m^3] >**/
+} repo_peak_row_t;
+
+/**
+   A row of the farFieldConc table, the concentration of one isotope in one
+   cell of the far field grid at one time.
+ */
+typedef struct far_field_row_t
+{
+  int time; /**< the timestep of the row >**/
+  int i; /**< the x index of the cell >**/
+  int j; /**< the y index of the cell >**/
+  int k; /**< the z index of the cell >**/
+  Iso iso; /**< the isotope >**/
+  Concentration conc; /**< the concentration in the cell [kg/m^3] >**/
+} far_field_row_t;
+
+/**
+   The rows appended by one thread since the last flush.
+ */
+typedef struct row_buffer_t
+{
+  std::vector<contaminant_row_t> contaminants; /**< the contaminant rows >**/
+  std::vector<sensitivity_row_t> sensitivities; /**< the sensitivity rows >**/
+  std::vector<param_row_t> params; /**< the nuclide model param rows >**/
+  std::vector<repo_total_row_t> totals; /**< the repoTotals rows >**/
+  std::vector<repo_release_row_t> releases; /**< the repoReleases rows >**/
+  std::vector<repo_peak_row_t> peaks; /**< the repoPeaks rows >**/
+  std::vector<far_field_row_t> far_field; /**< the farFieldConc rows >**/
+  bool retired; /**< whether the thread that owned it has exited >**/
+} row_buffer_t;
+
+/**
+   @class EventBuffer
+   The EventBuffer stands between the Cyder and the EventManager. Each
+   thread that adds a row appends it to a buffer of its own, without
+   locking, so components may be transported in parallel without
+   contending for the EventManager. At the end of a tock, flush() merges
+   the buffers, orders the contaminant rows by (time, component id,
+   isotope), the sensitivity rows by (time, component id, isotope,
+   parameter), the param rows by (component id, name), the repository
+   total rows by (time, component type, isotope) and the far field rows by
+   (time, isotope, cell), and records them all in one pass. The output is therefore the same however the work was
+   divided among threads.
+
+   flush() must not run while other threads are adding rows.
+ */
+class EventBuffer {
+private:
+  /// the constructor, for Instance() alone
+  EventBuffer() : local_(&EventBuffer::release) {};
+
+  /// a pointer to the EventBuffer once it has been created
+  static EventBuffer* instance_;
+
+  /// guards the one time creation of instance_
+  static boost::once_flag instance_flag_;
+
+  /// creates instance_, once
+  static void createInstance();
+
+  /**
+     Called as a thread exits. The buffers are owned by buffers_, so this 
+     frees nothing, but marks the thread's buffer retired so that it is 
+     pruned once its rows have been taken.
+   */
+  static void release(row_buffer_t* buffer);
+
+public:
+  /**
+     Provides the singleton EventBuffer.
+
+     @return a pointer to the EventBuffer
+   */
+  static EventBuffer* Instance();
+
+  /**
+     Appends a row of the contaminants table to this thread's buffer.
+
+     @param the_time the timestep of the row
+     @param comp_id the id of the component
+     @param iso the isotope
+     @param kg the mass of the isotope in the component [kg]
+     @param conc the available concentration of the isotope [kg/m^3]
+   */
+  void addContaminant(int the_time, int comp_id, Iso iso, double kg,
+      Concentration conc);
+
+  /**
+     Appends a row of the sourceTermPartials table to this thread's buffer.
+
+     @param the_time the timestep of the row
+     @param comp_id the id of the component
+     @param iso the isotope
+     @param param the name of the parameter
+     @param dkg the instantaneous partial derivative of the available mass 
+     of the isotope
+   */
+  void addSensitivity(int the_time, int comp_id, Iso iso, std::string param,
+      double dkg);
+
+  /**
+     Appends a row of the NuclideModelParams table to this thread's buffer.
+
+     @param comp_id the id of the component
+     @param name the name of the parameter
+     @param val the value of the parameter
+   */
+  void addParam(int comp_id, std::string name, double val);
+
+  /**
+     Appends a row of the repoTotals table to this thread's buffer.
+
+     @param the_time the timestep of the row
+     @param comp_type the name of the component type
+     @param iso the isotope
+     @param kg the mass of the isotope in the component type [kg]
+   */
+  void addRepoTotal(int the_time, std::string comp_type, Iso iso, double kg);
+
+  /**
+     Appends a row of the repoReleases table to this thread's buffer.
+
+     @param the_time the timestep of the row
+     @param iso the isotope
+     @param kg the mass released this timestep [kg]
+     @param cumulative the mass released so far [kg]
+   */
+  void addRepoRelease(int the_time, Iso iso, double kg, double cumulative);
+
+  /**
+     Appends a row of the repoPeaks table to this thread's buffer.
+
+     @param the_time the timestep at which the peak was reached
+     @param comp_type the name of the component type
+     @param iso the isotope
+     @param conc the peak concentration [kg/m^3]
+   */
+  void addRepoPeak(int the_time, std::string comp_type, Iso iso, 
+      Concentration conc);
+
+  /**
+     Appends a row of the farFieldConc table to this thread's buffer.
+
+     @param the_time the timestep of the row
+     @param i the x index of the cell
+     @param j the y index of the cell
+     @param k the z index of the cell
+     @param iso the isotope
+     @param conc the concentration in the cell [kg/m^3]
+   */
+  void addFarFieldConc(int the_time, int i, int j, int k, Iso iso, 
+      Concentration conc);
+
+  /**
+     Empties every thread's buffer and returns their contaminant rows, in
+     order of time, component id and isotope.
+   */
+  std::vector<contaminant_row_t> takeContaminants();
+
+  /**
+     Empties every thread's buffer and returns their sensitivity rows, in
+     order of time, component id, isotope and parameter.
+   */
+  std::vector<sensitivity_row_t> takeSensitivities();
+
+  /**
+     Empties every thread's buffer and returns their param rows, in order
+     of component id and name.
+   */
+  std::vector<param_row_t> takeParams();
+
+  /**
+     Empties every thread's buffer and returns their repoTotals rows, in
+     order of time, component type and isotope.
+   */
+  std::vector<repo_total_row_t> takeRepoTotals();
+
+  /**
+     Empties every thread's buffer and returns their repoReleases rows, in
+     order of time and isotope.
+   */
+  std::vector<repo_release_row_t> takeRepoReleases();
+
+  /**
+     Empties every thread's buffer and returns their repoPeaks rows, in
+     order of time, component type and isotope.
+   */
+  std::vector<repo_peak_row_t> takeRepoPeaks();
+
+  /**
+     Empties every thread's buffer and returns their farFieldConc rows, in
+     order of time, isotope and cell.
+   */
+  std::vector<far_field_row_t> takeFarFieldConcs();
+
+  /**
+     Records the rows of every thread's buffer with the EventManager, in
+     order, and empties the buffers.
+   */
+  void flush();
+
+  /// Returns the number of rows waiting in all the buffers
+  int size();
+
+  /// Returns the number of buffers held, one per live thread that has 
+  /// added a row, plus any exited thread whose rows are still waiting
+  int n_buffers();
+
+protected:
+  /// returns the calling thread's buffer, creating it on first use
+  row_buffer_t& local();
+
+  /// drops the retired buffers that hold no rows. mutex_ must be held.
+  void prune();
+
+  /// the buffer of each thread that has added a row
+  std::vector<boost::shared_ptr<row_buffer_t> > buffers_;
+
+  /// the calling thread's buffer
+  boost::thread_specific_ptr<row_buffer_t> local_;
+
+  /// guards buffers_
+  boost::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,398 @@
+/*! \file FarFieldGrid.cpp
+    \brief Implements the FarFieldGrid class, a structured finite volume grid
+    that advects and disperses the buffer releases through the far field
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "CycException.h"
+#include "EventBuffer.h"
+#include "FarFieldGrid.h"
+#include "Logger.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FarFieldGrid::FarFieldGrid(double x, double y, double z, int nx, int ny,
+    int nz, double v, double D, int n_blocks) :
+  nx_(nx),
+  ny_(ny),
+  nz_(nz),
+  v_(v),
+  D_(D),
+  last_transported_(-1),
+  record_tol_(1e-6),
+  converged_(true),
+  dt_(0),
+  stop_(false)
+{
+  if( nx < 1 || ny < 1 || nz < 1 || n_blocks < 1 || x <= 0 || y <= 0 ||
+      z <= 0 ) {
+    stringstream msg_ss;
+    msg_ss << "The FarFieldGrid requires a positive domain, at least one ";
+    msg_ss << "cell in each direction and at least one block. The values ";
+    msg_ss << "provided were " << nx << "x" << ny << "x" << nz << " cells ";
+    msg_ss << "over " << x << "x" << y << "x" << z << " m in " << n_blocks;
+    msg_ss << " blocks.";
+    LOG(LEV_ERROR, "CydFFG") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  MatTools::validate_finite_pos(v);
+  MatTools::validate_finite_pos(D);
+  dx_ = x/nx;
+  dy_ = y/ny;
+  dz_ = z/nz;
+
+  // a slab is at least one plane thick
+  n_blocks = min(n_blocks, nx);
+  blocks_.resize(n_blocks);
+  for(int b = 0; b < n_blocks; ++b){
+    blocks_[b].i0 = (b*nx)/n_blocks;
+    blocks_[b].i1 = ((b+1)*nx)/n_blocks;
+    blocks_[b].left.assign(ny*nz, 0);
+    blocks_[b].right.assign(ny*nz, 0);
+    blocks_[b].residual = 0;
+    blocks_[b].peak = 0;
+  }
+  sums_pq_.assign(nx, 0);
+  sums_rz_.assign(nx, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FarFieldGrid::~FarFieldGrid(){
+  if( start_ ) {
+    stop_ = true;
+    start_->wait();
+    workers_.join_all();
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::set_record_tol(double tol){
+  MatTools::validate_finite_pos(tol);
+  record_tol_ = tol;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int FarFieldGrid::index(point_t loc){
+  int i = max(0, min(nx_-1, int(floor(loc.x_/dx_))));
+  int j = max(0, min(ny_-1, int(floor(loc.y_/dy_))));
+  int k = max(0, min(nz_-1, int(floor(loc.z_/dz_))));
+  return index(i, j, k);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::addRelease(point_t loc, CompMapPtr comp, double kg){
+  if( kg <= 0 ) {
+    return;
+  }
+  int cell = index(loc);
+  double vol = dx_*dy_*dz_;
+  CompMap::const_iterator it;
+  for(it = (*comp).begin(); it != (*comp).end(); ++it){
+    vector<double>& c = conc_[(*it).first];
+    if( c.empty() ) {
+      c.assign(nx_*ny_*nz_, 0);
+    }
+    c[cell] += (*it).second*kg/vol;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::transportNuclides(int the_time){
+  int elapsed = (last_transported_ < 0) ? 0 : the_time - last_transported_;
+  last_transported_ = the_time;
+  if( elapsed <= 0 || conc_.empty() ) {
+    return;
+  }
+  double dt = SECSPERMONTH*elapsed;
+
+  int n = blocks_.size();
+  if( n == 1 ) {
+    boost::barrier sync(1);
+    transportBlock(0, dt, sync);
+  } else {
+    // the workers are started once and wait between steps
+    if( !start_ ) {
+      sync_ = boost::shared_ptr<boost::barrier>(new boost::barrier(n));
+      start_ = boost::shared_ptr<boost::barrier>(new boost::barrier(n+1));
+      done_ = boost::shared_ptr<boost::barrier>(new boost::barrier(n+1));
+      for(int b = 0; b < n; ++b){
+        workers_.create_thread(boost::bind(&FarFieldGrid::work, this, b));
+      }
+    }
+    dt_ = dt;
+    start_->wait();
+    done_->wait();
+  }
+
+  if( !converged_ ) {
+    stringstream msg_ss;
+    msg_ss << "The FarFieldGrid dispersion did not converge within ";
+    msg_ss << max_iterations() << " iterations at timestep " << the_time;
+    msg_ss << ".";
+    LOG(LEV_ERROR, "CydFFG") << msg_ss.str();
+    throw CycException(msg_ss.str());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::work(int b){
+  while( true ) {
+    start_->wait();
+    if( stop_ ) {
+      return;
+    }
+    transportBlock(b, dt_, *sync_);
+    done_->wait();
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::exchange(int b, vector<double>& c, boost::barrier& sync){
+  grid_block_t& block = blocks_[b];
+  int plane = ny_*nz_;
+  int w = block.i1 - block.i0;
+  copy(c.begin() + plane, c.begin() + 2*plane, block.left.begin());
+  copy(c.begin() + w*plane, c.begin() + (w+1)*plane, block.right.begin());
+  sync.wait();
+  // the outer ghosts are never read, the outer faces being handled apart
+  if( b > 0 ) {
+    copy(blocks_[b-1].right.begin(), blocks_[b-1].right.end(), c.begin());
+  }
+  if( b < int(blocks_.size()) - 1 ) {
+    copy(blocks_[b+1].left.begin(), blocks_[b+1].left.end(),
+        c.begin() + (w+1)*plane);
+  }
+  // no slab may overwrite its planes before every neighbor has read them
+  sync.wait();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::transportBlock(int b, double dt, boost::barrier& sync){
+  grid_block_t& block = blocks_[b];
+  int n = blocks_.size();
+  int w = block.i1 - block.i0;
+  int plane = ny_*nz_;
+  double vol = dx_*dy_*dz_;
+
+  // the advection is sub-cycled at a Courant number of at most one
+  double courant = v_*dt/dx_;
+  int n_sub = max(1, int(ceil(courant)));
+  double cfl = courant/n_sub;
+
+  // the implicit dispersion couples each cell to its existing neighbors
+  double r[3] = {D_*dt/(dx_*dx_), D_*dt/(dy_*dy_), D_*dt/(dz_*dz_)};
+  if( b == 0 ) {
+    converged_ = true;
+  }
+
+  // the local fields hold a ghost plane on each side of the slab
+  vector<double> c((w+2)*plane, 0);
+  vector<double> x((w+2)*plane, 0);
+  vector<double> res((w+2)*plane, 0);
+  vector<double> z((w+2)*plane, 0);
+  vector<double> p((w+2)*plane, 0);
+  vector<double> q((w+2)*plane, 0);
+
+  // the diagonal of the operator, the preconditioner
+  vector<double> diag((w+2)*plane, 1);
+  for(int li = 1; li <= w; ++li){
+    int i = block.i0 + li - 1;
+    for(int j = 0; j < ny_; ++j){
+      for(int k = 0; k < nz_; ++k){
+        double& d = diag[li*plane + j*nz_ + k];
+        d = 1;
+        if( i > 0 ) { d += r[0]; };
+        if( i < nx_ - 1 ) { d += r[0]; };
+        if( j > 0 ) { d += r[1]; };
+        if( j < ny_ - 1 ) { d += r[1]; };
+        if( k > 0 ) { d += r[2]; };
+        if( k < nz_ - 1 ) { d += r[2]; };
+      }
+    }
+  }
+  map<Iso, vector<double> >::iterator field;
+  for(field = conc_.begin(); field != conc_.end(); ++field){
+    vector<double>& global = (*field).second;
+    copy(global.begin() + block.i0*plane, global.begin() + block.i1*plane,
+        c.begin() + plane);
+
+    // explicit upwind advection, with nothing flowing in at x = 0
+    for(int s = 0; s < n_sub; ++s){
+      exchange(b, c, sync);
+      if( b == 0 ) {
+        fill(c.begin(), c.begin() + plane, 0.0);
+      }
+      if( b == n - 1 ) {
+        vector<double> lost(c.begin() + w*plane, c.begin() + (w+1)*plane);
+        outflow_[(*field).first] += cfl*MatTools::KahanSum(lost)*vol;
+      }
+      // downstream first, so each plane sees its upstream neighbor's old value
+      for(int li = w; li >= 1; --li){
+        for(int cell = li*plane; cell < (li+1)*plane; ++cell){
+          c[cell] -= cfl*(c[cell] - c[cell - plane]);
+        }
+      }
+    }
+
+    // backward Euler dispersion, by Jacobi preconditioned conjugate 
+    // gradients from the advected field. Every slab decides from the same 
+    // sums and maxima, so all stop together.
+    x = c;
+    exchange(b, x, sync);
+    apply(b, x, q, r);
+    double peak = 0;
+    for(int cell = plane; cell < (w+1)*plane; ++cell){
+      res[cell] = c[cell] - q[cell];
+      z[cell] = res[cell]/diag[cell];
+      p[cell] = z[cell];
+      peak = max(peak, fabs(c[cell]));
+    }
+    block.peak = peak;
+    double rz = dot(b, res, z, sums_rz_, sync);
+    double max_peak = 0;
+    for(int other = 0; other < n; ++other){
+      max_peak = max(max_peak, blocks_[other].peak);
+    }
+    bool converged = (max_peak == 0);
+    for(int it = 0; it < max_iterations() && !converged; ++it){
+      exchange(b, p, sync);
+      apply(b, p, q, r);
+      double alpha = rz/dot(b, p, q, sums_pq_, sync);
+      double residual = 0;
+      for(int cell = plane; cell < (w+1)*plane; ++cell){
+        x[cell] += alpha*p[cell];
+        res[cell] -= alpha*q[cell];
+        z[cell] = res[cell]/diag[cell];
+        residual = max(residual, fabs(z[cell]));
+      }
+      block.residual = residual;
+      double rz_next = dot(b, res, z, sums_rz_, sync);
+      double max_residual = 0;
+      for(int other = 0; other < n; ++other){
+        max_residual = max(max_residual, blocks_[other].residual);
+      }
+      converged = (max_residual <= solve_tol()*max_peak);
+      double beta = rz_next/rz;
+      rz = rz_next;
+      for(int cell = plane; cell < (w+1)*plane; ++cell){
+        p[cell] = z[cell] + beta*p[cell];
+      }
+    }
+    if( b == 0 && !converged ) {
+      converged_ = false;
+    }
+    copy(x.begin() + plane, x.begin() + (w+1)*plane,
+        global.begin() + block.i0*plane);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::apply(int b, const vector<double>& p, vector<double>& q,
+    const double r[3]){
+  grid_block_t& block = blocks_[b];
+  int w = block.i1 - block.i0;
+  int plane = ny_*nz_;
+  for(int li = 1; li <= w; ++li){
+    int i = block.i0 + li - 1;
+    for(int j = 0; j < ny_; ++j){
+      for(int k = 0; k < nz_; ++k){
+        int cell = li*plane + j*nz_ + k;
+        double val = p[cell];
+        if( i > 0 ) { val += r[0]*(p[cell] - p[cell - plane]); };
+        if( i < nx_ - 1 ) { val += r[0]*(p[cell] - p[cell + plane]); };
+        if( j > 0 ) { val += r[1]*(p[cell] - p[cell - nz_]); };
+        if( j < ny_ - 1 ) { val += r[1]*(p[cell] - p[cell + nz_]); };
+        if( k > 0 ) { val += r[2]*(p[cell] - p[cell - 1]); };
+        if( k < nz_ - 1 ) { val += r[2]*(p[cell] - p[cell + 1]); };
+        q[cell] = val;
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double FarFieldGrid::dot(int b, const vector<double>& a, 
+    const vector<double>& other, vector<double>& sums, boost::barrier& sync){
+  grid_block_t& block = blocks_[b];
+  int plane = ny_*nz_;
+  for(int i = block.i0; i < block.i1; ++i){
+    int first = (i - block.i0 + 1)*plane;
+    double sum = 0;
+    for(int cell = first; cell < first + plane; ++cell){
+      sum += a[cell]*other[cell];
+    }
+    sums[i] = sum;
+  }
+  sync.wait();
+  double to_ret = 0;
+  for(int i = 0; i < nx_; ++i){
+    to_ret += sums[i];
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FarFieldGrid::record(int the_time){
+  map<Iso, vector<double> >::const_iterator field;
+  for(field = conc_.begin(); field != conc_.end(); ++field){
+    const vector<double>& c = (*field).second;
+    double floor = record_tol_*peak((*field).first);
+    for(int i = 0; i < nx_; ++i){
+      for(int j = 0; j < ny_; ++j){
+        for(int k = 0; k < nz_; ++k){
+          double val = c[index(i, j, k)];
+          if( val > 0 && val >= floor ) {
+            EB->addFarFieldConc(the_time, i, j, k, (*field).first, val);
+          }
+        }
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<Iso> FarFieldGrid::isos(){
+  vector<Iso> to_ret;
+  map<Iso, vector<double> >::const_iterator field;
+  for(field = conc_.begin(); field != conc_.end(); ++field){
+    to_ret.push_back((*field).first);
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Concentration FarFieldGrid::peak(Iso iso){
+  map<Iso, vector<double> >::const_iterator found = conc_.find(iso);
+  if( found == conc_.end() ) {
+    return 0;
+  }
+  return *max_element((*found).second.begin(), (*found).second.end());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Concentration FarFieldGrid::conc(point_t loc, Iso iso){
+  map<Iso, vector<double> >::const_iterator found = conc_.find(iso);
+  return (found == conc_.end()) ? 0 : (*found).second[index(loc)];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double FarFieldGrid::mass(Iso iso){
+  map<Iso, vector<double> >::const_iterator found = conc_.find(iso);
+  if( found == conc_.end() ) {
+    return 0;
+  }
+  return MatTools::KahanSum((*found).second)*dx_*dy_*dz_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double FarFieldGrid::outflow(Iso iso){
+  map<Iso, double>::const_iterator found = outflow_.find(iso);
+  return (found == outflow_.end()) ? 0 : (*found).second;
+}
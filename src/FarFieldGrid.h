@@ -0,0 +1,279 @@
+/*! \file FarFieldGrid.h
+  \brief Declares the FarFieldGrid class, a structured finite volume grid
+  that advects and disperses the buffer releases through the far field
+  \author Kathryn D. Huff
+ */
+#if !defined(_FARFIELDGRID_H)
+#define _FARFIELDGRID_H
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Geometry.h"
+#include "MatTools.h"
+
+/// A shared pointer for the FarFieldGrid object
+class FarFieldGrid;
+typedef boost::shared_ptr<FarFieldGrid> FarFieldGridPtr;
+
+/**
+   Defines a block of the decomposition, a slab of the grid in x.
+ */
+typedef struct grid_block_t
+{
+  int i0; /**< the first x index of the slab >**/
+  int i1; /**< one past the last x index of the slab >**/
+  std::vector<double> left; /**< the slab's first plane, for its left neighbor >**/
+  std::vector<double> right; /**< the slab's last plane, for its right neighbor >**/
+  double residual; /**< the largest scaled residual of the slab [kg/m^3] >**/
+  double peak; /**< the largest right hand side of the slab [kg/m^3] >**/
+} grid_block_t;
+
+/**
+   @brief FarFieldGrid resolves the far field concentrations on a
+   structured nx by ny by nz finite volume grid over the x by y by z
+   repository domain.
+
+   The releases of each buffer are added to the cell holding its centroid.
+   Each step advects them along x with the advective velocity and
+   disperses them isotropically with the dispersion coefficient. The step
+   is IMEX. The advection is explicit and first order upwind, sub-cycled
+   to keep the Courant number at or below one. The dispersion is implicit,
+   a backward Euler step solved by Jacobi preconditioned conjugate 
+   gradients, so it is stable for any step and converges in few 
+   iterations even when the dispersion number is large. A step that does 
+   not converge within max_iterations() throws. Mass leaves the domain 
+   only by advection through the downstream x face, where it is tallied as
+   the outflow. Every other face is closed.
+
+   The grid is decomposed into slabs in x, one worker thread per slab, 
+   started with the first transport and kept for the life of the grid. 
+   Between iterations each slab exchanges its boundary planes with its 
+   neighbors' ghost planes, and the threads meet at a barrier. The inner 
+   products are summed plane by plane in x order, so the result does not 
+   depend on the number of slabs.
+ */
+class FarFieldGrid {
+private:
+  /**
+     The constructor for the FarFieldGrid.
+
+     @param x the length of the domain in x [m]
+     @param y the length of the domain in y [m]
+     @param z the length of the domain in z [m]
+     @param nx the number of cells in x
+     @param ny the number of cells in y
+     @param nz the number of cells in z
+     @param v the advective velocity, along x [m/s]
+     @param D the dispersion coefficient [m^2/s]
+     @param n_blocks the number of slabs, and of threads
+   */
+  FarFieldGrid(double x, double y, double z, int nx, int ny, int nz,
+      double v, double D, int n_blocks);
+
+public:
+  /**
+     A constructor for the FarFieldGrid that returns a shared pointer.
+
+     @param x the length of the domain in x [m]
+     @param y the length of the domain in y [m]
+     @param z the length of the domain in z [m]
+     @param nx the number of cells in x
+     @param ny the number of cells in y
+     @param nz the number of cells in z
+     @param v the advective velocity, along x [m/s]
+     @param D the dispersion coefficient [m^2/s]
+     @param n_blocks the number of slabs, and of threads
+    */
+  static FarFieldGridPtr create(double x, double y, double z, int nx, int ny,
+      int nz, double v, double D, int n_blocks){
+    return FarFieldGridPtr(new FarFieldGrid(x, y, z, nx, ny, nz, v, D,
+          n_blocks)); };
+
+  /// The destructor stops the worker threads
+  ~FarFieldGrid();
+
+  /**
+     Adds a release to the cell holding loc. Points outside the domain are
+     added to the nearest cell.
+
+     @param loc the point of the release, such as a buffer centroid [m]
+     @param comp the composition of the release
+     @param kg the mass of the release [kg]
+    */
+  void addRelease(point_t loc, CompMapPtr comp, double kg);
+
+  /**
+     Advects and disperses the contaminants over the timesteps since the
+     last transport.
+
+     @param the_time the timestep to transport to
+    */
+  void transportNuclides(int the_time);
+
+  /**
+     Hands the concentration of every isotope to the EventBuffer for the 
+     farFieldConc table, in each cell where it is at least record_tol() 
+     times that isotope's peak concentration.
+
+     @param the_time the timestep of the rows
+    */
+  void record(int the_time);
+
+  /// returns the isotopes that have been released into the grid
+  std::vector<Iso> isos();
+
+  /// returns the largest concentration of iso in any cell [kg/m^3]
+  Concentration peak(Iso iso);
+
+  /// returns the concentration of iso in the cell holding loc [kg/m^3]
+  Concentration conc(point_t loc, Iso iso);
+
+  /// returns the mass of iso in the grid [kg]
+  double mass(Iso iso);
+
+  /// returns the mass of iso that has left the grid downstream [kg]
+  double outflow(Iso iso);
+
+  /// returns the number of cells in x
+  int nx(){return nx_;};
+
+  /// returns the number of cells in y
+  int ny(){return ny_;};
+
+  /// returns the number of cells in z
+  int nz(){return nz_;};
+
+  /// returns the dispersion coefficient [m^2/s]
+  double dispersion(){return D_;};
+
+  /// returns the number of slabs
+  int n_blocks(){return blocks_.size();};
+
+  /// returns the fraction of the peak below which cells are not recorded
+  double record_tol(){return record_tol_;};
+
+  /// sets the fraction of the peak below which cells are not recorded
+  void set_record_tol(double tol);
+
+  /// the largest number of conjugate gradient iterations per step
+  static int max_iterations(){return 1000;};
+
+  /// the largest scaled residual of a converged step, relative to the peak
+  static double solve_tol(){return 1e-12;};
+
+protected:
+  /// returns the index of cell (i, j, k), x major, so slabs are contiguous
+  int index(int i, int j, int k){return (i*ny_ + j)*nz_ + k;};
+
+  /// returns the index of the cell holding loc
+  int index(point_t loc);
+
+  /**
+     Transports every isotope through one slab, meeting the other slabs'
+     threads at the barrier for each halo exchange and inner product.
+
+     @param b the index of the slab
+     @param dt the length of the step [s]
+     @param sync the barrier shared by the threads of the step
+    */
+  void transportBlock(int b, double dt, boost::barrier& sync);
+
+  /**
+     The loop of a worker thread, which transports slab b each time the 
+     main thread releases start_, until stop_ is set.
+
+     @param b the index of the slab
+    */
+  void work(int b);
+
+  /**
+     Applies the backward Euler dispersion operator to the local field p of
+     slab b, whose ghost planes have been exchanged.
+
+     @param b the index of the slab
+     @param p the local field, with a ghost plane on each side
+     @param q is filled with the operator applied to p
+     @param r the dispersion numbers in x, y and z
+    */
+  void apply(int b, const std::vector<double>& p, std::vector<double>& q, 
+      const double r[3]);
+
+  /**
+     Sums the inner product of a and b over every slab. Each slab sums its 
+     own planes, and the plane sums are added in x order, so the result is 
+     the same however the grid was divided.
+
+     @param b the index of the slab
+     @param a the first local field
+     @param other the second local field
+     @param sums the shared plane sums to fill, one per x plane
+     @param sync the barrier shared by the threads of the step
+    */
+  double dot(int b, const std::vector<double>& a, 
+      const std::vector<double>& other, std::vector<double>& sums, 
+      boost::barrier& sync);
+
+  /**
+     Exchanges the boundary planes of slab b with its neighbors, filling
+     the ghost planes of its local field.
+
+     @param b the index of the slab
+     @param c the local field of the slab, with a ghost plane on each side
+     @param sync the barrier shared by the threads of the step
+    */
+  void exchange(int b, std::vector<double>& c, boost::barrier& sync);
+
+  /// the number of cells in each direction
+  int nx_, ny_, nz_;
+
+  /// the width of a cell in each direction [m]
+  double dx_, dy_, dz_;
+
+  /// the advective velocity, along x [m/s]
+  double v_;
+
+  /// the dispersion coefficient [m^2/s]
+  double D_;
+
+  /// the timestep of the last transport, -1 if there has been none
+  int last_transported_;
+
+  /// the slabs of the decomposition
+  std::vector<grid_block_t> blocks_;
+
+  /// the concentration in each cell, by isotope [kg/m^3]
+  std::map<Iso, std::vector<double> > conc_;
+
+  /// the mass that has left downstream, by isotope [kg]
+  std::map<Iso, double> outflow_;
+
+  /// the fraction of the peak below which cells are not recorded
+  double record_tol_;
+
+  /// the plane sums of the two inner products of an iteration
+  std::vector<double> sums_pq_, sums_rz_;
+
+  /// false if the last step's solve did not converge, set by slab 0 alone
+  bool converged_;
+
+  /// the worker threads, one per slab when there is more than one
+  boost::thread_group workers_;
+
+  /// the barrier shared by the workers within a step
+  boost::shared_ptr<boost::barrier> sync_;
+
+  /// the barriers at which the main thread starts and awaits a step
+  boost::shared_ptr<boost::barrier> start_, done_;
+
+  /// the length of the step the workers are to take [s]
+  double dt_;
+
+  /// true once the workers are to exit
+  bool stop_;
+};
+
+#endif
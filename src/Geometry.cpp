@@ -20,11 +20,17 @@ Geometry::Geometry() {
   point_t origin = {0,0,0}; 
   centroid_ = origin; // by default, the origin is the centroid
   length_ = 0;
+  revision_ = 0;
+  update();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Geometry::Geometry(Radius inner_radius, Radius outer_radius,
     point_t centroid, Length length) {
+  inner_radius_ = 0;
+  outer_radius_ = 0;
+  length_ = 0;
+  revision_ = 0;
   set_radius(INNER, inner_radius); 
   set_radius(OUTER, outer_radius); 
   set_centroid(centroid); 
@@ -64,6 +70,7 @@ void Geometry::set_radius(BoundaryType boundary, Radius radius) {
     default:
       throw CycException("Only INNER or OUTER radii may be set.");
   }
+  update();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -74,6 +81,29 @@ void Geometry::set_centroid(point_t centroid) {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void Geometry::set_length(Length length) { 
   length_=length;
+  update();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void Geometry::update() { 
+  volume_valid_ = true;
+  try {
+    MatTools::validate_finite_pos(outer_radius_);
+  } catch (CycRangeException& e) {
+    volume_valid_ = false;
+  }
+  volume_ = volume_valid_ ? 
+    solid_volume(outer_radius_, length_) - solid_volume(inner_radius_, length_) : 
+    numeric_limits<double>::infinity();
+
+  if(outer_radius_ == numeric_limits<double>::infinity()) { 
+    radial_midpoint_ = numeric_limits<double>::infinity();
+  } else { 
+    radial_midpoint_ = outer_radius_ - (outer_radius_ - inner_radius_)/2;
+  }
+
+  surface_area_ = surface_area(outer_radius_, length_);
+  ++revision_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -99,9 +129,7 @@ const double Geometry::z(){return (centroid()).z_;}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const Volume Geometry::volume(){
-  try {
-    MatTools::validate_finite_pos(outer_radius());
-  } catch (CycRangeException& e) {
+  if( !volume_valid_ ) {
     stringstream msg_ss;
     msg_ss << "To calculate volume the outer radius must be finite.";
     msg_ss << " The value provided was ";
@@ -110,20 +138,12 @@ const Volume Geometry::volume(){
     LOG(LEV_ERROR, "GRGeo") << msg_ss.str();
     throw CycRangeException(msg_ss.str());
   }
-  Volume to_ret = solid_volume( outer_radius(), length() )
-    - solid_volume( inner_radius(), length() );
-  return to_ret;
+  return volume_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const Radius Geometry::radial_midpoint(){
-  Radius to_ret;
-  if(outer_radius_ == numeric_limits<double>::infinity()) { 
-    to_ret = numeric_limits<double>::infinity();
-  } else { 
-    to_ret = outer_radius_ - (outer_radius_ - inner_radius_)/2;
-  }
-  return to_ret;
+  return radial_midpoint_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -134,7 +154,7 @@ Volume Geometry::solid_volume(Radius radius, Length length){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Area Geometry::surface_area(){
-  return surface_area(outer_radius_, length_);
+  return surface_area_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -39,7 +39,11 @@ typedef boost::shared_ptr<Geometry> GeometryPtr;
    @brief The Geometry class stores the cylindrical Component geometry 
 
    The Geometry class holds information about the position, extent, and 
-   structure of the component geometry.
+   structure of the component geometry. The volume, surface area, and radial 
+   midpoint are derived only when the radii or length are set, so that they 
+   may be read cheaply and often. Each such change bumps the revision, by 
+   which the nuclide models know to refresh what they derive from the 
+   geometry.
  */
 class Geometry {
   
@@ -168,6 +172,14 @@ public:
     */
   Area surface_area(Radius radius, Length length);
 
+  /**
+     Returns the revision of the derived quantities, which changes every 
+     time the radii or length are set.
+
+     @return revision_ the revision of this geometry
+    */
+  const int revision() const {return revision_;};
+
 
 protected:
 
@@ -192,6 +204,27 @@ protected:
      numeric_limits<double>::infinity() if infinite
     */
   Length length_;
+
+  /**
+     Recomputes the derived quantities from the radii and length and bumps 
+     the revision.
+    */
+  void update();
+
+  /// the volume of the component [m^3], valid if volume_valid_
+  Volume volume_;
+
+  /// false if the outer radius does not give a finite volume
+  bool volume_valid_;
+
+  /// the surface area of the component [m^2]
+  Area surface_area_;
+
+  /// the radial midpoint of the component [m]
+  Radius radial_midpoint_;
+
+  /// the revision of the derived quantities
+  int revision_;
 };
 
 
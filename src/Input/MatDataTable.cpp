@@ -67,6 +67,12 @@ void MatDataTable::check_validity(Elem ent) {
   }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int MatDataTable::elem_ind(Elem ent) { 
+  map<Elem, int>::const_iterator it = elem_index_.find(ent);
+  return (it == elem_index_.end()) ? 0 : (*it).second;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double MatDataTable::data(Elem ent, ChemDataType data) {
   double to_ret;
@@ -89,8 +95,8 @@ double MatDataTable::data(Elem ent, ChemDataType data) {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double MatDataTable::rel(Elem ent, ChemDataType data) {
   double to_ret;
-  int h = elem_index_[1];
-  int ind = elem_index_[ent];
+  int h = elem_ind(1);
+  int ind = elem_ind(ent);
   switch( data ){
     case DISP : 
       to_ret = elem_vec_[ind].D/elem_vec_[h].D;
@@ -111,7 +117,7 @@ double MatDataTable::rel(Elem ent, ChemDataType data) {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double MatDataTable::ref(ChemDataType data){
   double to_ret;
-  int h = elem_index_[1];
+  int h = elem_ind(1);
   switch( data ){
     case DISP : 
       (initialized_) ?  (to_ret=ref_disp_) : (to_ret=elem_vec_[h].D) ;
@@ -148,6 +148,13 @@ protected:
      @throws CycException when theres some drama
     */
   void check_validity(Elem ent);
+
+  /**
+     Returns the index of an element in elem_vec_, or 0 if it has no row. 
+     Unlike elem_index_[ent], this never modifies the table, so that 
+     concurrent readers may share it.
+    */
+  int elem_ind(Elem ent);
   /**
      The material that this table represents, 
      specifically, the name of the table in the DB
@@ -14,20 +14,26 @@ using namespace std;
 
 MaterialDB* MaterialDB::instance_ = 0;
 int MaterialDB::table_id_ = 0;
+boost::once_flag MaterialDB::instance_flag_ = BOOST_ONCE_INIT;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MaterialDB* MaterialDB::Instance() {
-  // If we haven't created a MaterialDB yet, create it. 
-  // Return it either way
-  if (0 == instance_) {
-    instance_ = new MaterialDB();
-  }
+  // If we haven't created a MaterialDB yet, create it, even if several 
+  // threads ask at once. Return it either way
+  boost::call_once(&MaterialDB::createInstance, instance_flag_);
   return instance_;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::createInstance() {
+  instance_ = new MaterialDB();
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MaterialDB::MaterialDB() :
-  file_path_(Env::getInstallPath() + "/share/mat_data.sqlite") {
+  file_path_(Env::getInstallPath() + "/share/mat_data.sqlite"),
+  db_(file_path_),
+  frozen_(false) {
     disp_ind_map_[0]=0;
     kd_ind_map_[0]=0;
     sol_ind_map_[0]=0;
@@ -58,6 +64,19 @@ double MaterialDB::D(string mat, Elem ent){
 MatDataTablePtr MaterialDB::table(string mat, double ref_disp, double 
     ref_kd, double ref_sol) {
   MatDataTablePtr to_ret;
+  if( frozen_ ) {
+    map<string, MatDataTablePtr>::const_iterator found = 
+      tables_.find(frozenTableID(mat, ref_disp, ref_kd, ref_sol));
+    if( found == tables_.end() ) {
+      string err = "The material table '" + mat + "' was not populated ";
+      err += "before the MaterialDB was frozen.";
+      LOG(LEV_ERROR,"GRMDB") << err;
+      throw CycException(err); 
+    }
+    return (*found).second;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(mutex_);
   string ID = tableID(mat, ref_disp, ref_kd, ref_sol);
 
   if(initialized(ID)) {
@@ -92,6 +111,34 @@ string MaterialDB::tableID(string mat, double ref_disp, double ref_kd,
   return mat+boost::lexical_cast<string>(ref_id);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+string MaterialDB::frozenTableID(string mat, double ref_disp, double ref_kd, 
+    double ref_sol){
+  double refs[] = {ref_disp, ref_kd, ref_sol};
+  const map<double, int>* ref_maps[] = {&disp_ind_map_, &kd_ind_map_, 
+    &sol_ind_map_};
+  int inds[3];
+  for(int i = 0; i < 3; ++i){
+    map<double, int>::const_iterator ind = ref_maps[i]->find(refs[i]);
+    if( ind == ref_maps[i]->end() ) {
+      return "";
+    }
+    inds[i] = (*ind).second;
+  }
+
+  map<int, map<int, map<int, int> > >::const_iterator disp;
+  map<int, map<int, int> >::const_iterator kd;
+  map<int, int>::const_iterator sol;
+  disp = table_id_array_.find(inds[0]);
+  if( disp == table_id_array_.end() ) { return ""; };
+  kd = (*disp).second.find(inds[1]);
+  if( kd == (*disp).second.end() ) { return ""; };
+  sol = (*kd).second.find(inds[2]);
+  if( sol == (*kd).second.end() ) { return ""; };
+
+  return mat+boost::lexical_cast<string>((*sol).second);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int MaterialDB::ref_ind(double ref, ChemDataType data){
   int to_ret;
@@ -133,40 +180,31 @@ bool MaterialDB::initialized(string ID){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MatDataTablePtr MaterialDB::initializeFromSQL(string mat, double ref_disp,
     double ref_kd, double ref_sol) {
-  SqliteDb* db = new SqliteDb(file_path_);
-
-  std::vector<StrList> znums = db->query("SELECT elem FROM "+mat);
-  std::vector<StrList> dnums = db->query("SELECT d FROM "+mat);
-  std::vector<StrList> knums = db->query("SELECT k_d FROM "+mat);
-  std::vector<StrList> snums = db->query("SELECT s FROM "+mat);
+  sqlite3_stmt* stmt = db_.prepare("SELECT elem, d, k_d, s FROM "+mat);
  
   vector<element_t> elem_vec;
   map<Elem, int> elem_index;
-  for (int i = 0; i < znums.size(); i++){
-    // // obtain the database row and declare the appropriate members
-    string zStr = znums.at(i).at(0);
-    string dStr = dnums.at(i).at(0);
-    string kStr = knums.at(i).at(0);
-    string sStr = snums.at(i).at(0);
-    Elem z = atoi( zStr.c_str() );
-    double d = atof( dStr.c_str() );
-    double k = atof( kStr.c_str() );
-    double s = atof( sStr.c_str() );
+  while(db_.step(stmt)){
+    // obtain the database row and declare the appropriate members
+    Elem z = sqlite3_column_int(stmt, 0);
+    double d = sqlite3_column_double(stmt, 1);
+    double k = sqlite3_column_double(stmt, 2);
+    double s = sqlite3_column_double(stmt, 3);
     // create a element member and add it to the element vector
     element_t e = {z, d, k, s};
+    elem_index.insert(make_pair(z, elem_vec.size()));
     elem_vec.push_back(e);
-    // log it accordingly
-    elem_index.insert(make_pair(z, i));
   }
   MatDataTablePtr to_ret = MatDataTablePtr(new MatDataTable(mat, elem_vec, elem_index, 
         ref_disp, ref_kd, ref_sol)); 
-  delete db;
   return to_ret;
 }
 
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MaterialDB::clearTables(){
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  frozen_ = false;
   tables_.clear();
 
   table_id_array_.clear();
@@ -181,3 +219,15 @@ void MaterialDB::clearTables(){
   sol_ind_map_.clear();
   sol_ind_map_[0]=0;
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::freeze(){
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  frozen_ = true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::thaw(){
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  frozen_ = false;
+}
@@ -6,7 +6,9 @@
 #include <string>
 #include <map>
 #include <boost/multi_array.hpp>
-#include "SqliteDb.h"
+#include <boost/thread/once.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include "SqliteReader.h"
 #include "MatDataTable.h"
 
 #define MDB MaterialDB::Instance()
@@ -18,6 +20,19 @@ typedef int Elem;
    @class MaterialDB 
    The MaterialDB class provides an interface to the mat_data.sqlite 
    database, providing a robust and correct mass lookup by isotope 
+
+   The database has two phases. While it is being populated, table() may 
+   read new tables from the database, and each call holds a lock. Once 
+   freeze() is called, the tables and ids form an immutable snapshot. 
+   table() then only reads it, without locking, so any number of threads 
+   may query it at once. Querying a table that was not populated before 
+   the freeze throws.
+
+   The frozen flag is a plain bool, read without a lock. freeze() must 
+   therefore happen-before every concurrent read, as it does when it is 
+   called before the reading threads are created, and thaw() or 
+   clearTables() may only be called once they have been joined. Cyder 
+   freezes both databases at the end of its initModuleMembers.
  */
 class MaterialDB {
 private:
@@ -34,6 +49,12 @@ private:
   /// the current table id
   static int table_id_;
 
+  /// guards the one time creation of instance_
+  static boost::once_flag instance_flag_;
+
+  /// creates instance_, once
+  static void createInstance();
+
 public:
   /** 
      Provides a singleton instance for the MaterialDB.
@@ -139,7 +160,9 @@ public:
 
   /** 
      a function to initialize a large array of element_t structs via the 
-     SQLite/C++ API 
+     SQLite/C++ API. The table is read with a single SELECT elem, d, k_d, s 
+     query on the shared connection, and the element index is built in the 
+     same pass.
 
      @param mat the string indicatin the material this table should represent
    */
@@ -148,8 +171,28 @@ public:
 
   int curr_table_id(){return table_id_;};
 
+  /**
+     Clears the tables and ids, and returns the database to its population 
+     phase.
+   */
   void clearTables();
 
+  /**
+     Ends the population phase. From here on, the tables and ids are an 
+     immutable snapshot that may be read concurrently without locking. 
+     Call this before starting the threads that read them.
+   */
+  void freeze();
+
+  /**
+     Returns to the population phase, keeping the tables populated so far. 
+     No thread may be reading the tables.
+   */
+  void thaw();
+
+  /// Returns true if the tables are a frozen, read-only snapshot
+  bool frozen(){return frozen_;};
+
 protected:
   std::map<int, std::map<int, std::map<int,int> > > table_id_array_;
 
@@ -157,6 +200,24 @@ protected:
   std::map<double, int> kd_ind_map_;
   std::map<double, int> sol_ind_map_;
 
+  /**
+     The read-only connection to the database, shared by all materials
+    */
+  SqliteReader db_;
+
+  /** 
+     Returns the id of an existing table, without adding ids, or an empty 
+     string if the table has no id. This is the read path of a frozen 
+     database.
+   */
+  std::string frozenTableID(std::string mat, double ref_disp, double ref_kd, 
+      double ref_sol);
+
+  /// true once the tables are a frozen, read-only snapshot
+  bool frozen_;
+
+  /// serializes the population of the tables and ids
+  boost::recursive_mutex mutex_;
 
 };
 
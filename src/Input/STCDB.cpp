@@ -1,7 +1,9 @@
 // STCDB class
 
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 #include <stdlib.h>
 
 #include "STCDB.h"
@@ -13,20 +15,26 @@
 using namespace std;
 
 STCDB* STCDB::instance_ = 0;
+boost::once_flag STCDB::instance_flag_ = BOOST_ONCE_INIT;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 STCDB* STCDB::Instance() {
-  // If we haven't created a STCDB yet, create it. 
-  // Return it either way
-  if (0 == instance_) {
-    instance_ = new STCDB();
-  }
+  // If we haven't created a STCDB yet, create it, even if several threads 
+  // ask at once. Return it either way
+  boost::call_once(&STCDB::createInstance, instance_flag_);
   return instance_;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void STCDB::createInstance() {
+  instance_ = new STCDB();
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 STCDB::STCDB() :
-  file_path_(Env::getInstallPath() + "/share/stc_data.sqlite") {
+  file_path_(Env::getInstallPath() + "/share/stc_data.sqlite"),
+  db_(file_path_),
+  frozen_(false) {
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -43,11 +51,26 @@ double STCDB::stc(th_params_t th_params, Iso tope, int the_time){
 STCDataTablePtr STCDB::table(th_params_t th_params) {
   STCDataTablePtr to_ret; 
   string name = mat_name(th_params);
+  if( frozen_ ) {
+    map<string, STCDataTablePtr>::const_iterator found = tables_.find(name);
+    if( found == tables_.end() ) {
+      string err = "The thermal parameters " + name + " were not populated ";
+      err += "before the STCDB was frozen.";
+      LOG(LEV_ERROR, "CydSTC") << err;
+      throw CycException(err);
+    }
+    return (*found).second;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(mutex_);
   if(initialized(mat_name(th_params)) ){
     to_ret = (*tables_.find(name)).second;
-  } else {
+  } else if(tabulated(th_params)){
     to_ret = initializeFromSQL(th_params);
     tables_.insert(make_pair(name,to_ret));
+  } else {
+    to_ret = interpolate(th_params);
+    tables_.insert(make_pair(name,to_ret));
   }
   return to_ret;
 }
@@ -71,143 +94,261 @@ const string STCDB::mat_name(th_params_t th_params) const {
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 STCDataTablePtr STCDB::initializeFromSQL(th_params_t th_params){
-  bool readonly = true;
-  SqliteDb* db = new SqliteDb(file_path_, readonly);
-  boost::multi_array<double, 2> arr = stc_array(db, th_params);
-  string stc_table_id = table_id(db, th_params);
-  STCDataTablePtr to_ret = STCDataTablePtr(new STCDataTable(mat_name(th_params), arr, 
-        iso_index(db, stc_table_id), time_index(db, stc_table_id)));
-  delete db;
+  string stc_table_id = table_id(th_params);
+  map<Iso, int> iso_map;
+  map<int, int> time_map;
+  boost::multi_array<double, 2> arr = stc_array(stc_table_id, iso_map, time_map);
+  STCDataTablePtr to_ret = STCDataTablePtr(new STCDataTable(mat_name(th_params), 
+        arr, iso_map, time_map));
   return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string STCDB::whereClause(th_params_t th_params){
-  string where_clause = "WHERE alpha_th="+ 
-    boost::lexical_cast<string>( th_params.alpha_th ) + 
-    " AND k_th="    + boost::lexical_cast<string>( th_params.k_th ) +
-    " AND spacing=" + boost::lexical_cast<string>( th_params.spacing ) +
-    " AND r_calc="  + boost::lexical_cast<string>( th_params.r_calc );
-  return where_clause;
+vector<double> STCDB::getRange(string column, vector<double>& range){
+  if( frozen_ ) {
+    return range;
+  }
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  if(range.empty()){
+    sqlite3_stmt* stmt = db_.prepare("SELECT DISTINCT " + column + 
+        " FROM STCData ORDER BY " + column);
+    while(db_.step(stmt)){
+      range.push_back(sqlite3_column_double(stmt, 0));
+    }
+  }
+  return range;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const map<Iso, int> STCDB::iso_index(SqliteDb* db, string table_id) const {
+int STCDB::mat_id(th_params_t th_params) {
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  sqlite3_stmt* stmt = db_.prepare("SELECT mat_id FROM STCData WHERE "
+      "alpha_th=? AND k_th=? AND spacing=? AND r_calc=?");
+  sqlite3_bind_double(stmt, 1, th_params.alpha_th);
+  sqlite3_bind_double(stmt, 2, th_params.k_th);
+  sqlite3_bind_double(stmt, 3, th_params.spacing);
+  sqlite3_bind_double(stmt, 4, th_params.r_calc);
+  int to_ret = -1;
+  if( db_.step(stmt) ) {
+    to_ret = sqlite3_column_int(stmt, 0);
+  }
+  return to_ret;
+}
 
-  vector<StrList> inums = db->query("SELECT DISTINCT iso FROM " + table_id);
-  return getIndex(inums);
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool STCDB::tabulated(th_params_t th_params) {
+  return mat_id(th_params) >= 0;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const map<int, int> STCDB::time_index(SqliteDb* db, string table_id) const {
-  vector<StrList> tnums = db->query("SELECT DISTINCT time FROM " + table_id);
-  return getIndex(tnums);
+string STCDB::table_id(th_params_t th_params) {
+  int id = mat_id(th_params);
+  if( id < 0 ) { 
+    stringstream ss("");
+    ss << "The material thermal parameters ";
+    ss << th_params.alpha_th;
+    ss << th_params.k_th;
+    ss << th_params.spacing;
+    ss << th_params.r_calc;
+    ss << " do not yet exist in the database.";
+    LOG(LEV_ERROR, "CydSTC") << ss.str();
+    throw CycException(ss.str()); 
+  }
+  string stc_table_id = "mat" + boost::lexical_cast<string>(id);
+  return stc_table_id;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const map<int, int> STCDB::getIndex(vector<StrList> vals) const {
-  map<int, int> to_ret;
-  for(int i = 0; i < vals.size(); i++){
-    // obtain the database row and declare the appropriate members
-    string vStr = vals.at(i).at(0);
-    int the_val = atoi( vStr.c_str() );
-    // log it accordingly
-    to_ret.insert(make_pair(the_val, i));
+double STCDB::bracket(double val, const vector<double>& range, double& lo, 
+    double& hi) {
+  if( range.empty() ) {
+    string err = "The STCData table has no tabulated parameters.";
+    LOG(LEV_ERROR, "CydSTC") << err;
+    throw CycException(err);
   }
-  return to_ret;
+  vector<double>::const_iterator upper = lower_bound(range.begin(), 
+      range.end(), val);
+  if( upper == range.end() ) {
+    LOG(LEV_WARN, "CydSTC") << "The value " << val << " is above the "
+      << "tabulated range. The largest value, " << range.back() 
+      << ", will be used.";
+    lo = hi = range.back();
+    return 1;
+  } else if( (*upper) == val ) {
+    lo = hi = val;
+    return 1;
+  } else if( upper == range.begin() ) {
+    LOG(LEV_WARN, "CydSTC") << "The value " << val << " is below the "
+      << "tabulated range. The smallest value, " << range.front() 
+      << ", will be used.";
+    lo = hi = range.front();
+    return 1;
+  }
+  hi = (*upper);
+  lo = (*(upper-1));
+  return (val - lo)/(hi - lo);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-vector<double> STCDB::getRange(vector<StrList> vals){
-  vector<double> to_ret;
-  for(int i = 0; i < vals.size(); i++){
-    // obtain the database row and declare the appropriate members
-    string vStr = vals.at(i).at(0);
-    double the_val = atof( vStr.c_str() );
-    // log it accordingly
-    to_ret.push_back(the_val);
+STCWeights STCDB::weights(th_params_t th_params) {
+  double lo[4], hi[4], w_hi[4];
+  w_hi[0] = bracket(th_params.alpha_th, alpha_th_range(), lo[0], hi[0]);
+  w_hi[1] = bracket(th_params.k_th, k_th_range(), lo[1], hi[1]);
+  w_hi[2] = bracket(th_params.spacing, spacing_range(), lo[2], hi[2]);
+  w_hi[3] = bracket(th_params.r_calc, r_calc_range(), lo[3], hi[3]);
+
+  STCWeights to_ret;
+  // each bit of the corner number picks the hi (1) or lo (0) bracket. 
+  // exact and clamped brackets give the lo corners zero weight.
+  for(int corner = 0; corner < 16; ++corner){
+    double val[4];
+    double w = 1;
+    for(int dim = 0; dim < 4; ++dim){
+      bool use_hi = (corner >> dim) & 1;
+      val[dim] = use_hi ? hi[dim] : lo[dim];
+      w *= use_hi ? w_hi[dim] : 1 - w_hi[dim];
+    }
+    if( w > 0 ){
+      th_params_t corner_params;
+      corner_params.a(val[0]).k(val[1]).s(val[2]).r(val[3]);
+      to_ret.push_back(make_pair(corner_params, w));
+    }
   }
   return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string STCDB::table_id(SqliteDb* db, th_params_t th_params) {
-  vector<StrList> mat_id = db->query("SELECT mat_id FROM STCData " + 
-      whereClause(th_params));
-  if( mat_id.empty() ) { 
+STCDataTablePtr STCDB::interpolate(th_params_t th_params) {
+  STCWeights corner_weights = weights(th_params);
+
+  // gather the corner tables that exist, and the union of their indices
+  vector<pair<STCDataTablePtr, double> > corners;
+  map<Iso, int> iso_map;
+  map<int, int> time_map;
+  double w_tot = 0;
+  STCWeights::iterator it;
+  for(it = corner_weights.begin(); it != corner_weights.end(); ++it){
+    if( !tabulated((*it).first) ) {
+      continue;
+    }
+    STCDataTablePtr corner = table((*it).first);
+    corners.push_back(make_pair(corner, (*it).second));
+    w_tot += (*it).second;
+    map<int, int> isos = corner->isoIndex();
+    map<int, int> times = corner->timeIndex();
+    map<int, int>::iterator ind;
+    for(ind = isos.begin(); ind != isos.end(); ++ind){
+      iso_map.insert(make_pair((*ind).first, 0));
+    }
+    for(ind = times.begin(); ind != times.end(); ++ind){
+      time_map.insert(make_pair((*ind).first, 0));
+    }
+  }
+  if( corners.empty() ) {
     stringstream ss("");
-    ss << "The material thermal parameters ";
-    ss << th_params.alpha_th;
-    ss << th_params.k_th;
-    ss << th_params.spacing;
-    ss << th_params.r_calc;
-    ss << " do not yet exist in the database.";
+    ss << "No tabulated thermal parameters surround " << mat_name(th_params);
     LOG(LEV_ERROR, "CydSTC") << ss.str();
     throw CycException(ss.str()); 
   }
-  string stc_table_id = "mat" + mat_id.at(0).at(0);
-  return stc_table_id;
+
+  int ind = 0;
+  map<int, int>::iterator iso;
+  for(iso = iso_map.begin(); iso != iso_map.end(); ++iso){
+    (*iso).second = ind++;
+  }
+  ind = 0;
+  map<int, int>::iterator step;
+  for(step = time_map.begin(); step != time_map.end(); ++step){
+    (*step).second = ind++;
+  }
+
+  boost::multi_array<double, 2> arr(boost::extents[iso_map.size()][time_map.size()]);
+  for(iso = iso_map.begin(); iso != iso_map.end(); ++iso){
+    for(step = time_map.begin(); step != time_map.end(); ++step){
+      double val = 0;
+      for(int c = 0; c < corners.size(); ++c){
+        val += corners[c].second*corners[c].first->stc((*iso).first, (*step).first);
+      }
+      arr[(*iso).second][(*step).second] = val/w_tot;
+    }
+  }
+  return STCDataTablePtr(new STCDataTable(mat_name(th_params), arr, iso_map, 
+        time_map));
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-boost::multi_array<double, 2> STCDB::stc_array(SqliteDb* db, th_params_t th_params){
+boost::multi_array<double, 2> STCDB::stc_array(string stc_table_id, 
+    map<Iso, int>& iso_index, map<int, int>& time_index){
 
-  string stc_table_id = table_id(db, th_params);
-  vector<StrList> inums = db->query("SELECT iso FROM " + stc_table_id); 
-  vector<StrList> snums = db->query("SELECT stc FROM " + stc_table_id); 
-  vector<StrList> tnums = db->query("SELECT time FROM " + stc_table_id); 
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  vector<Iso> topes;
+  vector<int> times;
+  vector<double> stcs;
 
-  map<int,int> time_map = time_index(db, stc_table_id);
-  map<Iso,int> iso_map = iso_index(db, stc_table_id);
-  int n_isos = iso_map.size();
-  int n_timesteps = time_map.size();
+  // read every row once, noting the distinct isotopes and times as we go
+  sqlite3_stmt* stmt = db_.prepare("SELECT iso, time, stc FROM " + stc_table_id); 
+  while(db_.step(stmt)){
+    Iso tope = sqlite3_column_int(stmt, 0);
+    int the_time = sqlite3_column_int(stmt, 1);
+    topes.push_back(tope);
+    times.push_back(the_time);
+    stcs.push_back(sqlite3_column_double(stmt, 2));
+    iso_index.insert(make_pair(tope, 0));
+    time_index.insert(make_pair(the_time, 0));
+  }
 
+  // number the indices in ascending order
+  int ind = 0;
+  map<int, int>::iterator it;
+  for(it = iso_index.begin(); it != iso_index.end(); ++it){
+    (*it).second = ind++;
+  }
+  ind = 0;
+  for(it = time_index.begin(); it != time_index.end(); ++it){
+    (*it).second = ind++;
+  }
+
+  int n_isos = iso_index.size();
+  int n_timesteps = time_index.size();
   boost::multi_array<double, 2> to_ret(boost::extents[n_isos][n_timesteps]);
+  fill(to_ret.data(), to_ret.data() + to_ret.num_elements(), 0.0);
 
-  for (int i = 0; i < inums.size(); i++){
-    // // obtain the database row and declare the appropriate members
-    string iStr = inums.at(i).at(0);
-    string sStr = snums.at(i).at(0);
-    string tStr = tnums.at(i).at(0);
-    Iso tope = atoi( iStr.c_str() );
-    int the_time = atoi( tStr.c_str() );
-    double temp_change = atof( sStr.c_str() );
+  for (int i = 0; i < stcs.size(); i++){
     // determine array indcies and add stc to the stc array
-    to_ret[iso_map[tope]][time_map[the_time]] = temp_change;
+    to_ret[iso_index[topes[i]]][time_index[times[i]]] = stcs[i];
   }
   return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-vector<double> STCDB::k_th_range(SqliteDb* db){
-  if(k_th_range_.empty()){
-    vector<StrList> k_th_list = db->query("SELECT DISTINCT k_th FROM STCData");
-    k_th_range_ = getRange(k_th_list);
-  }
-  return k_th_range_;
+vector<double> STCDB::k_th_range(){
+  return getRange("k_th", k_th_range_);
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-vector<double> STCDB::alpha_th_range(SqliteDb* db){
-  if(alpha_th_range_.empty()){
-    vector<StrList> alpha_th_list = db->query("SELECT DISTINCT alpha_th FROM STCData");
-    alpha_th_range_ = getRange(alpha_th_list);
-  }
-  return alpha_th_range_;
+vector<double> STCDB::alpha_th_range(){
+  return getRange("alpha_th", alpha_th_range_);
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-vector<double> STCDB::spacing_range(SqliteDb* db){
-  if(spacing_range_.empty()){
-    vector<StrList> spacing_list = db->query("SELECT DISTINCT spacing FROM STCData");
-    spacing_range_ = getRange(spacing_list);
-  }
-  return spacing_range_;
+vector<double> STCDB::spacing_range(){
+  return getRange("spacing", spacing_range_);
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-vector<double> STCDB::r_calc_range(SqliteDb* db){
-  if(r_calc_range_.empty()){
-    vector<StrList> r_calc_list = db->query("SELECT DISTINCT r_calc FROM STCData");
-    r_calc_range_ = getRange(r_calc_list);
-  }
-  return r_calc_range_;
+vector<double> STCDB::r_calc_range(){
+  return getRange("r_calc", r_calc_range_);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void STCDB::freeze(){
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  k_th_range();
+  alpha_th_range();
+  spacing_range();
+  r_calc_range();
+  frozen_ = true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void STCDB::thaw(){
+  boost::recursive_mutex::scoped_lock lock(mutex_);
+  frozen_ = false;
+}
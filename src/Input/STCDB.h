@@ -4,16 +4,28 @@
 
 #include <string>
 #include <map>
+#include <boost/thread/once.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
-#include "SqliteDb.h"
+#include "SqliteReader.h"
 #include "STCDataTable.h"
 
 #define SDB STCDB::Instance()
 
+/// the weights of the tabulated parameter sets that surround a th_params_t
+typedef std::vector<std::pair<th_params_t, double> > STCWeights;
+
 /**
    @class STCDB 
    The STCDB class provides an interface to the stc_data.sqlite 
    database, providing a robust and correct mass lookup by isotope 
+
+   Like the MaterialDB, the STCDB is populated under a lock until freeze() 
+   is called. After that, table() and the parameter ranges read an 
+   immutable snapshot without locking. Direct queries of the database, 
+   such as tabulated(), remain serialized on the shared connection. As 
+   in the MaterialDB, freeze() must happen-before every concurrent read, 
+   and thaw() may only follow the join of the reading threads.
  */
 class STCDB {
 private:
@@ -22,6 +34,12 @@ private:
     */
   static STCDB* instance_;
 
+  /// guards the one time creation of instance_
+  static boost::once_flag instance_flag_;
+
+  /// creates instance_, once
+  static void createInstance();
+
   /**
     this database's file path
    */
@@ -60,6 +78,8 @@ public:
 
   /**
      returns the table matching the mat string. 
+     If the parameters are not tabulated in the database, the table is 
+     interpolated from the tabulated parameter sets that surround them.
 
      @param mat a struct indicating the variables in the table 
 
@@ -68,82 +88,94 @@ public:
   STCDataTablePtr table(th_params_t th_params);
 
   /**
-    Converts the th_params struct into a coded name.
+     Returns true if the exact parameters are tabulated in the database.
 
-    @param mat the struct describing a material
+     @param th_params the struct describing a material
     */
-  const std::string mat_name(th_params_t th_params) const;
+  bool tabulated(th_params_t th_params);
 
   /**
-    Finds the name of the table in the database for the mat struct .
-
-    @param db the database to query
-    @param mat the struct describing a material
+     Returns the multilinear interpolation weights for a set of parameters. 
+     Each of alpha_th, k_th, spacing, and r_calc is bracketed by its nearest 
+     tabulated values, and each of the (up to 16) corners of the bracketing 
+     box is weighted by the product of its linear weights. Corners with zero 
+     weight are omitted. Parameters outside the tabulated range are clamped 
+     to the nearest tabulated value.
+
+     @param th_params the struct describing a material
+     @return the tabulated corner parameters and their weights, summing to 1
     */
-  std::string table_id(SqliteDb* db, th_params_t th_params);
+  STCWeights weights(th_params_t th_params);
 
   /**
-     This returns the iso_index_ for a particular db and mat struct.
-     iso_index_ is a map from isotope IDs to indexes in the stc_vec_
+     Creates a table for untabulated parameters by weighting the tables of 
+     the surrounding tabulated parameter sets. Corners that are missing from 
+     the database are dropped and the remaining weights are renormalized.
 
-     @param db the database to query
-     @param table_name the name of the table to query
+     @param th_params the struct describing a material
+     @return a STCDataTablePtr holding the interpolated data
     */
-  const std::map<Iso, int> iso_index(SqliteDb* db, std::string table_name) const;
+  STCDataTablePtr interpolate(th_params_t th_params);
 
   /**
-     This returns the time_index for a particular db and mat struct.
-     time_index is a map from timestep values to indexes in the stc_array
+    Converts the th_params struct into a coded name.
 
-     @param db the database to query
-     @param table_name the name of the table to query
+    @param mat the struct describing a material
     */
-  const std::map<int, int> time_index(SqliteDb* db, std::string table_name) const;
+  const std::string mat_name(th_params_t th_params) const;
 
+  /**
+    Finds the name of the table in the database for the mat struct .
+
+    @param th_params the struct describing a material
+    */
+  std::string table_id(th_params_t th_params);
 
   /** 
      Returns a vector of distinct values of k_th in the db
 
-     @param db the database to look into
      @returns k_th_range_
      */
-  std::vector<double> k_th_range(SqliteDb* db);
+  std::vector<double> k_th_range();
 
   /** 
      Returns a vector of distinct values of alpha_th in the db
 
-     @param db the database to look into
      @returns alpha_th_range_
      */
-  std::vector<double> alpha_th_range(SqliteDb* db);
+  std::vector<double> alpha_th_range();
 
   /** 
      Returns a vector of distinct values of spacing in the db
 
-     @param db the database to look into
      @returns spacing_range_
      */
-  std::vector<double> spacing_range(SqliteDb* db);
+  std::vector<double> spacing_range();
 
   /** 
      Returns a vector of distinct values of r_calc in the db
 
-     @param db the database to look into
      @returns r_calc_range_
      */
-  std::vector<double> r_calc_range(SqliteDb* db);
+  std::vector<double> r_calc_range();
 
   /**
-     This returns the stc_array_ for a particular db and mat struct.
+     This returns the stc_array for a particular table in the db.
      The stc_array holds stc values for specific isotope and time pairs.
      This is the main data in the table and has dimensions n_isos x n_timesteps.
 
-     @param db the database to query
-     @param mat the struct describing the material
+     The table is read with a single SELECT iso, time, stc query. The iso and 
+     time indices are collected during that same pass over the rows, and 
+     are numbered in ascending order of isotope and time.
+
+     @param stc_table_id the name of the table to query, from table_id()
+     @param iso_index is filled with a map from isotope IDs to array rows
+     @param time_index is filled with a map from timestep values to array columns
 
      @return stc_array an array of stc values for specific isotope and time pairs.
     */
-  boost::multi_array<double, 2> stc_array(SqliteDb* db, th_params_t th_params);
+  boost::multi_array<double, 2> stc_array(std::string stc_table_id, 
+      std::map<Iso, int>& iso_index, std::map<int, int>& time_index);
 
   /**
      checks whether a table associated with a particular mat has been created
@@ -161,19 +193,52 @@ public:
   STCDataTablePtr initializeFromSQL(th_params_t th_params);
 
   /**
-     this helper function provides the WHERE clause that selects the mat from the db.
+     Ends the population phase. The parameter ranges are read, and from 
+     here on the tables and ranges are an immutable snapshot that may be 
+     read concurrently without locking. Call this before starting threads.
+   */
+  void freeze();
 
-     @param mat the material properties to specify when querying the table.
-    */
-  std::string whereClause(th_params_t th_params);
+  /// Returns to the population phase. No thread may be reading the tables.
+  void thaw();
+
+  /// Returns true if the tables are a frozen, read-only snapshot
+  bool frozen(){return frozen_;};
 
 protected:
 
-  /// Returns a map from values to indices of the query result
-  const std::map<int, int> getIndex(std::vector<StrList>) const;
+  /**
+     Finds the mat_id of the exact parameters in the STCData table
+
+     @param th_params the struct describing a material
+     @return the mat_id, or -1 if the parameters are not tabulated
+    */
+  int mat_id(th_params_t th_params);
+
+  /**
+     Finds the tabulated values that bracket val.
+
+     @param val the value to bracket
+     @param range the sorted, tabulated values 
+     @param lo is set to the greatest tabulated value not above val
+     @param hi is set to the least tabulated value not below val
+     @return the weight of hi, in [0,1]
+    */
+  double bracket(double val, const std::vector<double>& range, double& lo, 
+      double& hi);
 
-  /// Returns a vector of distinct values of the query result
-  std::vector<double> getRange(std::vector<StrList> vals);
+  /**
+     Returns a vector of the distinct values of a column of the STCData table
+
+     @param column the name of the column (k_th, alpha_th, spacing, r_calc)
+     @param range the cached range to fill if it is empty
+     */
+  std::vector<double> getRange(std::string column, std::vector<double>& range);
+
+  /**
+     The read-only connection to the database, shared by all queries
+    */
+  SqliteReader db_;
 
   /**
      a mat from the names of the tables to the table pointers 
@@ -191,6 +256,12 @@ protected:
 
   /// Returns a vector of distinct values of r_calc in the db
   std::vector<double> r_calc_range_;
+
+  /// true once the tables are a frozen, read-only snapshot
+  bool frozen_;
+
+  /// serializes the population of the tables and the use of db_
+  boost::recursive_mutex mutex_;
 };
 
 #endif
@@ -1,5 +1,6 @@
 // STCDataTable class
 
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 #include <sstream>
@@ -16,7 +17,8 @@ using namespace std;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 STCDataTable::STCDataTable() :
-  name_("")
+  name_(""),
+  slot_origin_(0)
 {
 
 }
@@ -26,30 +28,74 @@ STCDataTable::STCDataTable(string name, boost::multi_array<double, 2> stc_array,
   name_(name),
   stc_array_(stc_array),
   iso_index_(iso_index),
-  time_index_(time_index)
+  time_index_(time_index),
+  slot_origin_(0)
 {
+  indexTimes();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 STCDataTable::~STCDataTable() {
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void STCDataTable::indexTimes(){
+  times_.clear();
+  time_cols_.clear();
+  time_slot_.clear();
+  map<int, int>::const_iterator it;
+  for(it = time_index_.begin(); it != time_index_.end(); ++it){
+    times_.push_back((*it).first);
+    time_cols_.push_back((*it).second);
+  }
+  if( times_.empty() ) {
+    return;
+  }
+  slot_origin_ = min(0, times_.front());
+  time_slot_.resize(times_.back() - slot_origin_ + 1);
+  int pos = 0;
+  for(int t = slot_origin_; t <= times_.back(); ++t){
+    while( times_[pos] < t ) {
+      ++pos;
+    }
+    time_slot_[t - slot_origin_] = pos;
+  }
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double STCDataTable::stc(Iso tope, int the_time){
-  int iso_ind;
-  int time_ind;
-  try {
-    iso_ind = isoToInd(tope);
-  } catch (CycRangeException& cre) {
+  map<Iso, int>::iterator iso_it = iso_index_.find(tope);
+  if( iso_it == iso_index_.end() || times_.empty() ) {
     return 0;
   }
-  try { 
-    time_ind = timeToInd(the_time);
-  } catch (CycRangeException& cre){
-    /// @TODO interpolate between closest times
+  int iso_ind = (*iso_it).second;
+
+  if( the_time > times_.back() ) {
+    // past the end of the table, hold the last value
+    return stc_array_[iso_ind][time_cols_.back()];
+  } else if( the_time < slot_origin_ ) {
+    return 0;
+  }
+  // the first tabulated time that is not less than the_time
+  int upper = time_slot_[the_time - slot_origin_];
+  if( times_[upper] == the_time ) {
+    return stc_array_[iso_ind][time_cols_[upper]];
+  }
+
+  // interpolate linearly between the neighboring times. before the first
+  // tabulated time, the temperature change rises from zero at time zero.
+  int t_hi = times_[upper];
+  double stc_hi = stc_array_[iso_ind][time_cols_[upper]];
+  int t_lo = 0;
+  double stc_lo = 0;
+  if( upper > 0 ) {
+    t_lo = times_[upper - 1];
+    stc_lo = stc_array_[iso_ind][time_cols_[upper - 1]];
+  } else if( the_time < 0 || t_hi <= 0 ) {
     return 0;
   }
-  return stc_array_[isoToInd(tope)][timeToInd(the_time)];
+  double frac = double(the_time - t_lo)/double(t_hi - t_lo);
+  return stc_lo + frac*(stc_hi - stc_lo);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
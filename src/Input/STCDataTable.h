@@ -70,6 +70,11 @@ public:
 
   /**
      get the specific temperature change [K] for an isotope in this material.
+     Times between tabulated timesteps are interpolated linearly. Before the 
+     first timestep the stc rises linearly from zero at time zero, and after 
+     the last timestep the last value is held. Isotopes that are not in the 
+     table have an stc of zero. The neighboring timesteps are found in the 
+     dense time_slot_ index, so the lookup is O(1) in the number of times.
       
      @param tope an identifier of type Iso, which is an int 
      @param the_time, an integer indicating the timestep at which to determine the stc 
@@ -127,8 +132,12 @@ public:
      */
   int indToTime(int ind);
 
-  std::map<int, int>timeIndex(){return time_index_; }
-  std::map<Iso, int>isoIndex(){return iso_index_; }
+  /// returns the map from timestep values to column indices of the stc array
+  const std::map<int, int>& timeIndex() const {return time_index_; }
+  /// returns the map from isotope ids to row indices of the stc array
+  const std::map<Iso, int>& isoIndex() const {return iso_index_; }
+  /// returns the stc array, with dimensions n_isos x n_timesteps
+  const boost::multi_array<double, 2>& stc_array() const {return stc_array_; }
 
 protected:
   /**
@@ -142,6 +151,9 @@ protected:
     */
   void checkValidity(int val, std::map<int, int> index);
 
+  /// fills times_, time_cols_ and time_slot_ from the time_index_
+  void indexTimes();
+
   /**
      The name of the material that this table represents, 
      specifically, the name of the table in the DB
@@ -168,6 +180,22 @@ protected:
      a map for time index lookup in the stc array. 
    */
   std::map<int, int> time_index_;
+
+  /// the tabulated timesteps, in ascending order
+  std::vector<int> times_;
+
+  /// the column of the stc array of each of the times_
+  std::vector<int> time_cols_;
+
+  /**
+     a dense index over every integer time from slot_origin_ to the last 
+     tabulated time, giving the position in times_ of the first tabulated 
+     time that is not less than it
+   */
+  std::vector<int> time_slot_;
+
+  /// the time of the first entry of time_slot_, no later than zero
+  int slot_origin_;
 };
 
 #endif
@@ -0,0 +1,85 @@
+// SqliteReader class
+
+#include <sstream>
+
+#include "SqliteReader.h"
+
+#include "CycException.h"
+#include "Logger.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SqliteReader::SqliteReader(string file_path) :
+  file_path_(file_path),
+  db_(0) {
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SqliteReader::~SqliteReader() {
+  map<string, sqlite3_stmt*>::iterator it;
+  for(it = stmts_.begin(); it != stmts_.end(); ++it){
+    sqlite3_finalize((*it).second);
+  }
+  stmts_.clear();
+  if(db_ != 0){
+    sqlite3_close(db_);
+    db_ = 0;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SqliteReader::open() {
+  if(db_ != 0){
+    return;
+  }
+  if(sqlite3_open_v2(file_path_.c_str(), &db_, SQLITE_OPEN_READONLY, NULL)
+      != SQLITE_OK){
+    string msg = "Unable to open the database at " + file_path_ + ": " + 
+      sqlite3_errmsg(db_);
+    sqlite3_close(db_);
+    db_ = 0;
+    error(msg);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+sqlite3_stmt* SqliteReader::prepare(string sql) {
+  open();
+  sqlite3_stmt* stmt;
+  map<string, sqlite3_stmt*>::iterator found = stmts_.find(sql);
+  if(found != stmts_.end()){
+    stmt = (*found).second;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+  } else {
+    if(sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK){
+      error("Unable to prepare the query '" + sql + "'");
+    }
+    stmts_.insert(make_pair(sql, stmt));
+  }
+  return stmt;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SqliteReader::step(sqlite3_stmt* stmt) {
+  int rc = sqlite3_step(stmt);
+  if(rc == SQLITE_ROW){
+    return true;
+  } else if(rc != SQLITE_DONE){
+    error("Unable to step through the query '" +
+        string(sqlite3_sql(stmt)) + "'");
+  }
+  return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SqliteReader::error(string msg) {
+  stringstream ss("");
+  ss << msg;
+  if(db_ != 0){
+    ss << ": " << sqlite3_errmsg(db_);
+  }
+  LOG(LEV_ERROR, "CydSQL") << ss.str();
+  throw CycException(ss.str());
+}
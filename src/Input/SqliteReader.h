@@ -0,0 +1,85 @@
+// SqliteReader.h
+#if !defined(_SQLITEREADER)
+#define _SQLITEREADER
+
+#include <string>
+#include <map>
+
+#include <sqlite3.h>
+
+/**
+   @class SqliteReader
+   The SqliteReader class holds a single read-only connection to an sqlite
+   database file and a cache of prepared statements on that connection.
+
+   Unlike SqliteDb, which returns every column of every row as a string, the
+   reader hands back prepared statements so that callers may read typed
+   columns (sqlite3_column_int, sqlite3_column_double) row by row in a
+   single pass. The connection is opened lazily on the first prepare() and
+   is shared by all queries made through the reader.
+ */
+class SqliteReader {
+public:
+  /**
+     Constructor for the SqliteReader class.
+     The connection is not opened until the first statement is prepared.
+
+     @param file_path the path to the sqlite database file
+   */
+  SqliteReader(std::string file_path);
+
+  /**
+     Destructor for the SqliteReader class.
+     Finalizes all cached statements and closes the connection.
+   */
+  ~SqliteReader();
+
+  /**
+     Returns a prepared statement for the sql string.
+     Statements are cached by their sql, so a repeated query is only compiled
+     once. The returned statement has been reset and its bindings cleared.
+     It remains owned by the reader and must not be finalized by the caller.
+
+     @param sql the sql query to prepare
+
+     @return the prepared statement, ready for binding and stepping
+   */
+  sqlite3_stmt* prepare(std::string sql);
+
+  /**
+     Advances the statement to its next row.
+
+     @param stmt a statement obtained from prepare()
+
+     @return true if a row is available, false when the query is done
+   */
+  bool step(sqlite3_stmt* stmt);
+
+  /// Returns the path to the database file
+  const std::string file_path() const {return file_path_;};
+
+protected:
+  /// opens the connection if it is not already open
+  void open();
+
+  /// logs and throws a CycException describing the most recent sqlite error
+  void error(std::string msg);
+
+  /// this database's file path
+  std::string file_path_;
+
+  /// the read-only connection, 0 until opened
+  sqlite3* db_;
+
+  /// the prepared statements, keyed by their sql
+  std::map<std::string, sqlite3_stmt*> stmts_;
+
+private:
+  /// the reader owns its connection, so it is not copied
+  SqliteReader(const SqliteReader& other);
+
+  /// the reader owns its connection, so it is not assigned
+  SqliteReader& operator=(const SqliteReader& other);
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*! \file KernelCache.cpp
+    \brief Implements the KernelCache class, which shares the quadrature
+    weights of the OneDimPPMNuclide Green's function among components and
+    threads
+    \author Kathryn D. Huff
+ */
+#include "KernelCache.h"
+
+using namespace std;
+
+KernelCache* KernelCache::instance_ = 0;
+boost::once_flag KernelCache::instance_flag_ = BOOST_ONCE_INIT;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool operator<(const kernel_key_t& a, const kernel_key_t& b){
+  if( a.D != b.D ) { return a.D < b.D; };
+  if( a.v != b.v ) { return a.v < b.v; };
+  if( a.L != b.L ) { return a.L < b.L; };
+  if( a.del_t != b.del_t ) { return a.del_t < b.del_t; };
+  return a.n < b.n;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+KernelCache* KernelCache::Instance() {
+  boost::call_once(&KernelCache::createInstance, instance_flag_);
+  return instance_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KernelCache::createInstance() {
+  instance_ = new KernelCache();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool KernelCache::find(const kernel_key_t& key, kernel_weights_t& weights) {
+  boost::mutex::scoped_lock lock(mutex_);
+  map<kernel_key_t, kernel_weights_t>::const_iterator it = weights_.find(key);
+  if( it == weights_.end() ) {
+    return false;
+  }
+  weights = (*it).second;
+  return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+kernel_weights_t KernelCache::insert(const kernel_key_t& key,
+    const kernel_weights_t& weights) {
+  boost::mutex::scoped_lock lock(mutex_);
+  // insert leaves an existing entry untouched
+  return (*weights_.insert(make_pair(key, weights)).first).second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int KernelCache::size() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return weights_.size();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KernelCache::clear() {
+  boost::mutex::scoped_lock lock(mutex_);
+  weights_.clear();
+}
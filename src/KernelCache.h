@@ -0,0 +1,109 @@
+/*! \file KernelCache.h
+  \brief Declares the KernelCache class, which shares the quadrature weights
+  of the OneDimPPMNuclide Green's function among components and threads
+  \author Kathryn D. Huff
+ */
+#if !defined(_KERNELCACHE_H)
+#define _KERNELCACHE_H
+
+#include <map>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+
+#define KC KernelCache::Instance()
+
+/**
+   The parameters that determine the integrated Green's function of the
+   OneDimPPMNuclide over one component and one transport step.
+ */
+typedef struct kernel_key_t
+{
+  double D; /**< the dispersion coefficient of the element [m^2/s] >**/
+  double v; /**< the advective velocity [m/s] >**/
+  double L; /**< the thickness of the component [m] >**/
+  double del_t; /**< the length of the transport step [s] >**/
+  int n; /**< the number of quadrature nodes >**/
+} kernel_key_t;
+
+/// orders kernel keys lexicographically, for the map of the KernelCache
+bool operator<(const kernel_key_t& a, const kernel_key_t& b);
+
+/**
+   The trapezoidal quadrature of the Green's function A(z) over [0, L].
+   The concentration change at each node is (C_0 - C_i)*A(z), clamped at
+   zero, so a positive difference is weighted by the positive part of A and
+   a negative difference by the negative part.
+ */
+typedef struct kernel_weights_t
+{
+  double pos; /**< the integral of max(A(z), 0) [m] >**/
+  double neg; /**< the integral of min(A(z), 0) [m] >**/
+} kernel_weights_t;
+
+/**
+   @class KernelCache
+   The KernelCache holds the integrated Green's function weights of the
+   OneDimPPMNuclide, keyed by (D, v, L, del_t, n). Every component sharing
+   a material and a step size evaluates the same kernel for each element,
+   so the weights are computed once, by whichever component first needs
+   them, and each later transport step reduces to a product with the
+   concentration difference. Lookups and insertions are locked, so the
+   cache may be shared by components transported in parallel.
+ */
+class KernelCache {
+private:
+  /// the constructor, for Instance() alone
+  KernelCache() {};
+
+  /// a pointer to the KernelCache once it has been created
+  static KernelCache* instance_;
+
+  /// guards the one time creation of instance_
+  static boost::once_flag instance_flag_;
+
+  /// creates instance_, once
+  static void createInstance();
+
+public:
+  /**
+     Provides the singleton KernelCache.
+
+     @return a pointer to the KernelCache
+   */
+  static KernelCache* Instance();
+
+  /**
+     Looks up the weights of a kernel.
+
+     @param key the parameters of the kernel
+     @param weights is set to the weights of the kernel, if they are cached
+     @return true if the weights were cached
+   */
+  bool find(const kernel_key_t& key, kernel_weights_t& weights);
+
+  /**
+     Caches the weights of a kernel. If another thread cached them first,
+     its weights are kept, so every caller uses the same weights.
+
+     @param key the parameters of the kernel
+     @param weights the weights of the kernel
+     @return the cached weights of the kernel
+   */
+  kernel_weights_t insert(const kernel_key_t& key,
+      const kernel_weights_t& weights);
+
+  /// Returns the number of cached kernels
+  int size();
+
+  /// Forgets every cached kernel
+  void clear();
+
+protected:
+  /// the weights of each kernel
+  std::map<kernel_key_t, kernel_weights_t> weights_;
+
+  /// guards weights_
+  boost::mutex mutex_;
+};
+
+#endif
@@ -22,7 +22,9 @@ LumpedNuclide::LumpedNuclide() :
   porosity_(0),
   v_(0),
   t_t_(0),
-  formulation_(LAST_FORMULATION_TYPE) 
+  formulation_(LAST_FORMULATION_TYPE),
+  rtd_time_(0),
+  scales_valid_(false)
 { 
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
@@ -39,7 +41,9 @@ LumpedNuclide::LumpedNuclide(QueryEngine* qe):
   porosity_(0),
   v_(0),
   t_t_(0),
-  formulation_(LAST_FORMULATION_TYPE)
+  formulation_(LAST_FORMULATION_TYPE),
+  rtd_time_(0),
+  scales_valid_(false)
 { 
 
   set_geom(GeometryPtr(new Geometry()));
@@ -59,6 +63,7 @@ LumpedNuclide::~LumpedNuclide(){
 void LumpedNuclide::initModuleMembers(QueryEngine* qe){
   v_ = lexical_cast<double>(qe->getElementContent("advective_velocity"));
   porosity_ = lexical_cast<double>(qe->getElementContent("porosity"));
+  invalidate_volumes();
   t_t_ = lexical_cast<double>(qe->getElementContent("transit_time"));
 
   Pe_=NULL;
@@ -93,6 +98,7 @@ void LumpedNuclide::initModuleMembers(QueryEngine* qe){
       throw CycException(err);
       break;
   }
+  invalidate_rtd();
 
   LOG(LEV_DEBUG2,"GRLNuc") << "The LumpedNuclide Class init(cur)"
     <<" function has been called";;
@@ -109,6 +115,7 @@ NuclideModelPtr LumpedNuclide::copy(const NuclideModel& src){
   set_C_0(IsoConcMap());
   v_=src_ptr->v();
   t_t_=src_ptr->t_t();
+  invalidate_rtd();
 
   // copy the geometry AND the centroid, it should be reset later.
   set_geom(geom_->copy(src_ptr->geom(), src_ptr->geom()->centroid()));
@@ -117,6 +124,8 @@ NuclideModelPtr LumpedNuclide::copy(const NuclideModel& src){
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 
+  invalidate_bc();
+
   return shared_from_this();
 }
 
@@ -133,6 +142,7 @@ void LumpedNuclide::updateNuclideParamsTable(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void LumpedNuclide::update(int the_time){
+  invalidate_bc();
   assert(last_updated() <= the_time);
   update_vec_hist(the_time);
   update_conc_hist(the_time);
@@ -152,6 +162,7 @@ void LumpedNuclide::absorb(mat_rsrc_ptr matToAdd) {
   LOG(LEV_DEBUG2,"GRLNuc") << "LumpedNuclide is absorbing material: ";
   matToAdd->print();
   wastes_.push_back(matToAdd);
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -164,6 +175,7 @@ mat_rsrc_ptr LumpedNuclide::extract(const CompMapPtr comp_to_rem, double
   comp_to_rem->print() ;
   mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, 
         wastes_, 1e-3));
+  invalidate_bc();
   update(last_updated());
   return to_ret;
 }
@@ -284,6 +296,8 @@ void LumpedNuclide::set_Pe(double Pe){
     throw CycRangeException(msg_ss.str());
   } else {
     Pe_ = Pe;
+    invalidate_bc();
+    invalidate_rtd();
   }
   MatTools::validate_finite_pos((Pe));
 }
@@ -303,6 +317,8 @@ void LumpedNuclide::set_porosity(double porosity){
   }
 
   porosity_ = porosity;
+  invalidate_bc();
+  invalidate_volumes();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -311,11 +327,11 @@ double LumpedNuclide::V_ff(){
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double LumpedNuclide::V_f(){
-  return MatTools::V_f(V_T(),porosity());
+  return volumes().V_f;
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double LumpedNuclide::V_s(){
-  return MatTools::V_s(V_T(),porosity());
+  return volumes().V_s;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -323,6 +339,15 @@ double LumpedNuclide::V_T(){
   return geom_->volume();
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+pore_volumes_t LumpedNuclide::calc_volumes(){
+  pore_volumes_t to_ret;
+  to_ret.V_f = MatTools::V_f(V_T(), porosity());
+  to_ret.V_s = MatTools::V_s(V_T(), porosity());
+  to_ret.V_ff = to_ret.V_f;
+  return to_ret;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void LumpedNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> mats){
 
@@ -362,7 +387,16 @@ void LumpedNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> mats){
   } else {
     to_ret[ 92235 ] = 0; 
   }
-  conc_hist_[the_time] = C_t(to_ret, the_time);
+  // the outflow is the breakthrough of the contained concentration, which 
+  // never offers more than remains after an extraction within the step
+  IsoConcMap out = C_rtd(the_time, to_ret);
+  IsoConcMap::iterator iso;
+  for( iso = out.begin(); iso != out.end(); ++iso ) {
+    IsoConcMap::const_iterator held = to_ret.find((*iso).first);
+    (*iso).second = min((*iso).second, 
+        (held == to_ret.end()) ? 0 : (*held).second);
+  }
+  conc_hist_[the_time] = out;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -395,19 +429,49 @@ void LumpedNuclide::update_conc_hist(int the_time){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap LumpedNuclide::C_DM(IsoConcMap C_0, int the_time){
-  double arg = (Pe()/2.0)*(1-pow(1+4*t_t()/Pe(), 0.5));
-  return MatTools::scaleConcMap(C_0, exp(arg));
+  return MatTools::scaleConcMap(C_0, scale(DM));
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap LumpedNuclide::C_EXPM(IsoConcMap C_0, int the_time){
-  double scale = 1.0/(1.0+t_t());
-  return MatTools::scaleConcMap(C_0, scale);
+  return MatTools::scaleConcMap(C_0, scale(EXPM));
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap LumpedNuclide::C_PFM(IsoConcMap C_0, int the_time){
-  double scale = exp(-t_t());
-  return MatTools::scaleConcMap(C_0, scale);
+  return MatTools::scaleConcMap(C_0, scale(PFM));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double LumpedNuclide::scale(FormulationType formulation){
+  if( !scales_valid_ ) {
+    for(int type = 0; type < LAST_FORMULATION_TYPE; type++){
+      scales_[type] = ResidenceTime::gain((FormulationType)type, Pe(), t_t());
+    }
+    scales_valid_ = true;
+  }
+  return scales_[formulation];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+ResidenceTimePtr LumpedNuclide::rtd(){
+  if( !rtd_ ) {
+    rtd_ = ResidenceTime::create(formulation_, Pe(), t_t());
+  }
+  return rtd_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoConcMap LumpedNuclide::C_rtd(int the_time, const IsoConcMap& C_in){
+  if( !rtd_ ) {
+    // a new distribution has seen no inflow before this step
+    rtd_time_ = the_time - 1;
+    rtd_out_ = IsoConcMap();
+  }
+  ResidenceTimePtr kernel = rtd();
+  for( ; rtd_time_ < the_time; ++rtd_time_ ) {
+    rtd_out_ = kernel->step(C_in);
+  }
+  return rtd_out_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -432,7 +496,7 @@ void LumpedNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr>
     C_0[92235] = 0;
   } else {
     for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
-      st = (*daughter)->source_term_bc() ;
+      st = (*daughter)->bc_snapshot().source_term;
       vol = (*daughter)->V_ff();
       vol_sum += vol;
       if(mixed.second == 0){
@@ -442,8 +506,10 @@ void LumpedNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr>
         mixed.second +=st.second;
         mixed.first.mix(st.first,mixed.second/st.second);
       }
-      // @TODO use timestep len
-      absorb(mat_rsrc_ptr(extractIntegratedMass((*daughter), the_time))); 
+      // the mixing extraction is taken for each timestep since the last step
+      for( int step = 0; step < interval(); ++step ){
+        absorb(mat_rsrc_ptr(extractIntegratedMass((*daughter), the_time))); 
+      }
     }
     C_0 = MatTools::comp_to_conc_map(mixed.first.comp(), mixed.second, vol_sum); 
   }
@@ -458,8 +524,9 @@ mat_rsrc_ptr LumpedNuclide::extractIntegratedMass(NuclideModelPtr daughter,
   double len = geom()->length();
   // scalar = 2*pi*l*theta*(r_j-r_i)^2
   double scalar = daughter->V_ff();
-  IsoConcMap c_i_n = daughter->dirichlet_bc();
-  IsoConcMap c_j_n = C_t(C_0(), the_time);
+  IsoConcMap c_i_n = daughter->bc_snapshot().dirichlet_map;
+  // the outflow concentration from C_rtd, as recorded in the conc hist
+  IsoConcMap c_j_n = conc_hist(last_updated());
   // m_j = scalar*(((5c_j_n/6) - (c_i_n)/3) 
   IsoConcMap c_j_scaled = MatTools::scaleConcMap(c_j_n, 5.0*scalar/6.0);
   IsoConcMap c_i_scaled = MatTools::scaleConcMap(c_i_n, 0.5*scalar);
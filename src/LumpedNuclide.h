@@ -12,12 +12,7 @@
 #include <string>
 
 #include "NuclideModel.h"
-
-enum FormulationType{
-  DM, 
-  EXPM, 
-  PFM, 
-  LAST_FORMULATION_TYPE};
+#include "ResidenceTime.h"
 
 /// A shared pointer for the LumpedNuclide object
 class LumpedNuclide;
@@ -199,13 +194,13 @@ public:
   FormulationType enumerateFormulation(std::string formulation);
 
   /// Sets the internal boundary condition
-  void set_C_0(IsoConcMap C_0){C_0_ = C_0;};
+  void set_C_0(IsoConcMap C_0){C_0_ = C_0; invalidate_bc();};
 
   /// Sets the formulation of the concentration relationship
-  void set_formulation(std::string formulation){formulation_ = enumerateFormulation(formulation);};
+  void set_formulation(std::string formulation){set_formulation(enumerateFormulation(formulation));};
 
   /// Sets the formulation of the concentration relationship
-  void set_formulation(FormulationType formulation){formulation_ = formulation;};
+  void set_formulation(FormulationType formulation){formulation_ = formulation; invalidate_rtd();};
 
   /// Sets the porosity_ variable, the percent of the permeable porous medium.
   void set_porosity(double porosity);
@@ -300,7 +295,8 @@ public:
   void update_conc_hist(int the_time);
 
   /** 
-     Updates the available concentration
+     Updates the available concentration, the residence time breakthrough 
+     of the concentration of mats from C_rtd, bounded by that concentration
 
      @param the_time the time at which to update the IsoConcMap
      @param mats the materials that are part of the available concentration
@@ -316,8 +312,37 @@ public:
     */
   IsoConcMap C_t(IsoConcMap C_0, int the_time);
 
+  /**
+     The outflow concentration of this component, the history of its 
+     contained concentration convolved with the residence time distribution 
+     of the formulation. The convolution is advanced once per timestep up to 
+     the_time, holding C_in over the steps not yet taken.
+
+     @param the_time the time at which to find the outflow concentration
+     @param C_in the contained concentration [kg/m^3]
+     @return the outflow concentration at the_time [kg/m^3]
+    */
+  IsoConcMap C_rtd(int the_time, const IsoConcMap& C_in);
+
+  /**
+     Returns the residence time distribution of the formulation, built 
+     once per formulation, Pe, and t_t.
+    */
+  ResidenceTimePtr rtd();
+
+  /**
+     Returns the steady state scale factor of a formulation, computed once 
+     per Pe and t_t.
+
+     @param formulation the formulation whose scale factor to return
+    */
+  double scale(FormulationType formulation);
+
 
 protected:
+  /// Derives the fluid, solid, and free fluid volumes from porosity
+  virtual pore_volumes_t calc_volumes();
+
   /**
     The advective velocity through this component [m/s]
    */
@@ -341,6 +366,24 @@ protected:
   /// the current conc map at the inner boundary
   IsoConcMap C_0_;
 
+  /// forgets the residence time distribution and the scale factors
+  void invalidate_rtd(){rtd_ = ResidenceTimePtr(); scales_valid_ = false;};
+
+  /// the residence time distribution, null until needed
+  ResidenceTimePtr rtd_;
+
+  /// the time up to which rtd_ has convolved the contained concentration
+  int rtd_time_;
+
+  /// the outflow concentration at rtd_time_ [kg/m^3]
+  IsoConcMap rtd_out_;
+
+  /// the steady state scale factor of each formulation
+  double scales_[LAST_FORMULATION_TYPE];
+
+  /// true if scales_ are current with Pe and t_t
+  bool scales_valid_;
+
 };
 
 
@@ -7,6 +7,8 @@
 #include <deque>
 #include <time.h>
 #include <assert.h>
+#include <cmath>
+#include <algorithm>
 
 
 #include "CycException.h"
@@ -160,36 +162,32 @@ pair<CompMapPtr, double> MatTools::conc_to_comp_map(IsoConcMap conc, double vol)
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_f(double V_T, double theta){
-  validate_percent(theta);
-  validate_finite_pos(V_T);
-  return theta*V_T;
+  return V_f<double>(V_T, theta);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_ff(double V_T, double theta, double d){
-  validate_percent(d);
-  return d*V_f(V_T, theta);
+  return V_ff<double>(V_T, theta, d);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_mf(double V_T, double theta, double d){
-  return (V_f(V_T,theta) - V_ff(V_T, theta, d));
+  return V_mf<double>(V_T, theta, d);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_s(double V_T, double theta){
-  return (V_T - V_f(V_T, theta));
+  return V_s<double>(V_T, theta);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_ds(double V_T, double theta, double d){
-  validate_percent(d);
-  return d*V_s(V_T, theta);
+  return V_ds<double>(V_T, theta, d);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MatTools::V_ms(double V_T, double theta, double d){
-  return (V_s(V_T, theta) - V_ds(V_T, theta, d));
+  return V_ms<double>(V_T, theta, d);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -285,3 +283,84 @@ vector<double> MatTools::linspace(double a, double b, int n) {
 }
 
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<double> MatTools::convolve(const vector<double>& a, 
+    const vector<double>& b, int n) {
+  vector<double> to_ret(max(n,0), 0);
+  if( a.empty() || b.empty() || n <= 0 ) {
+    return to_ret;
+  }
+  // only the terms that reach the first n outputs matter
+  int n_a = min(int(a.size()), n);
+  int n_b = min(int(b.size()), n);
+
+  // below this, the direct sum is cheaper than the transforms
+  if( double(n_a)*n_b <= 4096 ) {
+    for(int i = 0; i < n_a; ++i){
+      for(int j = 0; j < n_b && i + j < n; ++j){
+        to_ret[i+j] += a[i]*b[j];
+      }
+    }
+    return to_ret;
+  }
+
+  int size = 1;
+  while( size < n_a + n_b - 1 ) {
+    size *= 2;
+  }
+  vector<complex<double> > fa(size, 0), fb(size, 0);
+  copy(a.begin(), a.begin() + n_a, fa.begin());
+  copy(b.begin(), b.begin() + n_b, fb.begin());
+  fft(fa, false);
+  fft(fb, false);
+  for(int i = 0; i < size; ++i){
+    fa[i] *= fb[i];
+  }
+  fft(fa, true);
+  for(int k = 0; k < n && k < size; ++k){
+    to_ret[k] = fa[k].real();
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::fft(vector<complex<double> >& data, bool inverse) {
+  int n = data.size();
+  if( n & (n-1) ) {
+    std::stringstream ss;
+    ss << "The FFT length " << n << " is not a power of two.";
+    throw CycRangeException(ss.str());
+  }
+  // bit reversal permutation
+  for(int i = 1, j = 0; i < n; ++i){
+    int bit = n >> 1;
+    for(; j & bit; bit >>= 1){
+      j ^= bit;
+    }
+    j ^= bit;
+    if( i < j ) {
+      swap(data[i], data[j]);
+    }
+  }
+  // butterflies
+  for(int len = 2; len <= n; len <<= 1){
+    double ang = 2*M_PI/len*(inverse ? 1 : -1);
+    complex<double> w_len(cos(ang), sin(ang));
+    for(int i = 0; i < n; i += len){
+      complex<double> w(1);
+      for(int j = 0; j < len/2; ++j){
+        complex<double> u = data[i+j];
+        complex<double> v = data[i+j+len/2]*w;
+        data[i+j] = u + v;
+        data[i+j+len/2] = u - v;
+        w *= w_len;
+      }
+    }
+  }
+  if( inverse ) {
+    for(int i = 0; i < n; ++i){
+      data[i] /= double(n);
+    }
+  }
+}
@@ -6,12 +6,14 @@
 #define _MATTOOLS_H
 
 #include <iostream>
+#include <complex>
 #include "Logger.h"
 #include <deque>
 #include <vector>
 #include <map>
 #include <string>
 
+#include "Dual.h"
 #include "IsoVector.h"
 #include "Material.h"
 #define SECSPERMONTH 2629740.0
@@ -56,6 +58,31 @@ typedef double Flux;
   */
 typedef std::map<int, Flux> IsoFluxMap;
 
+/**
+   A running sum with Kahan compensation. Totals that are built up from 
+   many additions and removals keep the precision that KahanSum gives a 
+   vector of values, without keeping the values.
+  */
+typedef struct kahan_sum_t
+{
+  double sum; /**< the running sum >**/
+  double comp; /**< the running compensation for lost low-order bits >**/
+
+  /// the default constructor starts at zero
+  kahan_sum_t() : sum(0), comp(0) {};
+
+  /// adds val, which may be negative, to the sum
+  void add(double val) {
+    double y = val - comp;
+    double t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+  };
+
+  /// returns the sum to zero
+  void clear() { sum = 0; comp = 0; };
+} kahan_sum_t;
+
 
 /** 
    @brief MatTools is a toolkit for manipulating materials. 
@@ -192,6 +219,34 @@ public:
     */
   static double V_ms(double V_T, double theta, double d);
 
+  /**
+    The volumes above, for any scalar type, such as a Dual that carries 
+    the sensitivities of the volumes to the porosity and degradation. The 
+    double versions evaluate these.
+    */
+  template <typename T>
+  static T V_f(T V_T, T theta);
+
+  /// @see V_f(T, T)
+  template <typename T>
+  static T V_ff(T V_T, T theta, T d);
+
+  /// @see V_f(T, T)
+  template <typename T>
+  static T V_mf(T V_T, T theta, T d);
+
+  /// @see V_f(T, T)
+  template <typename T>
+  static T V_s(T V_T, T theta);
+
+  /// @see V_f(T, T)
+  template <typename T>
+  static T V_ds(T V_T, T theta, T d);
+
+  /// @see V_f(T, T)
+  template <typename T>
+  static T V_ms(T V_T, T theta, T d);
+
   /**
      Confirms whether or not the provided value is a percent (0<=per<=1)
 
@@ -257,6 +312,68 @@ public:
 
   /// @TODO add comments
   static std::vector<double> linspace(double a, double b, int n);
+
+  /**
+    Returns the first n terms of the discrete convolution of a and b, 
+    c[k] = sum_j a[j]*b[k-j]. Long series are convolved by FFT in 
+    O(n log n), short ones directly.
+
+    @param a the first series
+    @param b the second series
+    @param n the number of terms to return, zero padded past the full length
+
+    @return the convolution of a and b, of length n
+    */
+  static std::vector<double> convolve(const std::vector<double>& a, 
+      const std::vector<double>& b, int n);
+
+  /**
+    An in place, radix-2 fast Fourier transform. The inverse is normalized.
+
+    @param data the series to transform. Its size must be a power of two.
+    @param inverse true for the inverse transform
+    */
+  static void fft(std::vector<std::complex<double> >& data, bool inverse);
   
 };
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_f(T V_T, T theta){
+  validate_percent(primal(theta));
+  validate_finite_pos(primal(V_T));
+  return theta*V_T;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_ff(T V_T, T theta, T d){
+  validate_percent(primal(d));
+  return d*V_f(V_T, theta);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_mf(T V_T, T theta, T d){
+  return (V_f(V_T,theta) - V_ff(V_T, theta, d));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_s(T V_T, T theta){
+  return (V_T - V_f(V_T, theta));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_ds(T V_T, T theta, T d){
+  validate_percent(primal(d));
+  return d*V_s(V_T, theta);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+T MatTools::V_ms(T V_T, T theta, T d){
+  return (V_s(V_T, theta) - V_ds(V_T, theta, d));
+}
 #endif
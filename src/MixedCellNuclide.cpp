@@ -104,6 +104,8 @@ NuclideModelPtr MixedCellNuclide::copy(const NuclideModel& src){
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 
+  invalidate_bc();
+
   return shared_from_this();
 }
 
@@ -121,6 +123,7 @@ void MixedCellNuclide::updateNuclideParamsTable(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void MixedCellNuclide::update(int the_time) {
+  invalidate_bc();
   update_vec_hist(the_time);
   update_conc_hist(the_time);
   set_last_updated(the_time);
@@ -140,6 +143,7 @@ void MixedCellNuclide::absorb(mat_rsrc_ptr matToAdd)
   LOG(LEV_DEBUG2,"GRDRNuc") << "MixedCellNuclide is absorbing material: ";
   matToAdd->print();
   wastes_.push_back(matToAdd);
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -152,6 +156,7 @@ mat_rsrc_ptr MixedCellNuclide::extract(const CompMapPtr comp_to_rem, double kg_t
   comp_to_rem->print() ;
   mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, 
         wastes_, 1e-8));
+  invalidate_bc();
   update(last_updated());
   return to_ret;
 }
@@ -176,6 +181,7 @@ void MixedCellNuclide::set_deg_rate(double cur_rate){
     throw CycRangeException(msg_ss.str());
   } else {
     deg_rate_ = cur_rate;
+    invalidate_bc();
   }
   assert((cur_rate >=0) && (cur_rate <= 1));
 }
@@ -192,6 +198,8 @@ void MixedCellNuclide::set_porosity(double porosity){
     throw CycRangeException(msg_ss.str());
   } else {
     porosity_ = porosity;
+    invalidate_bc();
+    invalidate_volumes();
   }
   assert((porosity >=0) && (porosity <= 1));
 }
@@ -206,7 +214,6 @@ pair<IsoVector, double> MixedCellNuclide::source_term_bc(){
   //pair<CompMapPtr, double> comp_pair = 
   //  MatTools::conc_to_comp_map(conc_hist(last_degraded()), V_ff());
 
-  int the_time = last_degraded();
   pair<IsoVector, double> sum_pair; 
   sum_pair = MatTools::sum_mats(wastes_);
   CompMapPtr to_ret;
@@ -214,24 +221,20 @@ pair<IsoVector, double> MixedCellNuclide::source_term_bc(){
   double m_tot=0;
 
   if(sum_pair.second > 0 && V_ff()!=0 && geom_->volume() != numeric_limits<double>::infinity()) { 
-    int iso(0);
-    double m_ff(0);
-    double m_aff(0);
     double mass(sum_pair.second);
     CompMapPtr curr_comp = sum_pair.first.comp();
     curr_comp->massify();
-    CompMap::const_iterator it;
-    it=(*curr_comp).begin();
-    while(it != (*curr_comp).end() ) {
-      if( (*it).second >= cyclus::eps_rsrc() ){
-        iso = (*it).first;
-        m_ff = sorb(the_time, iso, (*it).second*mass);
-        m_aff = precipitate(the_time, iso, m_ff);
-        (*to_ret)[iso] = m_aff;
-        m_tot += m_aff;
-      }
-      ++it;
+    // partition the whole inventory at once, element by element
+    elem_inventory_t inv = SolLim::inventory(curr_comp, mass, 
+        cyclus::eps_rsrc());
+    vector<double> K_d, C_sol;
+    elem_limits(inv, K_d, C_sol);
+    vector<double> m_aff = SolLim::partition(inv, K_d, C_sol, V_s(), V_f(), 
+        V_ff(), tot_deg());
+    for(int i = 0; i < inv.isos.size(); ++i){
+      (*to_ret)[inv.isos[i]] = m_aff[i];
     }
+    m_tot = MatTools::KahanSum(m_aff);
   } else {
     (*to_ret)[ 92235 ] = 0; 
   }
@@ -240,6 +243,51 @@ pair<IsoVector, double> MixedCellNuclide::source_term_bc(){
   return make_pair(IsoVector(to_ret), m_tot);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<double> MixedCellNuclide::source_term_sensitivities(vector<Iso>& isos){
+  isos.clear();
+  vector<double> to_ret;
+  pair<IsoVector, double> sum_pair = MatTools::sum_mats(wastes_);
+  if(sum_pair.second > 0 && V_ff()!=0 && geom_->volume() != numeric_limits<double>::infinity()) { 
+    CompMapPtr curr_comp = sum_pair.first.comp();
+    curr_comp->massify();
+    elem_inventory_t inv = SolLim::inventory(curr_comp, sum_pair.second, 
+        cyclus::eps_rsrc());
+    vector<double> K_d, C_sol;
+    elem_limits(inv, K_d, C_sol);
+
+    // seed each parameter, the K_d and C_sol scale with their references
+    int n_elems = inv.elems.size();
+    vector<sens_t> K_d_sens(n_elems), C_sol_sens(n_elems);
+    for(int e = 0; e < n_elems; ++e){
+      K_d_sens[e] = sens_t(K_d[e]);
+      C_sol_sens[e] = sens_t(C_sol[e]);
+      if(kd_limited()){
+        K_d_sens[e].set_d(SENS_REF_KD, mat_table_->rel(inv.elems[e], KD));
+      }
+      if(sol_limited()){
+        C_sol_sens[e].set_d(SENS_REF_SOL, mat_table_->rel(inv.elems[e], SOL));
+      }
+    }
+    sens_t theta = sens_t::seed(porosity(), SENS_POROSITY);
+    sens_t d(tot_deg());
+    d.set_d(SENS_DEG_RATE, (tot_deg() < 1 && deg_rate() > 0) ? tot_deg()/deg_rate() : 0);
+    sens_t V_T_sens(V_T());
+
+    vector<sens_t> m_aff = SolLim::partition(inv, K_d_sens, C_sol_sens, 
+        MatTools::V_s(V_T_sens, theta), MatTools::V_f(V_T_sens, theta), 
+        MatTools::V_ff(V_T_sens, theta, d), d);
+    to_ret.resize(inv.isos.size()*LAST_SENS_PARAM);
+    for(int i = 0; i < inv.isos.size(); ++i){
+      for(int p = 0; p < LAST_SENS_PARAM; ++p){
+        to_ret[i*LAST_SENS_PARAM + p] = m_aff[i].d(p);
+      }
+    }
+    isos.assign(inv.isos.begin(), inv.isos.end());
+  }
+  return to_ret;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap MixedCellNuclide::dirichlet_bc(){
   IsoConcMap c_ff;
@@ -254,7 +302,7 @@ ConcGradMap MixedCellNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
   ConcGradMap to_ret;
 
   IsoConcMap c_int;
-  pair<IsoVector, double> source_term = shared_from_this()->source_term_bc();
+  pair<IsoVector, double> source_term = bc_snapshot().source_term;
   double m_ff = source_term.second;
   c_int = MatTools::comp_to_conc_map(CompMapPtr(source_term.first.comp()), m_ff, V_ff());
   Radius r_int = geom()->radial_midpoint();
@@ -352,7 +400,6 @@ void MixedCellNuclide::update_vec_hist(int the_time){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void MixedCellNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
   std::vector<NuclideModelPtr>::iterator daughter;
-  std::pair<IsoVector, double> source_term;
   pair<CompMapPtr, double> comp_pair;
   CompMapPtr comp_to_ext;
   double kg_to_ext;
@@ -360,11 +407,8 @@ void MixedCellNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     switch (bc_type_) {
       case SOURCE_TERM :
-        source_term = (*daughter)->source_term_bc();
-        if( source_term.second >= 0 ){
-          comp_to_ext = CompMapPtr(source_term.first.comp());
-          kg_to_ext=source_term.second;
-        }
+        absorb_source_term(*daughter);
+        kg_to_ext = 0;
         break;
       case DIRICHLET :
         comp_pair = inner_dirichlet(*daughter);
@@ -390,6 +434,8 @@ void MixedCellNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr
         throw CycException(err.str());
         break;
     }
+    // a flux over a long interval can not take more than the daughter offers
+    kg_to_ext = min(kg_to_ext, (*daughter)->bc_snapshot().source_term.second);
     if(kg_to_ext > 0 ) {
       absorb(mat_rsrc_ptr((*daughter)->extract(comp_to_ext, kg_to_ext)));
     }
@@ -402,8 +448,8 @@ pair<CompMapPtr, double> MixedCellNuclide::inner_neumann(NuclideModelPtr daughte
   ConcGradMap grad_map;
   pair<CompMapPtr, double> comp_pair;
   //flux area perpendicular to flow, timeps porosit, times D.
-  double int_factor =2*porosity()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
-  grad_map = daughter->neumann_bc(dirichlet_bc(), geom()->radial_midpoint());
+  double int_factor =2*interval()*porosity()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
+  grad_map = daughter->neumann_bc(bc_snapshot().dirichlet_map, geom()->radial_midpoint());
   conc_map = MatTools::scaleConcMap(grad_map, tot_deg()*int_factor);
   IsoConcMap disp_map;
   int iso;
@@ -423,8 +469,8 @@ pair<CompMapPtr, double> MixedCellNuclide::inner_dirichlet(NuclideModelPtr daugh
   IsoConcMap conc_map;
   pair<CompMapPtr, double> comp_pair;
   //flux area perpendicular to flow, times porosity, times v.
-  double int_factor =2*v()*porosity()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
-  conc_map = MatTools::scaleConcMap(daughter->dirichlet_bc(), tot_deg()*int_factor);
+  double int_factor =2*interval()*v()*porosity()*(daughter->geom()->length())*(daughter->geom()->outer_radius());;
+  conc_map = MatTools::scaleConcMap(daughter->bc_snapshot().dirichlet_map, tot_deg()*int_factor);
   IsoConcMap::iterator it;
   for(it=conc_map.begin(); it!=conc_map.end(); ++it) {
     if((*it).second < 0.0){
@@ -467,21 +513,46 @@ double MixedCellNuclide::precipitate(int the_time, int iso, double m_ff){
   return m_aff; 
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MixedCellNuclide::elem_limits(const elem_inventory_t& inv, 
+    vector<double>& K_d, vector<double>& C_sol){
+  int n = inv.elems.size();
+  K_d.assign(n, 0);
+  C_sol.assign(n, numeric_limits<double>::infinity());
+  for(int e = 0; e < n; ++e){
+    if(kd_limited()){
+      K_d[e] = mat_table_->K_d(inv.elems[e]);
+    }
+    if(sol_limited()){
+      C_sol[e] = mat_table_->S(inv.elems[e]);
+    }
+  }
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MixedCellNuclide::V_f(){
-  return MatTools::V_f(V_T(),porosity());
+  return volumes().V_f;
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MixedCellNuclide::V_s(){
-  return MatTools::V_s(V_T(),porosity());
+  return volumes().V_s;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MixedCellNuclide::V_ff(){
-  return MatTools::V_ff(V_T(),porosity(), tot_deg());
+  return volumes().V_ff;
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double MixedCellNuclide::V_T(){
   return geom_->volume();
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+pore_volumes_t MixedCellNuclide::calc_volumes(){
+  pore_volumes_t to_ret;
+  to_ret.V_f = MatTools::V_f(V_T(), porosity());
+  to_ret.V_s = MatTools::V_s(V_T(), porosity());
+  to_ret.V_ff = MatTools::V_ff(V_T(), porosity(), tot_deg());
+  return to_ret;
+}
+
@@ -13,6 +13,7 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "SolLim.h"
 
 /// A shared pointer for the MixedCellNuclide object
 class MixedCellNuclide;
@@ -296,11 +297,36 @@ public:
      */
   double precipitate(int time, int iso, double mass);
 
+  /**
+     Fills the sorption and solubility limits of each element in an 
+     inventory. Unlimited elements have a K_d of zero and an infinite C_sol.
+
+     @param inv the inventory, grouped by element
+     @param K_d the distribution coefficient of each element [m^3/kg], filled
+     @param C_sol the solubility limit of each element [kg/m^3], filled
+     */
+  void elem_limits(const elem_inventory_t& inv, std::vector<double>& K_d, 
+      std::vector<double>& C_sol);
+
+  /**
+     returns the instantaneous partial derivatives of the source term bc 
+     with respect to the porosity, degradation rate, reference K_d and 
+     reference solubility, from a single Dual evaluation of the partition. The degradation rate 
+     is taken to have been constant, so that d(tot_deg)/d(deg_rate) is 
+     tot_deg/deg_rate until the component has fully degraded.
+
+     @param isos is filled with the isotopes of the source term
+     @return the derivative of the mass of each of isos with respect to 
+     each SensParam, those of isotope i at [i*LAST_SENS_PARAM, 
+     (i+1)*LAST_SENS_PARAM)
+   */
+  virtual std::vector<double> source_term_sensitivities(std::vector<Iso>& isos);
+
   /// returns the total degradation of the component
   const double tot_deg() const {return tot_deg_;};
 
   /// sets the total degradation of the component
-  void set_tot_deg(double tot_deg){tot_deg_=tot_deg;};
+  void set_tot_deg(double tot_deg){tot_deg_=tot_deg; invalidate_bc(); invalidate_volumes();};
 
   /**
     Set the porosity (a fraction) of the material of this component. [%] 
@@ -315,7 +341,7 @@ public:
   /**
     Set the advective velocity v_ through this component. [m/s] 
    */
-  void set_v(double v){v_ = v;};
+  void set_v(double v){v_ = v; invalidate_bc();};
 
   /**
     The advective velocity through this component. [m/s] 
@@ -333,13 +359,13 @@ public:
   const int last_degraded() const {return last_degraded_;};
 
   /// Sets boolean indicating whether to incorporate solubility limits
-  void set_sol_limited(bool sol_limited){sol_limited_=sol_limited;}; 
+  void set_sol_limited(bool sol_limited){sol_limited_=sol_limited; invalidate_bc();}; 
 
   /// Gets boolean indicating whether to incorporate solubility limits
   const bool sol_limited() const {return sol_limited_;};
 
   /// Sets boolean indicating whether to incorporate sorption
-  void set_kd_limited(bool kd_limited){kd_limited_=kd_limited;}; 
+  void set_kd_limited(bool kd_limited){kd_limited_=kd_limited; invalidate_bc();}; 
 
   /// Gets boolean indicating whether to incorporate sorption
   const bool kd_limited() const {return kd_limited_;};
@@ -363,6 +389,9 @@ public:
   void set_bc_type(BCType bc_type){bc_type_ = bc_type;}
 
 protected:
+  /// Derives the fluid, solid, and free fluid volumes from porosity and degradation
+  virtual pore_volumes_t calc_volumes();
+
   /**
     The advective velocity through this component [m/s]
    */
@@ -5,9 +5,13 @@
 #if !defined(_NUCLIDEMODEL_H)
 #define _NUCLIDEMODEL_H
 
+#include <algorithm>
+#include <cmath>
 #include <deque>
+#include <vector>
 #include <boost/any.hpp>
 
+#include "EventBuffer.h"
 #include "EventManager.h"
 #include "Geometry.h"
 #include "Material.h"
@@ -35,6 +39,23 @@ enum BCType {
   SOURCE_TERM,
   LAST_BC_TYPE};
 
+/**
+   enumerated list of the parameters that source term sensitivities are 
+   taken with respect to
+ */
+enum SensParam { 
+  SENS_POROSITY,
+  SENS_DEG_RATE,
+  SENS_REF_KD,
+  SENS_REF_SOL,
+  LAST_SENS_PARAM};
+
+/**
+   type definition for a scalar carrying its derivatives with respect to 
+   each SensParam
+ */
+typedef Dual<LAST_SENS_PARAM> sens_t;
+
 /** 
    type definition for a map from times to IsoConcMap
    The keys are timesteps, in the unit of the timesteps in the simulation.
@@ -50,6 +71,36 @@ typedef std::map<int, IsoConcMap> ConcHist;
   */
 typedef std::map<int, std::pair<IsoVector, double> > VecHist;
 
+/**
+   A snapshot of the boundary conditions that a NuclideModel offers its 
+   parent at one step. The isotopes are sorted and the arrays that follow 
+   them are aligned with them, so a single isotope is found by bisection. 
+ */
+typedef struct BCSnapshot
+{
+  std::pair<IsoVector, double> source_term; /**< the source term bc >**/
+  IsoConcMap dirichlet_map; /**< the dirichlet bc [kg/m^3] >**/
+  std::vector<Iso> isos; /**< the isotopes in the source term or dirichlet bc >**/
+  std::vector<double> source_term_kg; /**< the source term of each iso [kg] >**/
+  std::vector<Concentration> dirichlet; /**< the dirichlet bc of each iso [kg/m^3] >**/
+  IsoConcMap c_ext; /**< the external concentration of the neumann and cauchy bcs >**/
+  Radius r_ext; /**< the external radius of the neumann and cauchy bcs >**/
+  std::vector<Iso> ext_isos; /**< the isotopes in the neumann or cauchy bc >**/
+  std::vector<ConcGrad> neumann; /**< the neumann bc of each ext_iso [kg/m^4] >**/
+  std::vector<Flux> cauchy; /**< the cauchy bc of each ext_iso [kg/m^2/s] >**/
+} BCSnapshot;
+
+/**
+   The pore volumes of a NuclideModel, derived from the volume of its 
+   geometry and its porosity and degradation.
+ */
+typedef struct pore_volumes_t
+{
+  double V_f; /**< the fluid volume [m^3] >**/
+  double V_s; /**< the solid volume [m^3] >**/
+  double V_ff; /**< the free fluid volume [m^3] >**/
+} pore_volumes_t;
+
 /// A shared pointer for the abstract NuclideModel class
 class NuclideModel;
 typedef boost::shared_ptr<NuclideModel> NuclideModelPtr;
@@ -65,6 +116,15 @@ typedef boost::shared_ptr<NuclideModel> NuclideModelPtr;
 class NuclideModel : public boost::enable_shared_from_this<NuclideModel> {
 
 public:
+  /**
+     The default constructor. No boundary condition snapshot is held yet.
+    */
+  NuclideModel() : params_id_(-1), step_size_(1), last_transported_(-1), 
+    interval_(1), adaptive_(false), step_tol_(0), max_step_size_(1), 
+    last_mass_(0), sensitivities_(false), bc_valid_(false), bc_ext_valid_(false), 
+    bc_geom_(NULL), bc_rev_(-1), vol_valid_(false), vol_geom_(NULL), 
+    vol_rev_(-1) {};
+
   /**
      A virtual destructor
     */
@@ -125,6 +185,152 @@ public:
    */
   virtual void transportNuclides(int time) = 0 ;
 
+  /// Returns the number of timesteps between transport steps of this model
+  int step_size(){return step_size_;};
+
+  /**
+     Sets the number of timesteps between transport steps of this model. 
+     A slow model, such as the far field, advances only every step_size 
+     timesteps. In between, its daughters hold the nuclides they release, 
+     which it extracts all at once when it next advances.
+
+     @param step_size the timesteps between transport steps, at least 1
+   */
+  void set_step_size(int step_size){
+    if( step_size < 1 ) {
+      std::stringstream msg_ss;
+      msg_ss << "The NuclideModel step size must be at least one timestep.";
+      msg_ss << " The value provided was " << step_size << ".";
+      LOG(LEV_ERROR, "GRDRNuc") << msg_ss.str();;
+      throw CycRangeException(msg_ss.str());
+    }
+    step_size_ = step_size;
+  };
+
+  /**
+     Returns true if this model advances at the_time. All models with the 
+     same step size advance together, at multiples of the step size.
+
+     @param the_time the current timestep
+   */
+  bool transport_due(int the_time){
+    if( adaptive_ ) {
+      return last_transported_ < 0 || the_time - last_transported_ >= step_size_;
+    }
+    return the_time % step_size_ == 0;
+  };
+
+  /**
+     Marks the start of a transport step at the_time, so that interval() 
+     returns the timesteps since the last one. The first step covers a 
+     whole step size, and its mass change is measured from the inventory 
+     the model holds when it starts.
+
+     @param the_time the current timestep
+   */
+  void start_transport(int the_time){
+    if( last_transported_ < 0 ) {
+      interval_ = step_size_;
+      last_mass_ = MatTools::sum_mats(wastes_).second;
+    } else {
+      interval_ = the_time - last_transported_;
+    }
+    last_transported_ = the_time;
+  };
+
+  /// Returns the timesteps covered by the current transport step
+  int interval(){return interval_;};
+
+  /**
+     Puts this model in adaptive stepping mode. The relative change in the
+     contained mass over a transport step serves as its error estimate. 
+     After a step whose change exceeds tol, the step size is halved, and 
+     after one whose change is below tol/4, it is doubled, up to 
+     max_step_size. The histories are still reported at whatever times 
+     they are requested, through update().
+
+     @param tol the largest relative mass change per step [-]
+     @param max_step_size the largest step size, in timesteps
+   */
+  void set_adaptive(double tol, int max_step_size){
+    MatTools::validate_finite_pos(tol);
+    MatTools::validate_nonzero(tol);
+    set_step_size(std::min(step_size_, max_step_size));
+    adaptive_ = true;
+    step_tol_ = tol;
+    max_step_size_ = max_step_size;
+  };
+
+  /// Returns true if the step size adapts to the mass change
+  bool adaptive(){return adaptive_;};
+
+  /// Returns the largest relative mass change per adaptive step
+  double step_tol(){return step_tol_;};
+
+  /// Returns the largest adaptive step size, in timesteps
+  int max_step_size(){return max_step_size_;};
+
+  /**
+     Adapts the step size to the mass change over the transport step just 
+     taken. Does nothing unless the model is adaptive.
+   */
+  void end_transport(){
+    if( !adaptive_ ) {
+      return;
+    }
+    double mass = MatTools::sum_mats(wastes_).second;
+    double ref = std::max(mass, last_mass_);
+    double change = (ref > 0) ? fabs(mass - last_mass_)/ref : 0;
+    if( change > step_tol_ ) {
+      step_size_ = std::max(1, step_size_/2);
+    } else if( change < step_tol_/4 ) {
+      step_size_ = std::min(max_step_size_, 2*step_size_);
+    }
+    last_mass_ = mass;
+  };
+
+  /**
+     Returns true if an adaptive model should step early, because its 
+     daughters offer more than twice the tolerated mass change since its 
+     last step, as when a waste package fails. The step size then falls 
+     back to a single timestep, to resolve the event. A model that held no 
+     mass after its last step is not refined, since any release would 
+     exceed its tolerance and pin it to single steps. end_transport() 
+     shrinks its step instead, once the release arrives.
+
+     @param kg_released the mass the daughters offer at the source term bc
+   */
+  bool refine(double kg_released){
+    if( !adaptive_ || last_transported_ < 0 || last_mass_ <= 0 ) {
+      return false;
+    }
+    if( kg_released > 2*step_tol_*last_mass_ && kg_released > 0 ) {
+      step_size_ = 1;
+      return true;
+    }
+    return false;
+  };
+
+  /**
+     Absorbs the source term of a daughter into this model. The source term 
+     is partition limited, so it offers only one timestep's release. It is 
+     therefore taken once for each timestep of the current transport step, 
+     or until the daughter offers no more.
+
+     @param daughter the nuclide model of an internal component
+   */
+  void absorb_source_term(NuclideModelPtr daughter){
+    for( int step = 0; step < interval_; ++step ){
+      std::pair<IsoVector, double> source_term = 
+        daughter->bc_snapshot().source_term;
+      if( source_term.second <= 0 ){
+        break;
+      }
+      absorb(daughter->extract(CompMapPtr(source_term.first.comp()), 
+            source_term.second));
+    }
+  };
+
   /** 
      returns the NuclideModelType of the model
    */
@@ -150,6 +356,37 @@ public:
    */
   virtual std::pair<IsoVector, double> source_term_bc()=0;
 
+  /**
+     returns the instantaneous partial derivatives of the source term bc 
+     with respect to each SensParam, holding the contained inventory fixed. 
+     They are not propagated through time, so they omit how a parameter 
+     has shaped the inventory itself, and they are recorded as such in the 
+     sourceTermPartials table. Models that are not templated on the scalar 
+     type, such as LumpedNuclide and OneDimPPMNuclide, return nothing.
+
+     @param isos is filled with the isotopes of the source term
+     @return the derivative of the mass of each of isos with respect to 
+     each parameter, those of isotope i at [i*LAST_SENS_PARAM, 
+     (i+1)*LAST_SENS_PARAM) [kg/unit of the parameter]
+   */
+  virtual std::vector<double> source_term_sensitivities(std::vector<Iso>& isos){
+    isos.clear();
+    return std::vector<double>();
+  };
+
+  /// returns the name of a SensParam, as in the NuclideModelParams table
+  static std::string sens_param_name(SensParam param){
+    static const char* names[LAST_SENS_PARAM] = {"porosity", "degradation", 
+      "ref_kd", "ref_sol"};
+    return names[param];
+  };
+
+  /// true if the source term sensitivities should be recorded
+  bool sensitivities(){return sensitivities_;};
+
+  /// sets whether the source term sensitivities should be recorded
+  void set_sensitivities(bool sensitivities){sensitivities_ = sensitivities;};
+
   /**
      returns the prescribed concentration at the boundary, the source term bc
      in kg
@@ -158,9 +395,8 @@ public:
      @return C the concentration at the boundary in kg/m^3
    */
   virtual double source_term_bc(Iso tope) { 
-    IsoVector st=shared_from_this()->source_term_bc().first;
-    double massfrac = st.massFraction(tope);
-    return( (massfrac == 0) ? massfrac*shared_from_this()->source_term_bc().second : 0);
+    const BCSnapshot& bc = bc_snapshot();
+    return bc_lookup(bc.isos, bc.source_term_kg, tope);
   };
 
   /**
@@ -180,9 +416,8 @@ public:
      @return C the concentration at the boundary in kg/m^3
    */
   virtual Concentration dirichlet_bc(Iso tope) { 
-    IsoConcMap  dirichlet = shared_from_this()->dirichlet_bc();
-    IsoConcMap::iterator found = dirichlet.find(tope);
-    return(found != dirichlet.end() ? (*found).second : 0);
+    const BCSnapshot& bc = bc_snapshot();
+    return bc_lookup(bc.isos, bc.dirichlet, tope);
   };
   
   /**
@@ -203,22 +438,40 @@ public:
   virtual void updateNuclideParamsTable() = 0;
 
   /**
-     adds a row to the NuclideModelParams table.
+     Records the parameters of this model in the NuclideModelParams table, 
+     unless they have already been recorded. A model copied from a 
+     prototype shares the prototype's params_id and writes no rows of its 
+     own, since the parameters it copied are identical.
+    */
+  void recordNuclideParams(){
+    if( params_id_ < 0 ) {
+      updateNuclideParamsTable();
+      params_id_ = comp_id_;
+    }
+  };
+
+  /**
+     Returns the component id under which the parameters of this model were 
+     recorded, -1 if they have not been.
+    */
+  const int params_id() const {return params_id_;};
+
+  /// Sets the component id under which the parameters were recorded
+  void set_params_id(int id){params_id_ = id;};
+
+  /**
+     adds a row to the NuclideModelParams table, through the calling 
+     thread's EventBuffer.
 
      @param the name of the variable to record
      @param the variable value, to be cast with boost::any_cast
      */
   virtual void addRowToNuclideParamsTable(std::string param_name, boost::any param_val){
-    event_ptr ev = EM->newEvent("NuclideModelParams")
-      ->addVal("CompID", comp_id_)
-      ->addVal("ParamName", param_name);
     if( param_val.type() == typeid(double)) {
-      ev->addVal("ParamVal", boost::any_cast<double>(param_val));
+      EB->addParam(comp_id_, param_name, boost::any_cast<double>(param_val));
     } else { 
       throw CycException("The NuclideModelParams table needs double type param values");
     }
-
-    ev->record();
   };
 
   /**
@@ -230,9 +483,8 @@ public:
      @return dCdx the concentration gradient at the boundary in kg/m^3
    */
   virtual ConcGrad neumann_bc( IsoConcMap c_ext, Radius r_ext, Iso tope) {
-    IsoConcMap neumann = shared_from_this()->neumann_bc(c_ext, r_ext);
-    IsoConcMap::iterator found = neumann.find(tope);
-    return((found != neumann.end()) ? (*found).second : 0);
+    const BCSnapshot& bc = bc_snapshot(c_ext, r_ext);
+    return bc_lookup(bc.ext_isos, bc.neumann, tope);
   };
 
   /**
@@ -242,9 +494,123 @@ public:
    */
   virtual IsoFluxMap cauchy_bc(IsoConcMap c_ext, Radius r_ext) = 0;
   Flux cauchy_bc(IsoConcMap c_ext, Radius r_ext, Iso tope) {
-    IsoConcMap cauchy = shared_from_this()->cauchy_bc(c_ext,r_ext);
-    IsoConcMap::iterator found = cauchy.find(tope);
-    return(found != cauchy.end() ? (*found).second : 0);
+    const BCSnapshot& bc = bc_snapshot(c_ext, r_ext);
+    return bc_lookup(bc.ext_isos, bc.cauchy, tope);
+  };
+
+  /**
+     Returns the snapshot of the source term and dirichlet boundary 
+     conditions, computing them once if the snapshot has been invalidated 
+     or the geometry has been changed since it was taken. Parents querying this component within a step should read from here 
+     rather than recomputing the boundary conditions.
+
+     @return the snapshot of the boundary conditions
+   */
+  const BCSnapshot& bc_snapshot() {
+    Geometry* geom = geom_.get();
+    int rev = (geom == NULL) ? -1 : geom->revision();
+    if( !bc_valid_ || bc_geom_ != geom || bc_rev_ != rev ) {
+      NuclideModelPtr self = shared_from_this();
+      bc_snapshot_.source_term = self->source_term_bc();
+      bc_snapshot_.dirichlet_map = self->dirichlet_bc();
+
+      // the union of the isotopes, in order
+      std::map<Iso, std::pair<double, Concentration> > merged;
+      double kg = bc_snapshot_.source_term.second;
+      CompMapPtr comp = bc_snapshot_.source_term.first.comp();
+      if( comp ) {
+        CompMap::const_iterator c;
+        for(c = comp->begin(); c != comp->end(); ++c){
+          merged[(*c).first].first = 
+            bc_snapshot_.source_term.first.massFraction((*c).first)*kg;
+        }
+      }
+      IsoConcMap::const_iterator it;
+      for(it = bc_snapshot_.dirichlet_map.begin(); 
+          it != bc_snapshot_.dirichlet_map.end(); ++it){
+        merged[(*it).first].second = (*it).second;
+      }
+      bc_snapshot_.isos.clear();
+      bc_snapshot_.source_term_kg.clear();
+      bc_snapshot_.dirichlet.clear();
+      std::map<Iso, std::pair<double, Concentration> >::const_iterator m;
+      for(m = merged.begin(); m != merged.end(); ++m){
+        bc_snapshot_.isos.push_back((*m).first);
+        bc_snapshot_.source_term_kg.push_back((*m).second.first);
+        bc_snapshot_.dirichlet.push_back((*m).second.second);
+      }
+      bc_valid_ = true;
+      bc_ext_valid_ = false;
+      bc_geom_ = geom;
+      bc_rev_ = rev;
+    }
+    return bc_snapshot_;
+  };
+
+  /**
+     Returns the snapshot of the boundary conditions, including the neumann 
+     and cauchy boundary conditions for the external concentration c_ext at 
+     r_ext. These are recomputed only if c_ext or r_ext differ from the 
+     last query, or the snapshot has been invalidated.
+
+     @param c_ext the external concentration in the parent component
+     @param r_ext the radius in the parent component corresponding to c_ext
+     @return the snapshot of the boundary conditions
+   */
+  const BCSnapshot& bc_snapshot(IsoConcMap c_ext, Radius r_ext) {
+    bc_snapshot();
+    if( !bc_ext_valid_ || r_ext != bc_snapshot_.r_ext || 
+        c_ext != bc_snapshot_.c_ext ) {
+      NuclideModelPtr self = shared_from_this();
+      ConcGradMap neumann = self->neumann_bc(c_ext, r_ext);
+      IsoFluxMap cauchy = self->cauchy_bc(c_ext, r_ext);
+
+      std::map<Iso, std::pair<ConcGrad, Flux> > merged;
+      ConcGradMap::const_iterator it;
+      for(it = neumann.begin(); it != neumann.end(); ++it){
+        merged[(*it).first].first = (*it).second;
+      }
+      for(it = cauchy.begin(); it != cauchy.end(); ++it){
+        merged[(*it).first].second = (*it).second;
+      }
+      bc_snapshot_.c_ext = c_ext;
+      bc_snapshot_.r_ext = r_ext;
+      bc_snapshot_.ext_isos.clear();
+      bc_snapshot_.neumann.clear();
+      bc_snapshot_.cauchy.clear();
+      std::map<Iso, std::pair<ConcGrad, Flux> >::const_iterator m;
+      for(m = merged.begin(); m != merged.end(); ++m){
+        bc_snapshot_.ext_isos.push_back((*m).first);
+        bc_snapshot_.neumann.push_back((*m).second.first);
+        bc_snapshot_.cauchy.push_back((*m).second.second);
+      }
+      bc_ext_valid_ = true;
+    }
+    return bc_snapshot_;
+  };
+
+  /**
+     Discards the boundary condition snapshot. Models call this whenever 
+     their contents or parameters change, i.e. on absorb, extract and update.
+   */
+  void invalidate_bc(){ bc_valid_ = false; bc_ext_valid_ = false; };
+
+  /**
+     Returns the value aligned with tope in a snapshot array, or zero if 
+     tope is not in the sorted isos.
+
+     @param isos the sorted isotopes
+     @param vals the values aligned with isos
+     @param tope the isotope to find
+   */
+  static double bc_lookup(const std::vector<Iso>& isos, 
+      const std::vector<double>& vals, Iso tope) {
+    std::vector<Iso>::const_iterator found = std::lower_bound(isos.begin(), 
+        isos.end(), tope);
+    if( found == isos.end() || (*found) != tope ) {
+      return 0;
+    }
+    return vals[found - isos.begin()];
   };
     
 
@@ -252,7 +618,7 @@ public:
   void set_comp_id(int id){comp_id_ = id;};
 
   /// Allows the geometry object to be set
-  void set_geom(GeometryPtr geom){ geom_=geom; };
+  void set_geom(GeometryPtr geom){ geom_=geom; invalidate_bc(); invalidate_volumes(); };
 
   /// Returns the geom_ data member
   const GeometryPtr geom() const {return geom_;};
@@ -380,11 +746,17 @@ public:
 
      @param mat_table the mat table data pointer for this component.
    **/
-  void set_mat_table(MatDataTablePtr mat_table){mat_table_ = MatDataTablePtr(mat_table);}
+  void set_mat_table(MatDataTablePtr mat_table){
+    mat_table_ = MatDataTablePtr(mat_table); 
+    invalidate_bc();
+  }
 
   /// Returns wastes_
   std::deque<mat_rsrc_ptr> wastes() {return wastes_;};
 
+  /// Returns the material data table of this model
+  const MatDataTablePtr mat_table() const {return mat_table_;};
+
   /// returns the time at which the vec_hist and conc_hist were updated
   int last_updated(){return last_updated_;};
 
@@ -407,6 +779,25 @@ public:
   virtual double V_ff()=0;
   virtual double V_T()=0;
 
+  /**
+     Returns the pore volumes, derived by calc_volumes() only if the 
+     geometry, its revision, the porosity, or the degradation have changed 
+     since they were last derived.
+   */
+  const pore_volumes_t& volumes() {
+    if( !vol_valid_ || vol_geom_ != geom_.get() || 
+        vol_rev_ != geom_->revision() ) {
+      volumes_ = calc_volumes();
+      vol_geom_ = geom_.get();
+      vol_rev_ = geom_->revision();
+      vol_valid_ = true;
+    }
+    return volumes_;
+  };
+
+  /// marks the pore volumes stale, for setters of the porosity or degradation
+  void invalidate_volumes(){ vol_valid_ = false; };
+
   /// spits out a number instead of a BCType
   virtual BCType enumerateBCType(std::string type_name) {
     BCType to_ret = LAST_BC_TYPE;
@@ -455,5 +846,71 @@ protected:
 
   /// the id of the component that this nuclidemodel is a part of
   int comp_id_;
+
+  /// the id of the component under which the parameters were recorded
+  int params_id_;
+
+  /// the number of timesteps between transport steps
+  int step_size_;
+
+  /// the timestep of the last transport step, -1 if there has been none
+  int last_transported_;
+
+  /// the timesteps covered by the current transport step
+  int interval_;
+
+  /// true if the step size adapts to the mass change
+  bool adaptive_;
+
+  /// the largest relative mass change per adaptive step
+  double step_tol_;
+
+  /// the largest adaptive step size, in timesteps
+  int max_step_size_;
+
+  /// the contained mass after the last transport step [kg]
+  double last_mass_;
+
+  /// true if the source term sensitivities should be recorded
+  bool sensitivities_;
+
+  /// the boundary conditions offered to the parent at this step
+  BCSnapshot bc_snapshot_;
+
+  /// true if the source term and dirichlet bcs in bc_snapshot_ are current
+  bool bc_valid_;
+
+  /// true if the neumann and cauchy bcs in bc_snapshot_ are current
+  bool bc_ext_valid_;
+
+  /// the geometry from which bc_snapshot_ was taken
+  Geometry* bc_geom_;
+
+  /// the revision of the geometry from which bc_snapshot_ was taken
+  int bc_rev_;
+
+  /**
+     Derives the pore volumes of this model. By default, the whole volume 
+     is free fluid.
+   */
+  virtual pore_volumes_t calc_volumes() {
+    pore_volumes_t to_ret;
+    to_ret.V_f = geom_->volume();
+    to_ret.V_s = 0;
+    to_ret.V_ff = to_ret.V_f;
+    return to_ret;
+  };
+
+  /// the pore volumes as of the last call to calc_volumes()
+  pore_volumes_t volumes_;
+
+  /// true if volumes_ is current with the porosity and degradation
+  bool vol_valid_;
+
+  /// the geometry from which volumes_ was derived
+  Geometry* vol_geom_;
+
+  /// the revision of the geometry from which volumes_ was derived
+  int vol_rev_;
 };
 #endif
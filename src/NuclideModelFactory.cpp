@@ -66,7 +66,7 @@ NuclideModelPtr NuclideModelFactory::nuclideModel(QueryEngine* qe, MatDataTableP
     to_ret->set_mat_table(MatDataTablePtr(mat_table));
     to_ret->set_geom(geom);
     to_ret->set_comp_id(comp_id);
-    to_ret->updateNuclideParamsTable();
+    to_ret->recordNuclideParams();
     return to_ret;
 }
 
@@ -95,10 +95,19 @@ NuclideModelPtr NuclideModelFactory::nuclideModel(NuclideModelPtr src,
       throw CycException("Unknown nuclide model enum value encountered when copying."); 
   }      
   to_ret->copy(*src);
+  to_ret->set_step_size(src->step_size());
+  if( src->adaptive() ) {
+    to_ret->set_adaptive(src->step_tol(), src->max_step_size());
+  }
+  to_ret->set_sensitivities(src->sensitivities());
   to_ret->set_mat_table(MatDataTablePtr(mat_table));
   to_ret->set_geom(GeometryPtr(geom));
   to_ret->set_comp_id(comp_id);
-  to_ret->updateNuclideParamsTable();
+  // the parameters of a prototype are recorded once, not once per copy
+  if( mat_table == src->mat_table() ) {
+    to_ret->set_params_id(src->params_id());
+  }
+  to_ret->recordNuclideParams();
   return to_ret;
 }
 
@@ -41,7 +41,9 @@ public:
 
   /** 
      Creates a copy of a NuclideModel from another NuclideModel as well as 
-     geometry and material data.
+     geometry and material data. If the material data are the src's, the 
+     copy shares the src's recorded parameters rather than recording them 
+     again.
 
      @param src the original NuclideModel
      @param mat_table a pointer to the material table
@@ -0,0 +1,173 @@
+/*! \file NuclideScreen.cpp
+    \brief Implements the NuclideScreen class, which screens the
+    insignificant isotopes out of the waste streams emplaced in the repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "NuclideScreen.h"
+
+using namespace std;
+
+/// Avogadro's number [1/mol]
+static const double avogadro = 6.02214129e23;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NuclideScreen::NuclideScreen(ScreenCriterion criterion, double keep_fraction,
+    double min_half_life, Iso remainder) :
+  criterion_(criterion),
+  keep_fraction_(keep_fraction),
+  min_half_life_(min_half_life),
+  remainder_(remainder)
+{
+  if( criterion < 0 || criterion >= LAST_SCREEN_CRITERION ||
+      !(keep_fraction > 0 && keep_fraction <= 1) ||
+      !(min_half_life >= 0) || remainder <= 0 ) {
+    stringstream msg_ss;
+    msg_ss << "The NuclideScreen requires a known criterion, a keep_fraction ";
+    msg_ss << "in (0, 1], a nonnegative min_half_life and a remainder isotope. ";
+    msg_ss << "The values provided were criterion = " << criterion;
+    msg_ss << ", keep_fraction = " << keep_fraction << ", min_half_life = ";
+    msg_ss << min_half_life << " and remainder = " << remainder << ".";
+    LOG(LEV_ERROR, "NucScr") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ScreenCriterion NuclideScreen::criterionEnum(string name){
+  ScreenCriterion toRet = LAST_SCREEN_CRITERION;
+  string criterion_names[] = {"MASS", "ACTIVITY", "TOXICITY"};
+  for(int criterion = 0; criterion < LAST_SCREEN_CRITERION; criterion++){
+    if( criterion_names[criterion] == name ) {
+      toRet = (ScreenCriterion)criterion;
+    }
+  }
+  return toRet;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NuclideScreen::set_nuclide(Iso iso, double half_life, double dose_coef){
+  MatTools::validate_finite_pos(half_life);
+  MatTools::validate_finite_pos(dose_coef);
+  nuclide_data_t data = {half_life, dose_coef};
+  nuclides_[iso] = data;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double NuclideScreen::score(Iso iso, double kg){
+  if( criterion_ == MASS_SCREEN ) {
+    return kg;
+  }
+  map<Iso, nuclide_data_t>::const_iterator found = nuclides_.find(iso);
+  if( found == nuclides_.end() || (*found).second.half_life == 0 ) {
+    return 0;
+  }
+  // the mass number of Z*1000 + A is a proxy for the molar mass [g/mol]
+  double atoms = kg*1000/max(1, iso%1000)*avogadro;
+  double seconds = (*found).second.half_life*12*SECSPERMONTH;
+  double activity = log(2.0)/seconds*atoms;
+  if( criterion_ == ACTIVITY_SCREEN ) {
+    return activity;
+  }
+  return activity*(*found).second.dose_coef;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+set<Iso> NuclideScreen::significant(const IsoConcMap& kg){
+  vector<pair<double, Iso> > ranked;
+  IsoConcMap::const_iterator entry;
+  for(entry = kg.begin(); entry != kg.end(); ++entry){
+    if( (*entry).second <= 0 ) {
+      continue;
+    }
+    // the short lived decay away before transport matters
+    map<Iso, nuclide_data_t>::const_iterator found =
+      nuclides_.find((*entry).first);
+    if( found != nuclides_.end() && (*found).second.half_life > 0 &&
+        (*found).second.half_life < min_half_life_ ) {
+      continue;
+    }
+    ranked.push_back(make_pair(score((*entry).first, (*entry).second),
+          (*entry).first));
+  }
+  sort(ranked.begin(), ranked.end(), greater<pair<double, Iso> >());
+
+  // sum in rank order, so that a keep_fraction of one keeps every scorer
+  double total = 0;
+  for(size_t i = 0; i < ranked.size(); ++i){
+    total += ranked[i].first;
+  }
+  set<Iso> to_ret;
+  double kept = 0;
+  for(size_t i = 0; i < ranked.size(); ++i){
+    if( total > 0 && kept >= keep_fraction_*total ) {
+      break;
+    }
+    to_ret.insert(ranked[i].second);
+    kept += ranked[i].first;
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoConcMap NuclideScreen::screen(const IsoConcMap& kg){
+  // the screened mass must not be folded into a physical nuclide
+  IsoConcMap::const_iterator found = kg.find(remainder_);
+  if( found != kg.end() && (*found).second > 0 ) {
+    stringstream msg_ss;
+    msg_ss << "The screening remainder " << remainder_ << " is a nuclide of ";
+    msg_ss << "the waste stream. It must be an inert placeholder isotope.";
+    LOG(LEV_ERROR, "NucScr") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  set<Iso> tracked = significant(kg);
+  IsoConcMap to_ret;
+  double lumped = 0;
+  IsoConcMap::const_iterator entry;
+  for(entry = kg.begin(); entry != kg.end(); ++entry){
+    if( tracked.find((*entry).first) == tracked.end() ) {
+      lumped += (*entry).second;
+    } else {
+      to_ret[(*entry).first] = (*entry).second;
+    }
+  }
+  if( lumped != 0 ) {
+    to_ret[remainder_] += lumped;
+    lumped_kg_.add(lumped);
+  }
+  LOG(LEV_DEBUG2, "NucScr") << "Tracking " << to_ret.size() << " of "
+    << kg.size() << " isotopes, with " << lumped << " kg lumped.";
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+pair<mat_rsrc_ptr, double> NuclideScreen::screen(mat_rsrc_ptr mat){
+  if( mat->quantity() <= 0 ) {
+    return make_pair(mat, 0.0);
+  }
+  IsoConcMap kg;
+  CompMapPtr comp = mat->isoVector().comp();
+  CompMap::const_iterator it;
+  for(it = (*comp).begin(); it != (*comp).end(); ++it){
+    kg[(*it).first] = mat->mass((*it).first);
+  }
+  // the remainder is split off, so the material holds only tracked nuclides
+  IsoConcMap tracked = screen(kg);
+  double lumped = tracked[remainder_];
+  tracked.erase(remainder_);
+  if( tracked.empty() ) {
+    return make_pair(mat_rsrc_ptr(), mat->quantity());
+  }
+  pair<CompMapPtr, double> screened = MatTools::conc_to_comp_map(tracked, 1);
+  mat_rsrc_ptr to_ret = mat_rsrc_ptr(new Material(screened.first));
+  to_ret->setQuantity(mat->quantity() - lumped);
+  return make_pair(to_ret, lumped);
+}
@@ -0,0 +1,184 @@
+/*! \file NuclideScreen.h
+  \brief Declares the NuclideScreen class, which screens the insignificant
+  isotopes out of the waste streams emplaced in the repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_NUCLIDESCREEN_H)
+#define _NUCLIDESCREEN_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+
+#include "Material.h"
+#include "MatTools.h"
+
+/// A shared pointer for the NuclideScreen object
+class NuclideScreen;
+typedef boost::shared_ptr<NuclideScreen> NuclideScreenPtr;
+
+/**
+   enumerated list of the quantities by which isotopes are ranked
+ */
+enum ScreenCriterion {
+  MASS_SCREEN, /**< the mass of the isotope [kg] >**/
+  ACTIVITY_SCREEN, /**< the activity of the isotope [Bq] >**/
+  TOXICITY_SCREEN, /**< the activity times the dose coefficient [Sv] >**/
+  LAST_SCREEN_CRITERION /**< the number of criteria >**/
+};
+
+/**
+   The decay data of a nuclide, as given in the input.
+ */
+typedef struct nuclide_data_t
+{
+  double half_life; /**< the half life [yr], zero for a stable isotope >**/
+  double dose_coef; /**< the ingestion dose coefficient [Sv/Bq] >**/
+} nuclide_data_t;
+
+/**
+   @brief NuclideScreen reduces each emplaced waste stream to its
+   significant isotopes, so that the components track fewer of them.
+
+   Isotopes are first screened by time scale. One whose half life is
+   shorter than min_half_life decays before transport matters and is never
+   tracked. The rest are ranked by the criterion, and the highest ranked
+   are tracked until they hold keep_fraction of the stream's total.
+
+   The mass of the screened isotopes is not lost. It is lumped into the
+   remainder, an inert placeholder isotope that is not a nuclide of any
+   stream. A screened material is split in two, the tracked isotopes and
+   the lumped mass, so that the lumped mass can be held in the waste form
+   apart from its nuclide model. It is then never transported or released,
+   and has no material data to be looked up.
+
+   Activities are computed from the half lives given for each nuclide,
+   taking the mass number as a proxy for the molar mass. A nuclide without a half life
+   is stable, and one without a dose coefficient has none, so neither
+   ranks by activity or toxicity.
+ */
+class NuclideScreen {
+private:
+  /**
+     The constructor for the NuclideScreen.
+
+     @param criterion the quantity by which isotopes are ranked
+     @param keep_fraction the fraction of the total to track, in (0, 1]
+     @param min_half_life the shortest half life to track [yr]
+     @param remainder the placeholder isotope holding the screened mass
+   */
+  NuclideScreen(ScreenCriterion criterion, double keep_fraction,
+      double min_half_life, Iso remainder);
+
+public:
+  /**
+     A constructor for the NuclideScreen that returns a shared pointer.
+
+     @param criterion the quantity by which isotopes are ranked
+     @param keep_fraction the fraction of the total to track, in (0, 1]
+     @param min_half_life the shortest half life to track [yr]
+     @param remainder the placeholder isotope holding the screened mass
+    */
+  static NuclideScreenPtr create(ScreenCriterion criterion,
+      double keep_fraction, double min_half_life, Iso remainder){
+    return NuclideScreenPtr(new NuclideScreen(criterion, keep_fraction,
+          min_half_life, remainder)); };
+
+  /// Default destructor
+  ~NuclideScreen() {};
+
+  /**
+     Returns the ScreenCriterion enum associated with the name.
+
+     @param name the name of the criterion (MASS, ACTIVITY or TOXICITY)
+     @return the ScreenCriterion, LAST_SCREEN_CRITERION if it is unknown
+    */
+  static ScreenCriterion criterionEnum(std::string name);
+
+  /**
+     Sets the decay data of a nuclide.
+
+     @param iso the nuclide
+     @param half_life the half life [yr], zero for a stable isotope
+     @param dose_coef the ingestion dose coefficient [Sv/Bq]
+    */
+  void set_nuclide(Iso iso, double half_life, double dose_coef=0);
+
+  /**
+     Returns the quantity by which an isotope is ranked.
+
+     @param iso the isotope
+     @param kg the mass of the isotope [kg]
+     @return its mass [kg], activity [Bq] or toxicity [Sv]
+    */
+  double score(Iso iso, double kg);
+
+  /**
+     Returns the isotopes of a stream that are to be tracked.
+
+     @param kg the mass of each isotope in the stream [kg]
+    */
+  std::set<Iso> significant(const IsoConcMap& kg);
+
+  /**
+     Screens a stream, lumping the mass of the screened isotopes into the
+     remainder. Throws a CycRangeException if the stream holds the
+     remainder itself.
+
+     @param kg the mass of each isotope in the stream [kg]
+     @return the mass of each tracked isotope [kg], with the same total
+    */
+  IsoConcMap screen(const IsoConcMap& kg);
+
+  /**
+     Screens a material, splitting the lumped mass from the tracked 
+     isotopes rather than adding the remainder to the material.
+
+     @param mat the material to screen
+     @return a new material of the tracked isotopes, NULL if none are 
+     tracked, and the mass lumped into the remainder [kg]. Together they 
+     hold the quantity of mat.
+    */
+  std::pair<mat_rsrc_ptr, double> screen(mat_rsrc_ptr mat);
+
+  /// returns the quantity by which isotopes are ranked
+  ScreenCriterion criterion(){return criterion_;};
+
+  /// returns the fraction of the total to track
+  double keep_fraction(){return keep_fraction_;};
+
+  /// returns the shortest half life to track [yr]
+  double min_half_life(){return min_half_life_;};
+
+  /// returns the placeholder isotope holding the screened mass
+  Iso remainder(){return remainder_;};
+
+  /// returns the decay data of each nuclide given
+  const std::map<Iso, nuclide_data_t>& nuclides(){return nuclides_;};
+
+  /// returns the total mass lumped into remainders so far [kg]
+  double lumped_kg(){return lumped_kg_.sum;};
+
+protected:
+  /// the quantity by which isotopes are ranked
+  ScreenCriterion criterion_;
+
+  /// the fraction of the total to track
+  double keep_fraction_;
+
+  /// the shortest half life to track [yr]
+  double min_half_life_;
+
+  /// the placeholder isotope holding the screened mass
+  Iso remainder_;
+
+  /// the decay data of each nuclide given
+  std::map<Iso, nuclide_data_t> nuclides_;
+
+  /// the total mass lumped into remainders so far [kg]
+  kahan_sum_t lumped_kg_;
+};
+
+#endif
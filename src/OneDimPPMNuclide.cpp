@@ -56,6 +56,7 @@ void OneDimPPMNuclide::initModuleMembers(QueryEngine* qe){
   v_ = lexical_cast<double>(qe->getElementContent("advective_velocity"));
   // rock parameters
   porosity_ = lexical_cast<double>(qe->getElementContent("porosity"));
+  invalidate_volumes();
   rho_ = lexical_cast<double>(qe->getElementContent("bulk_density"));
 
   LOG(LEV_DEBUG2,"GR1DNuc") << "The OneDimPPMNuclide Class init(cur) function has been called";;
@@ -79,6 +80,8 @@ NuclideModelPtr OneDimPPMNuclide::copy(const NuclideModel& src){
   conc_hist_ = ConcHist();
   update_vec_hist(TI->time());
 
+  invalidate_bc();
+
   return shared_from_this();
 }
 
@@ -106,6 +109,7 @@ void OneDimPPMNuclide::absorb(mat_rsrc_ptr matToAdd)
   LOG(LEV_DEBUG2,"GR1DNuc") << "OneDimPPMNuclide is absorbing material: ";
   matToAdd->print();
   wastes_.push_back(matToAdd);
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -117,6 +121,7 @@ mat_rsrc_ptr OneDimPPMNuclide::extract(const CompMapPtr comp_to_rem, double kg_t
   LOG(LEV_DEBUG2,"GR1DNuc") << "OneDimPPMNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
   mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  invalidate_bc();
   update(last_updated());
   return to_ret;
 }
@@ -134,6 +139,7 @@ void OneDimPPMNuclide::transportNuclides(int the_time){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::update(int the_time){
+  invalidate_bc();
   update_vec_hist(the_time);
   update_conc_hist(the_time, wastes_);
   set_last_updated(the_time);
@@ -164,7 +170,7 @@ IsoConcMap OneDimPPMNuclide::dirichlet_bc(){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap OneDimPPMNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
   ConcGradMap to_ret;
-  IsoConcMap c_int = dirichlet_bc();
+  IsoConcMap c_int = bc_snapshot().dirichlet_map;
   Radius r_int = geom()->radial_midpoint();
 
   int iso;
@@ -332,9 +338,8 @@ double OneDimPPMNuclide::calculate_conc(IsoConcMap C_0, IsoConcMap C_i, double r
   //@TODO add sorption to this model. For now, R=1, no sorption. 
   double R=1;
   assert(t0<t);
-  double del_t = t-t0;
-  t = 120*SECSPERMONTH * del_t ;
-  double A = Azt(R, r, v(), t, D, L);
+  double del_t = SECSPERMONTH*(t-t0);
+  double A = Azt(R, r, v(), del_t, D, L);
   double Ci_iso =0;
   if(C_i.find(iso) != C_i.end()) {
     Ci_iso = C_i[iso];
@@ -370,27 +375,13 @@ void OneDimPPMNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr
   double b=geom()->outer_radius();
   assert(a<b);
   if(the_time > 0 ) {
-    vector<double> calc_points = MatTools::linspace(a,b,n);
     std::vector<NuclideModelPtr>::iterator daughter;
     for(daughter=daughters.begin(); daughter!=daughters.end(); ++daughter){
-      std::map<double, IsoConcMap> f_map;
-      // m(tn-1) = current contaminants
-      std::pair<IsoVector, double> m_prev = MatTools::sum_mats(wastes_);
-      // Ci = C(tn-1)
-      vector<double>::const_iterator pt;
-      for(pt = calc_points.begin(); pt!=calc_points.end(); ++pt){ 
-        IsoConcMap C0 = Co(*daughter);
-        assert(C0.size()!=0);
-        double r = (*pt);
-        MatTools::validate_finite_pos(r);
-        assert(r<=b);
-        assert(r>=a);
-        IsoConcMap diff = calculate_conc_diff(C0, Ci(), r-a, the_time-1, 
-            the_time);
-        f_map.insert(make_pair(r,diff));
-      }
-      // m(tn) = integrate conc diff
-      IsoConcMap to_ret = trap_rule(a, b, n-1, f_map);
+      IsoConcMap C0 = Co(*daughter);
+      assert(C0.size()!=0);
+      // m(tn) = integrate conc diff, Ci = C(tn-1)
+      IsoConcMap to_ret = integrate_conc_diff(C0, Ci(), b-a, n, 
+          the_time-interval(), the_time);
       // note, we are using the daughter's volume for safety
       // @TODO use this v_ff after checking appropriateness.
       pair<CompMapPtr, double> m_ij = MatTools::conc_to_comp_map(to_ret, (*daughter)->V_ff());
@@ -411,6 +402,57 @@ void OneDimPPMNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr
   }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoConcMap OneDimPPMNuclide::integrate_conc_diff(IsoConcMap C_0, IsoConcMap C_i,
+    double L, int n, int t0, int t){
+  assert(t0<t);
+  assert(n>=2);
+  double del_t = SECSPERMONTH*(t-t0);
+  IsoConcMap to_ret;
+  IsoConcMap::const_iterator it;
+  // as in calculate_conc_diff, isotopes absent from C_0 keep C_i everywhere
+  for(it=C_i.begin(); it!=C_i.end(); ++it){
+    if(C_0.find((*it).first) == C_0.end()){
+      to_ret[(*it).first] = L*(*it).second;
+    }
+  }
+  for(it=C_0.begin(); it!=C_0.end(); ++it){
+    Iso iso = (*it).first;
+    double D = mat_table_->D(iso/1000);
+    MatTools::validate_finite_pos(D);
+    double Ci_iso = (C_i.find(iso) != C_i.end()) ? C_i[iso] : 0;
+    double del_C = (*it).second - Ci_iso;
+    kernel_weights_t weights = kernel_weights(D, L, n, del_t);
+    to_ret[iso] = del_C*((del_C >= 0) ? weights.pos : weights.neg);
+    MatTools::validate_finite_pos(to_ret[iso]);
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+kernel_weights_t OneDimPPMNuclide::kernel_weights(double D, double L, int n, 
+    double del_t){
+  kernel_key_t key = {D, v(), L, del_t, n};
+  kernel_weights_t weights;
+  if( KC->find(key, weights) ) {
+    return weights;
+  }
+  //@TODO add sorption to this model. For now, R=1, no sorption. 
+  double R=1;
+  double h = L/(n-1);
+  vector<double> z = MatTools::linspace(0, L, n);
+  vector<double> pos, neg;
+  for(int k = 0; k < n; ++k){
+    double w = (k == 0 || k == n-1) ? h/2.0 : h;
+    double A = Azt(R, z[k], v(), del_t, D, L);
+    pos.push_back(w*max(A, 0.0));
+    neg.push_back(w*min(A, 0.0));
+  }
+  weights.pos = CycArithmetic::KahanSum(pos);
+  weights.neg = CycArithmetic::KahanSum(neg);
+  return KC->insert(key, weights);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap OneDimPPMNuclide::trap_rule(double a, double b, int n, map<double, IsoConcMap> f_map) {
   double h = (b-a)/n;
@@ -462,6 +504,8 @@ void OneDimPPMNuclide::set_porosity(double porosity){
     throw CycRangeException(msg_ss.str());
   }
   porosity_ = porosity;
+  invalidate_bc();
+  invalidate_volumes();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -478,12 +522,12 @@ void OneDimPPMNuclide::set_rho(double rho){
     throw CycRangeException(msg_ss.str());
   }
   rho_ = rho;
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap OneDimPPMNuclide::Co(const NuclideModelPtr& daughter) {
-  IsoFluxMap dirichlet = daughter->dirichlet_bc();
-  return dirichlet;
+  return daughter->bc_snapshot().dirichlet_map;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -495,6 +539,7 @@ IsoConcMap OneDimPPMNuclide::Ci() {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::set_v(double v){
   v_=v;
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -504,5 +549,14 @@ double OneDimPPMNuclide::V_T(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double OneDimPPMNuclide::V_f(){
-  return MatTools::V_f(V_T(), porosity());
+  return volumes().V_f;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+pore_volumes_t OneDimPPMNuclide::calc_volumes(){
+  pore_volumes_t to_ret;
+  to_ret.V_f = MatTools::V_f(V_T(), porosity());
+  to_ret.V_s = MatTools::V_s(V_T(), porosity());
+  to_ret.V_ff = to_ret.V_f;
+  return to_ret;
 }
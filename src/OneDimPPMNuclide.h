@@ -12,6 +12,7 @@
 #include <map>
 #include <string>
 
+#include "KernelCache.h"
 #include "NuclideModel.h"
 
 /// A shared pointer for the OneDimPPMNuclide object
@@ -304,6 +305,36 @@ public:
   /// @TODO describe
   IsoConcMap trap_rule(double a, double b, int n, std::map<double, IsoConcMap> fmap);
 
+  /**
+     Integrates the concentration difference due to C_0 over the 
+     thickness of the component, as the trapezoidal rule over n nodes of 
+     calculate_conc_diff does, from the cached kernel weights of each 
+     element.
+
+     @param C_0 the source concentration at the inner boundary [kg/m^3]
+     @param C_i the initial concentration in the cell [kg/m^3]
+     @param L the thickness of the component [m]
+     @param n the number of quadrature nodes
+     @param t0 the time at the start of the step [timestep]
+     @param t the time at the end of the step [timestep]
+     @return the integral of the concentration difference [kg/m^2]
+    */
+  IsoConcMap integrate_conc_diff(IsoConcMap C_0, IsoConcMap C_i, double L, 
+      int n, int t0, int t);
+
+  /**
+     Returns the trapezoidal weights of the Green's function of an element 
+     over [0, L], from the KernelCache, computing and caching them on the 
+     first request.
+
+     @param D the dispersion coefficient of the element [m^2/s]
+     @param L the thickness of the component [m]
+     @param n the number of quadrature nodes
+     @param del_t the length of the step [s]
+     @return the positive and negative parts of the integrated kernel [m]
+    */
+  kernel_weights_t kernel_weights(double D, double L, int n, double del_t);
+
   /// sets the porosity_ variable, the percent void of the medium 
   void set_porosity(double porosity);
 
@@ -350,6 +381,9 @@ public:
 
 
 protected:
+  /// Derives the fluid, solid, and free fluid volumes from porosity
+  virtual pore_volumes_t calc_volumes();
+
   /**
     The advective velocity through the waste packages in units of m/s.
   */
@@ -0,0 +1,221 @@
+/*! \file Reducer.cpp
+    \brief Implements the Reducer class, which reduces the output databases
+    of many Cyder runs to compact series and parameter sweep tables
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "ContaminantReader.h"
+#include "CycException.h"
+#include "Logger.h"
+#include "Reducer.h"
+#include "SqliteReader.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Reducer::Reducer(int t0, int tf, int n_threads) :
+  t0_(t0),
+  tf_(tf),
+  n_threads_(n_threads),
+  next_(0)
+{
+  if( (tf >= 0 && tf <= t0) || n_threads < 1 ) {
+    stringstream msg_ss;
+    msg_ss << "The Reducer requires tf > t0, or a negative tf, and at least ";
+    msg_ss << "one thread. ";
+    msg_ss << "The values provided were t0 = " << t0 << ", tf = " << tf;
+    msg_ss << " and " << n_threads << " threads.";
+    LOG(LEV_ERROR, "CydRed") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<run_summary_t> Reducer::reduce(const vector<string>& files){
+  vector<run_summary_t> runs(files.size());
+  next_ = 0;
+  error_ = "";
+  int n = min(n_threads_, int(files.size()));
+  boost::thread_group workers;
+  for(int i = 0; i < n; ++i){
+    workers.create_thread(boost::bind(&Reducer::work, this, &files, &runs));
+  }
+  workers.join_all();
+  if( !error_.empty() ) {
+    throw CycException(error_);
+  }
+  return runs;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Reducer::work(const vector<string>* files, vector<run_summary_t>* runs){
+  while( true ) {
+    int i;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      if( next_ >= int(files->size()) || !error_.empty() ) {
+        return;
+      }
+      i = next_++;
+    }
+    try {
+      (*runs)[i] = reduceRun((*files)[i], t0_, tf_);
+    } catch ( exception& e ) {
+      boost::mutex::scoped_lock lock(mutex_);
+      if( error_.empty() ) {
+        error_ = (*files)[i] + ": " + e.what();
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+run_summary_t Reducer::reduceRun(string file, int t0, int tf){
+  run_summary_t run;
+  run.file = file;
+  run.t0 = t0;
+
+  // change-threshold encoded components are rebuilt at every timestep, one 
+  // history at a time, each added into the series as it is rebuilt
+  ContaminantReader contaminants(file);
+  if( tf < 0 ) {
+    tf = contaminants.last_time() + 1;
+  }
+  int n_times = max(0, tf - t0);
+  if( n_times > 0 ) {
+    contaminants.each(t0, tf, boost::bind(&Reducer::addHistory, &run, 
+          n_times, _1, _2));
+  }
+
+  SqliteReader reader(file);
+  sqlite3_stmt* stmt = reader.prepare("SELECT compID, paramsID FROM components");
+  while( reader.step(stmt) ) {
+    run.params_id[sqlite3_column_int(stmt, 0)] = sqlite3_column_int(stmt, 1);
+  }
+
+  stmt = reader.prepare("SELECT CompID, ParamName, ParamVal "
+      "FROM NuclideModelParams");
+  while( reader.step(stmt) ) {
+    string name(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+    run.params[make_pair(sqlite3_column_int(stmt, 0), name)] =
+      sqlite3_column_double(stmt, 2);
+  }
+  return run;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Reducer::addHistory(run_summary_t* run, int n_times, 
+    const comp_iso_t& key, const contaminant_series_t& history){
+  vector<double>& comp_series = run->comp_mass[key.first];
+  if( comp_series.empty() ) {
+    comp_series.assign(n_times, 0);
+  }
+  vector<double>& iso_series = run->iso_mass[key.second];
+  if( iso_series.empty() ) {
+    iso_series.assign(n_times, 0);
+  }
+  for(int t = 0; t < n_times; ++t){
+    comp_series[t] += history.kg[t];
+    iso_series[t] += history.kg[t];
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Reducer::param(const run_summary_t& run, int comp_id, string name){
+  // copies of a template share the params recorded for the template
+  map<int, int>::const_iterator shared = run.params_id.find(comp_id);
+  if( shared != run.params_id.end() && (*shared).second >= 0 ) {
+    comp_id = (*shared).second;
+  }
+  map<pair<int, string>, double>::const_iterator found =
+    run.params.find(make_pair(comp_id, name));
+  if( found == run.params.end() ) {
+    stringstream msg_ss;
+    msg_ss << "The run " << run.file << " has no parameter '" << name;
+    msg_ss << "' for component " << comp_id << ".";
+    LOG(LEV_ERROR, "CydRed") << msg_ss.str();
+    throw CycException(msg_ss.str());
+  }
+  return (*found).second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Reducer::compMass(const run_summary_t& run, int comp_id, int the_time){
+  map<int, vector<double> >::const_iterator found =
+    run.comp_mass.find(comp_id);
+  if( found == run.comp_mass.end() ) {
+    return 0;
+  }
+  const vector<double>& series = (*found).second;
+  if( the_time < 0 && series.empty() ) {
+    return 0;
+  }
+  if( the_time < 0 ) {
+    return *max_element(series.begin(), series.end());
+  }
+  int t = the_time - run.t0;
+  if( t < 0 || t >= int(series.size()) ) {
+    stringstream msg_ss;
+    msg_ss << "The time " << the_time << " is outside of the reduced series ";
+    msg_ss << "of " << run.file << ".";
+    LOG(LEV_ERROR, "CydRed") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  return series[t];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Reducer::writeCompSeries(ostream& out, const vector<run_summary_t>& runs){
+  out.precision(15);
+  out << "File,CompID,Time,MassKG\n";
+  vector<run_summary_t>::const_iterator run;
+  for(run = runs.begin(); run != runs.end(); ++run){
+    map<int, vector<double> >::const_iterator comp;
+    for(comp = (*run).comp_mass.begin(); comp != (*run).comp_mass.end();
+        ++comp){
+      for(size_t t = 0; t < (*comp).second.size(); ++t){
+        out << (*run).file << "," << (*comp).first << "," << (*run).t0 + t;
+        out << "," << (*comp).second[t] << "\n";
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Reducer::writeIsoSeries(ostream& out, const vector<run_summary_t>& runs){
+  out.precision(15);
+  out << "File,IsoID,Time,MassKG\n";
+  vector<run_summary_t>::const_iterator run;
+  for(run = runs.begin(); run != runs.end(); ++run){
+    map<int, vector<double> >::const_iterator iso;
+    for(iso = (*run).iso_mass.begin(); iso != (*run).iso_mass.end(); ++iso){
+      for(size_t t = 0; t < (*iso).second.size(); ++t){
+        out << (*run).file << "," << (*iso).first << "," << (*run).t0 + t;
+        out << "," << (*iso).second[t] << "\n";
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Reducer::writePivot(ostream& out, const vector<run_summary_t>& runs,
+    int comp_id, string x_param, string y_param, int the_time){
+  out.precision(15);
+  out << "File," << x_param;
+  if( !y_param.empty() ) {
+    out << "," << y_param;
+  }
+  out << ",MassKG\n";
+  vector<run_summary_t>::const_iterator run;
+  for(run = runs.begin(); run != runs.end(); ++run){
+    out << (*run).file << "," << param(*run, comp_id, x_param);
+    if( !y_param.empty() ) {
+      out << "," << param(*run, comp_id, y_param);
+    }
+    out << "," << compMass(*run, comp_id, the_time) << "\n";
+  }
+}
@@ -0,0 +1,179 @@
+/*! \file Reducer.h
+  \brief Declares the Reducer class, which reduces the output databases of
+  many Cyder runs to compact series and parameter sweep tables
+  \author Kathryn D. Huff
+ */
+#if !defined(_REDUCER_H)
+#define _REDUCER_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "ContaminantReader.h"
+
+/**
+   The reduction of one run database.
+ */
+typedef struct run_summary_t
+{
+  std::string file; /**< the path to the run database >**/
+  int t0; /**< the first timestep of the series >**/
+  std::map<int, std::vector<double> > comp_mass; /**< the mass in each component at each time, summed over isotopes [kg] >**/
+  std::map<int, std::vector<double> > iso_mass; /**< the mass of each isotope at each time, summed over components [kg] >**/
+  std::map<int, int> params_id; /**< the component whose params each component shares, from the components table >**/
+  std::map<std::pair<int, std::string>, double> params; /**< the NuclideModelParams, by component id and name >**/
+} run_summary_t;
+
+/**
+   @class Reducer
+   The Reducer streams the contaminants, components and NuclideModelParams
+   tables of many run databases, each in a single pass, and reduces them
+   to the series and sweep tables that the plotting scripts need:
+   - the mass in each component over time, summed over isotopes,
+   - the mass of each isotope over time, summed over components, and
+   - a pivot of one component's mass against one or two swept parameters.
+
+   The databases are reduced in parallel, one connection per database, and
+   the summaries are returned in the order of the files, so the output does
+   not depend on the number of threads.
+ */
+class Reducer {
+public:
+  /**
+     The constructor for the Reducer.
+
+     @param t0 the first timestep to reduce, inclusive
+     @param tf the last timestep to reduce, exclusive, or a negative value 
+     to reduce each database through the last timestep it recorded
+     @param n_threads the number of databases to reduce at once
+   */
+  Reducer(int t0, int tf, int n_threads);
+
+  /**
+     Reduces each database.
+
+     @param files the paths to the run databases
+     @return the summary of each database, in the order of files
+   */
+  std::vector<run_summary_t> reduce(const std::vector<std::string>& files);
+
+  /**
+     Reduces one database.
+
+     @param file the path to the run database
+     @param t0 the first timestep to reduce, inclusive
+     @param tf the last timestep to reduce, exclusive, or a negative value 
+     for MAX(Time) + 1 of the contaminants table
+     @return the summary of the database
+   */
+  static run_summary_t reduceRun(std::string file, int t0, int tf);
+
+  /**
+     Returns the value of a parameter of a component. Like get_param_val
+     in output_tools.py, a component that shares the params of its
+     template is answered with the template's.
+
+     @param run the summary of the run
+     @param comp_id the id of the component
+     @param name the name of the parameter
+     @return the value of the parameter
+   */
+  static double param(const run_summary_t& run, int comp_id,
+      std::string name);
+
+  /**
+     Returns the mass in a component at one time, or its peak over the
+     series if the_time is negative.
+
+     @param run the summary of the run
+     @param comp_id the id of the component
+     @param the_time the timestep, or -1 for the peak
+     @return the mass in the component [kg]
+   */
+  static double compMass(const run_summary_t& run, int comp_id,
+      int the_time);
+
+  /**
+     Writes the component series, with the header
+     File,CompID,Time,MassKG.
+   */
+  static void writeCompSeries(std::ostream& out,
+      const std::vector<run_summary_t>& runs);
+
+  /**
+     Writes the isotope series, with the header File,IsoID,Time,MassKG.
+   */
+  static void writeIsoSeries(std::ostream& out,
+      const std::vector<run_summary_t>& runs);
+
+  /**
+     Writes one row per run of the swept parameters and the mass in one
+     component, the data of line_plot.py and, with a second parameter,
+     contour_plot.py. The header is File,x_param[,y_param],MassKG.
+
+     @param out the stream to write to
+     @param runs the summaries of the runs
+     @param comp_id the id of the component
+     @param x_param the name of the first swept parameter
+     @param y_param the name of the second, or "" for none
+     @param the_time the timestep of the mass, or -1 for its peak
+   */
+  static void writePivot(std::ostream& out,
+      const std::vector<run_summary_t>& runs, int comp_id,
+      std::string x_param, std::string y_param, int the_time);
+
+  /// returns the first timestep reduced
+  int t0(){return t0_;};
+
+  /// returns the last timestep reduced, exclusive, negative for the last 
+  /// timestep of each database
+  int tf(){return tf_;};
+
+  /// returns the number of databases reduced at once
+  int n_threads(){return n_threads_;};
+
+protected:
+  /**
+     Adds one rebuilt history into the component and isotope series of a 
+     run, so that the histories need not all be held at once.
+
+     @param run the summary of the run
+     @param n_times the length of the series
+     @param key the component id and isotope of the history
+     @param history the rebuilt history
+   */
+  static void addHistory(run_summary_t* run, int n_times, 
+      const comp_iso_t& key, const contaminant_series_t& history);
+
+  /**
+     Reduces the databases of files, one after another, taking the next
+     from next_ until none remain.
+   */
+  void work(const std::vector<std::string>* files,
+      std::vector<run_summary_t>* runs);
+
+  /// the first timestep to reduce, inclusive
+  int t0_;
+
+  /// the last timestep to reduce, exclusive, negative for each database's 
+  /// last timestep
+  int tf_;
+
+  /// the number of databases to reduce at once
+  int n_threads_;
+
+  /// the index of the next database to reduce
+  int next_;
+
+  /// the message of the first error, if any database failed
+  std::string error_;
+
+  /// guards next_ and error_
+  boost::mutex mutex_;
+};
+
+#endif
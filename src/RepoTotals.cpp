@@ -0,0 +1,85 @@
+/*! \file RepoTotals.cpp
+    \brief Implements the RepoTotals class, which keeps running aggregates of
+    the repository's contaminants during the run
+    \author Kathryn D. Huff
+ */
+#include "EventBuffer.h"
+#include "RepoTotals.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RepoTotals::addMass(int the_time, ComponentType type, Iso iso, double kg,
+    Concentration conc){
+  type_iso_t key = make_pair(type, iso);
+  mass_[key] += kg;
+  map<type_iso_t, peak_conc_t>::iterator found = peak_.find(key);
+  if( found == peak_.end() || conc > (*found).second.conc ) {
+    peak_conc_t rise = {the_time, conc};
+    peak_[key] = rise;
+    risen_.insert(key);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RepoTotals::addRelease(Iso iso, double kg){
+  released_[iso] += kg;
+  cumulative_[iso] += kg;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RepoTotals::record(int the_time){
+  map<type_iso_t, double>::const_iterator total;
+  for(total = mass_.begin(); total != mass_.end(); ++total){
+    EB->addRepoTotal(the_time, 
+        Component::componentTypeName((*total).first.first), 
+        (*total).first.second, (*total).second);
+  }
+
+  map<Iso, double>::const_iterator release;
+  for(release = cumulative_.begin(); release != cumulative_.end(); ++release){
+    EB->addRepoRelease(the_time, (*release).first, 
+        released((*release).first), (*release).second);
+  }
+
+  set<type_iso_t>::const_iterator key;
+  for(key = risen_.begin(); key != risen_.end(); ++key){
+    EB->addRepoPeak(peak_[*key].time, 
+        Component::componentTypeName((*key).first), (*key).second, 
+        peak_[*key].conc);
+  }
+
+  mass_.clear();
+  released_.clear();
+  risen_.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double RepoTotals::mass(ComponentType type, Iso iso){
+  map<type_iso_t, double>::const_iterator found =
+    mass_.find(make_pair(type, iso));
+  return (found == mass_.end()) ? 0 : (*found).second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double RepoTotals::released(Iso iso){
+  map<Iso, double>::const_iterator found = released_.find(iso);
+  return (found == released_.end()) ? 0 : (*found).second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double RepoTotals::cumulative(Iso iso){
+  map<Iso, double>::const_iterator found = cumulative_.find(iso);
+  return (found == cumulative_.end()) ? 0 : (*found).second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+peak_conc_t RepoTotals::peak(ComponentType type, Iso iso){
+  map<type_iso_t, peak_conc_t>::const_iterator found =
+    peak_.find(make_pair(type, iso));
+  if( found == peak_.end() ) {
+    peak_conc_t none = {0, 0};
+    return none;
+  }
+  return (*found).second;
+}
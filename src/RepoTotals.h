@@ -0,0 +1,123 @@
+/*! \file RepoTotals.h
+  \brief Declares the RepoTotals class, which keeps running aggregates of the
+  repository's contaminants during the run
+  \author Kathryn D. Huff
+ */
+#if !defined(_REPOTOTALS_H)
+#define _REPOTOTALS_H
+
+#include <map>
+#include <set>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+
+#include "Component.h"
+#include "MatTools.h"
+
+/// A shared pointer for the RepoTotals object
+class RepoTotals;
+typedef boost::shared_ptr<RepoTotals> RepoTotalsPtr;
+
+/// a key of the aggregates, a component type and an isotope
+typedef std::pair<ComponentType, Iso> type_iso_t;
+
+/**
+   The highest concentration of an isotope in a component type so far.
+ */
+typedef struct peak_conc_t
+{
+  int time; /**< the timestep at which the peak was reached >**/
+  Concentration conc; /**< the peak concentration [kg/m^3] >**/
+} peak_conc_t;
+
+/**
+   @brief RepoTotals keeps running aggregates of the repository's
+   contaminants as the components report them, so that the common totals
+   need not be reconstructed from the contaminants table after the run.
+
+   Each tock, the mass of each isotope is summed over each component type
+   and the mass released to the far field is summed over the buffers.
+   record() hands these to the EventBuffer, which writes them with the rest
+   of the tock's rows to three compact tables:
+   - repoTotals: Time, CompType, IsoID, MassKG
+   - repoReleases: Time, IsoID, ReleasedKG, CumulativeKG
+   - repoPeaks: Time, CompType, IsoID, PeakConc, a row each time the
+     peak concentration of an isotope in a component type rises, so the
+     last row of each pair is the peak of the run
+
+   Their rows scale with isotopes and component types rather than with
+   components.
+ */
+class RepoTotals {
+private:
+  /// The constructor for the RepoTotals, for create() alone
+  RepoTotals() {};
+
+public:
+  /// A constructor for the RepoTotals that returns a shared pointer.
+  static RepoTotalsPtr create(){return RepoTotalsPtr(new RepoTotals());};
+
+  /// Default destructor
+  ~RepoTotals() {};
+
+  /**
+     Adds the mass of an isotope in one component to the totals of this
+     tock.
+
+     @param the_time the timestep of the tock
+     @param type the type of the component
+     @param iso the isotope
+     @param kg the mass of the isotope in the component [kg]
+     @param conc the available concentration of the isotope [kg/m^3]
+    */
+  void addMass(int the_time, ComponentType type, Iso iso, double kg,
+      Concentration conc);
+
+  /**
+     Adds mass released from a buffer to the far field during this tock.
+
+     @param iso the isotope
+     @param kg the mass released [kg]
+    */
+  void addRelease(Iso iso, double kg);
+
+  /**
+     Hands the aggregates of this tock to the EventBuffer for the 
+     repoTotals, repoReleases and repoPeaks tables and starts the next 
+     tock. The cumulative releases and
+     the peaks carry over.
+
+     @param the_time the timestep of the tock
+    */
+  void record(int the_time);
+
+  /// returns the mass of iso in components of the type this tock [kg]
+  double mass(ComponentType type, Iso iso);
+
+  /// returns the mass of iso released to the far field this tock [kg]
+  double released(Iso iso);
+
+  /// returns the mass of iso released to the far field so far [kg]
+  double cumulative(Iso iso);
+
+  /// returns the peak concentration of iso in the type so far [kg/m^3]
+  peak_conc_t peak(ComponentType type, Iso iso);
+
+protected:
+  /// the mass of each isotope in each component type, this tock [kg]
+  std::map<type_iso_t, double> mass_;
+
+  /// the mass of each isotope released to the far field, this tock [kg]
+  std::map<Iso, double> released_;
+
+  /// the mass of each isotope released to the far field so far [kg]
+  std::map<Iso, double> cumulative_;
+
+  /// the peak concentration of each isotope in each component type so far
+  std::map<type_iso_t, peak_conc_t> peak_;
+
+  /// the peaks that rose this tock
+  std::set<type_iso_t> risen_;
+};
+
+#endif
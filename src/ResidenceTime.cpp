@@ -0,0 +1,139 @@
+/*! \file ResidenceTime.cpp
+    \brief Implements the ResidenceTime class, which convolves an inflow
+    history with the residence time distribution of a lumped parameter model
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "ResidenceTime.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ResidenceTime::ResidenceTime(FormulationType formulation, double Pe,
+    double t_t) :
+  formulation_(formulation),
+  gain_(1),
+  scale_(1),
+  delay_(0)
+{
+  if( t_t < 0 || (formulation == DM && Pe <= 0) ) {
+    stringstream msg_ss;
+    msg_ss << "The ResidenceTime requires a nonnegative transit time and, ";
+    msg_ss << "for the DM, a positive Peclet number. The values provided were ";
+    msg_ss << "t_t = " << t_t << " and Pe = " << Pe << ".";
+    LOG(LEV_ERROR, "GRLNuc") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  gain_ = gain(formulation, Pe, t_t);
+  int n;
+  switch(formulation){
+    case DM :
+      // the variance of N reservoirs in series is t_t^2/N, and that of the
+      // dispersion model is 2t_t^2/Pe
+      n = max(1, min(max_tanks(), int(floor(Pe/2.0 + 0.5))));
+      set_tanks(n, t_t);
+      break;
+    case EXPM :
+      set_tanks(1, t_t);
+      break;
+    case PFM :
+      delay_ = int(floor(t_t + 0.5));
+      break;
+    default:
+      string err = "The formulation type is not supported by ResidenceTime.";
+      LOG(LEV_ERROR, "GRLNuc") << err;
+      throw CycException(err);
+      break;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ResidenceTime::gain(FormulationType formulation, double Pe, double t_t){
+  double to_ret;
+  switch(formulation){
+    case DM :
+      to_ret = exp((Pe/2.0)*(1-pow(1+4*t_t/Pe, 0.5)));
+      break;
+    case EXPM :
+      to_ret = 1.0/(1.0+t_t);
+      break;
+    case PFM :
+      to_ret = exp(-t_t);
+      break;
+    default:
+      string err = "The formulation type is not supported by ResidenceTime.";
+      LOG(LEV_ERROR, "GRLNuc") << err;
+      throw CycException(err);
+      break;
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ResidenceTime::set_tanks(int n, double t_t){
+  // each reservoir holds the tracer for theta, during which it decays at a
+  // unit rate, so its concentration relaxes at the rate k = 1/theta + 1
+  double theta = t_t/n;
+  double alpha = (theta > 0) ? exp(-(1.0/theta + 1.0)) : 0;
+  double beta = (1.0 - alpha)/(1.0 + theta);
+  alpha_.assign(n, alpha);
+  beta_.assign(n, beta);
+  // n reservoirs in series hold (1+theta)^-n of a steady inflow
+  scale_ = gain_*pow(1.0 + theta, n);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoConcMap ResidenceTime::step(const IsoConcMap& C_in){
+  IsoConcMap to_ret;
+  IsoConcMap::const_iterator in;
+
+  if( formulation_ == PFM ) {
+    for( in = C_in.begin(); in != C_in.end(); ++in ) {
+      line_[(*in).first];
+    }
+    map<int, deque<double> >::iterator it;
+    for( it = line_.begin(); it != line_.end(); ++it ) {
+      in = C_in.find((*it).first);
+      deque<double>& line = (*it).second;
+      line.push_back(in == C_in.end() ? 0 : (*in).second);
+      double out = 0;
+      if( int(line.size()) > delay_ ) {
+        out = line.front();
+        line.pop_front();
+      }
+      to_ret[(*it).first] = gain_*out;
+    }
+    return to_ret;
+  }
+
+  int n = alpha_.size();
+  for( in = C_in.begin(); in != C_in.end(); ++in ) {
+    vector<double>& tanks = tanks_[(*in).first];
+    if( tanks.empty() ) {
+      tanks.assign(n, 0);
+    }
+  }
+  map<int, vector<double> >::iterator it;
+  for( it = tanks_.begin(); it != tanks_.end(); ++it ) {
+    in = C_in.find((*it).first);
+    double u = (in == C_in.end()) ? 0 : scale_*(*in).second;
+    vector<double>& tanks = (*it).second;
+    for( int i = 0; i < n; ++i ) {
+      tanks[i] = alpha_[i]*tanks[i] + beta_[i]*u;
+      u = tanks[i];
+    }
+    to_ret[(*it).first] = u;
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ResidenceTime::clear(){
+  tanks_.clear();
+  line_.clear();
+}
@@ -0,0 +1,137 @@
+/*! \file ResidenceTime.h
+  \brief Declares the ResidenceTime class, which convolves an inflow history
+  with the residence time distribution of a lumped parameter model
+  \author Kathryn D. Huff
+ */
+#if !defined(_RESIDENCETIME_H)
+#define _RESIDENCETIME_H
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "MatTools.h"
+
+/// The lumped parameter model formulations
+enum FormulationType{
+  DM,
+  EXPM,
+  PFM,
+  LAST_FORMULATION_TYPE};
+
+/// A shared pointer for the ResidenceTime object
+class ResidenceTime;
+typedef boost::shared_ptr<ResidenceTime> ResidenceTimePtr;
+
+/**
+   @brief ResidenceTime convolves the inflow concentration history of a
+   lumped parameter model with its residence time distribution,
+   recursively, at a constant cost per timestep.
+
+   Each kernel is realized by first order reservoirs, whose discrete
+   responses to an inflow held constant over a timestep are exact:
+   - EXPM is a single well mixed reservoir with residence time t_t.
+   - DM is approximated by N = Pe/2 reservoirs in series, each with
+     residence time t_t/N, which matches the variance of the dispersion
+     model. N is at least 1 and is capped at max_tanks().
+   - PFM is a delay of t_t timesteps.
+
+   Like the scale factors of the LumpedNuclide, the tracer decays at a
+   unit rate per timestep while it resides in the component. The steady
+   outflow from a constant inflow C_0 is therefore C_0*gain(), exactly the
+   factor that the LumpedNuclide applies to C_0, and the outflow before
+   steady state is the breakthrough curve. The reservoir coefficients are
+   computed once per (formulation, Pe, t_t), and each step costs O(N) per
+   isotope, however long the inflow history.
+ */
+class ResidenceTime {
+private:
+  /**
+     The constructor for the ResidenceTime.
+
+     @param formulation the lumped parameter model formulation
+     @param Pe the Peclet number, for the DM [-]
+     @param t_t the transit time [timesteps]
+   */
+  ResidenceTime(FormulationType formulation, double Pe, double t_t);
+
+public:
+  /**
+     A constructor for the ResidenceTime that returns a shared pointer.
+
+     @param formulation the lumped parameter model formulation
+     @param Pe the Peclet number, for the DM [-]
+     @param t_t the transit time [timesteps]
+   */
+  static ResidenceTimePtr create(FormulationType formulation, double Pe,
+      double t_t){
+    return ResidenceTimePtr(new ResidenceTime(formulation, Pe, t_t)); };
+
+  /// Default destructor
+  ~ResidenceTime() {};
+
+  /**
+     Returns the steady state ratio of outflow to inflow concentration of a
+     formulation, with the tracer decaying at a unit rate per timestep.
+
+     @param formulation the lumped parameter model formulation
+     @param Pe the Peclet number, for the DM [-]
+     @param t_t the transit time [timesteps]
+     @return the steady state gain [-]
+   */
+  static double gain(FormulationType formulation, double Pe, double t_t);
+
+  /**
+     Advances the convolution by one timestep.
+
+     @param C_in the inflow concentration over the step [kg/m^3]
+     @return the outflow concentration at the end of the step [kg/m^3]
+   */
+  IsoConcMap step(const IsoConcMap& C_in);
+
+  /// Forgets the inflow history
+  void clear();
+
+  /// returns the steady state gain of this kernel
+  double gain(){return gain_;};
+
+  /// returns the number of reservoirs in series, 0 for the PFM
+  int n_tanks(){return alpha_.size();};
+
+  /// returns the delay of the PFM [timesteps], 0 otherwise
+  int delay(){return delay_;};
+
+  /// the most reservoirs in series used to approximate the DM
+  static int max_tanks(){return 64;};
+
+protected:
+  /// sets the coefficients of n reservoirs in series over t_t
+  void set_tanks(int n, double t_t);
+
+  /// the lumped parameter model formulation
+  FormulationType formulation_;
+
+  /// the steady state gain
+  double gain_;
+
+  /// the scaling of the inflow that makes the steady state exactly gain_
+  double scale_;
+
+  /// the fraction of each reservoir's concentration retained over a step
+  std::vector<double> alpha_;
+
+  /// the fraction of the inflow to each reservoir that it holds after a step
+  std::vector<double> beta_;
+
+  /// the delay of the PFM [timesteps]
+  int delay_;
+
+  /// the concentration in each reservoir, by isotope
+  std::map<int, std::vector<double> > tanks_;
+
+  /// the inflow of the last delay_ steps of the PFM, by isotope
+  std::map<int, std::deque<double> > line_;
+};
+
+#endif
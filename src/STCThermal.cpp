@@ -3,6 +3,8 @@
     \author Kathryn D. Huff
  */
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "Logger.h"
 #include <fstream>
@@ -61,6 +63,8 @@ void STCThermal::copy(const ThermalModel& src){
   set_r_calc(src_ptr->r_calc());
   set_mat(src_ptr->mat());
   set_geom(GeometryPtr(new Geometry()));
+  table_ = src_ptr->table_;
+  heat_curves_ = src_ptr->heat_curves_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -79,10 +83,10 @@ void STCThermal::transportHeat(int the_time){
 void STCThermal::initializeSTCTable(){
   th_params_t th_params;
   th_params.a(alpha_th_).k(k_th_).s(spacing_).r(r_calc_);
+  // if th_params is not tabulated, the SDB interpolates a table from the 
+  // surrounding tabulated parameters once, and shares it among components
   table_ = STCDataTablePtr(SDB->table(th_params));
-  ///@TODO this is where the interpolation must occur.
-  ///@TODO you want to make a NEW STCDataTable out of whatever tables, indexes, 
-  //etc that you need to, then set it to stc_table_.
+  heat_curves_ = HeatCurveCachePtr(new heat_curve_cache_t());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -91,64 +95,157 @@ Temp STCThermal::getTempChange(Iso tope, int the_time) {
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-std::map<int, Temp> STCThermal::getTempChange(mat_rsrc_ptr mat){
-  map<int, Temp> to_ret;
+HeatCurvePtr STCThermal::heatCurve(mat_rsrc_ptr mat){
+  if( table_ == NULL ) {
+    string err = "The STCThermal model has no STC table. ";
+    err += "initModuleMembers or copy must be called first.";
+    LOG(LEV_ERROR, "CydSTC") << err;
+    throw CycException(err);
+  }
+  heatTimes();
+
+  HeatKey key = heatKey(mat);
+  boost::unordered_map<HeatKey, HeatCacheEntry, boost::hash<HeatKey> >::iterator 
+    found = heat_curves_->curves.find(key);
+  if( found != heat_curves_->curves.end() ) {
+    // move the composition to the front of the recency list
+    heat_curves_->recent.splice(heat_curves_->recent.begin(), 
+        heat_curves_->recent, (*found).second.second);
+    return (*found).second.first;
+  }
+
+  // gather the stc rows of the isotopes that the table knows about
+  const map<Iso, int>& iso_map = table_->isoIndex();
+  vector<pair<int, double> > rows;
+  HeatKey::iterator entry;
+  for(entry=key.begin(); entry!=key.end(); ++entry){
+    map<Iso, int>::const_iterator row = iso_map.find((*entry).first);
+    if( row != iso_map.end() && (*entry).second != 0 ){
+      rows.push_back(make_pair((*row).second, (*entry).second));
+    }
+  }
+
+  // take the dot product at each timestep, noting the peak as we go
+  const boost::multi_array<double, 2>& arr = table_->stc_array();
+  const vector<int>& times = heat_curves_->times;
+  HeatCurvePtr heat = HeatCurvePtr(new heat_curve_t());
+  heat->curve.resize(times.size(), 0);
+  heat->peak_time = 0;
+  heat->peak = 0;
+  for(int t=0; t<times.size(); ++t){
+    Temp tc = 0;
+    for(int i=0; i<rows.size(); ++i){
+      tc += rows[i].second*arr[rows[i].first][t];
+    }
+    heat->curve[t] = tc;
+    if( tc > heat->peak ) {
+      heat->peak = tc;
+      heat->peak_time = times[t];
+    }
+  }
+  // make room by dropping the least recently used curve
+  if( heat_curves_->curves.size() >= max_heat_curves() ) {
+    heat_curves_->curves.erase(heat_curves_->recent.back());
+    heat_curves_->recent.pop_back();
+  }
+  heat_curves_->recent.push_front(key);
+  heat_curves_->curves.insert(make_pair(key, 
+        make_pair(heat, heat_curves_->recent.begin())));
+  return heat;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+HeatKey STCThermal::heatKey(mat_rsrc_ptr mat){
+  // the key is the mass fraction of each isotope in the material
+  HeatKey key;
+  double kg = mat->quantity();
   CompMapPtr comp = mat->isoVector().comp();
   CompMap::const_iterator it;
-  map<int,int>::iterator step;
-  Iso iso;
-  int time_ind;
-  int the_time;
-  double scale;
   for(it=(*comp).begin(); it!=(*comp).end(); ++it) {
-    iso = (*it).first;
-    map<int, int> time_map= table_->timeIndex();
+    double frac = (kg > 0) ? mat->mass((*it).first)/kg : 0;
+    if( frac > 0 ) {
+      // round relative to the fraction, so that trace isotopes keep their heat
+      double scale = pow(10.0, heat_key_digits() - 1 - floor(log10(frac)));
+      frac = floor(frac*scale + 0.5)/scale;
+    }
+    key.push_back(make_pair((*it).first, frac));
+  }
+  return key;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+const vector<int>& STCThermal::heatTimes(){
+  if( heat_curves_ == NULL ) {
+    heat_curves_ = HeatCurveCachePtr(new heat_curve_cache_t());
+  }
+  if( heat_curves_->times.empty() && table_ != NULL ) {
+    const map<int, int>& time_map = table_->timeIndex();
+    map<int, int>::const_iterator step;
     for(step=time_map.begin(); step!=time_map.end(); ++step){
-      the_time=(*step).first;
-      scale = mat->mass(iso);
-      Temp tc = getTempChange(iso, the_time)*scale;
-      if(to_ret.find(the_time) != to_ret.end()){
-        to_ret[the_time] += tc; 
-      } else {
-        to_ret[the_time] = tc;
-      }
+      heat_curves_->times.push_back((*step).first);
     }
   }
+  return heat_curves_->times;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+Temp STCThermal::getTempChange(HeatCurvePtr heat, double kg, int elapsed){
+  const vector<int>& times = heatTimes();
+  if( elapsed < 0 || times.empty() ) {
+    return 0;
+  }
+  vector<int>::const_iterator upper = lower_bound(times.begin(), times.end(), 
+      elapsed);
+  if( upper == times.end() ) {
+    return kg*heat->curve.back();
+  }
+  int hi = upper - times.begin();
+  if( (*upper) == elapsed ) {
+    return kg*heat->curve[hi];
+  }
+  int t_lo = 0;
+  Temp c_lo = 0;
+  if( hi > 0 ) {
+    t_lo = times[hi-1];
+    c_lo = heat->curve[hi-1];
+  }
+  double frac = double(elapsed - t_lo)/double(times[hi] - t_lo);
+  return kg*(c_lo + frac*(heat->curve[hi] - c_lo));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+std::map<int, Temp> STCThermal::getTempChange(mat_rsrc_ptr mat){
+  map<int, Temp> to_ret;
+  HeatCurvePtr heat = heatCurve(mat);
+  const vector<int>& times = heatTimes();
+  double kg = mat->quantity();
+  for(int t=0; t<times.size(); ++t){
+    to_ret.insert(to_ret.end(), make_pair(times[t], kg*heat->curve[t]));
+  }
   return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Temp STCThermal::getTempChange(mat_rsrc_ptr mat, int the_time){
-  Temp to_ret;
-  try{
-    to_ret = getTempChange(mat).at(the_time);
-  } catch (const out_of_range& oor) {
+  HeatCurvePtr heat = heatCurve(mat);
+  const vector<int>& times = heatTimes();
+  vector<int>::const_iterator found = lower_bound(times.begin(), times.end(), 
+      the_time);
+  if( found == times.end() || (*found) != the_time ) {
     stringstream msg_ss;
-    msg_ss << oor.what();
     msg_ss << "The time ";
     msg_ss << the_time;
     msg_ss << " is not contained in the temperature change history."; 
     LOG(LEV_ERROR, "CydSTC") << msg_ss.str();
     throw CycRangeException(msg_ss.str());
   } 
-
-  return to_ret;
+  return mat->quantity()*heat->curve[found - times.begin()];
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 std::pair<int,Temp> STCThermal::getMaxTempChange(mat_rsrc_ptr mat){
-  std::map<int, Temp> temp_map = getTempChange(mat);
-  map<int, Temp>::iterator it;
-  int max_time = 0;
-  Temp max_val = 0;
-  
-  for(it=temp_map.begin(); it!=temp_map.end(); ++it){
-    if( (*it).second > max_val ) {
-      max_val = (*it).second;
-      max_time = (*it).first;
-    }
-  }
-  return make_pair(max_time, max_val);
+  HeatCurvePtr heat = heatCurve(mat);
+  return make_pair(heat->peak_time, mat->quantity()*heat->peak);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -161,8 +258,9 @@ Temp STCThermal::peak_temp(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 bool STCThermal::mat_acceptable(mat_rsrc_ptr mat, Radius r_lim, Temp t_lim){
-  /// @TODO obviously, put some logic here.
-  return true;
+  // the stc is tabulated at r_calc_, so r_lim is not yet considered. 
+  // the heat of neighboring packages is handled by the ThermalField.
+  return getMaxTempChange(mat).second < t_lim;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
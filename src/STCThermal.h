@@ -7,7 +7,12 @@
 
 #include <iostream>
 #include "Logger.h"
+#include <list>
 #include <string>
+#include <utility>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "ThermalModel.h"
 #include "STCDB.h"
@@ -16,6 +21,42 @@
 class STCThermal;
 typedef boost::shared_ptr<STCThermal> STCThermalPtr;
 
+/// A composition, as (isotope, mass fraction) pairs in ascending isotope order
+typedef std::vector<std::pair<Iso, double> > HeatKey;
+
+/**
+   The temperature change history due to one kg of a composition, dense over 
+   the timesteps of an STC table, along with its peak.
+ */
+typedef struct heat_curve_t
+{
+  std::vector<Temp> curve; /**< the temperature change per kg at each timestep [K/kg] >**/
+  int peak_time; /**< the timestep at which the peak occurs >**/
+  Temp peak; /**< the peak temperature change per kg [K/kg] >**/
+} heat_curve_t;
+
+/// A shared pointer for a heat curve, which stays valid as the cache grows
+typedef boost::shared_ptr<heat_curve_t> HeatCurvePtr;
+
+/// A cached heat curve and its place in the recency list of the cache
+typedef std::pair<HeatCurvePtr, std::list<HeatKey>::iterator> HeatCacheEntry;
+
+/**
+   The heat curves computed from an STC table, keyed by composition hash, 
+   and the dense list of the table's timesteps that the curves run over. 
+   The cache holds at most STCThermal::max_heat_curves() curves, and drops 
+   the least recently used one to make room for another.
+ */
+typedef struct heat_curve_cache_t
+{
+  std::vector<int> times; /**< the timesteps of the STC table, in ascending order >**/
+  std::list<HeatKey> recent; /**< the cached compositions, most recently used first >**/
+  boost::unordered_map<HeatKey, HeatCacheEntry, boost::hash<HeatKey> > curves; 
+} heat_curve_cache_t;
+
+/// A shared pointer for the heat curve cache, shared among copies of a model
+typedef boost::shared_ptr<heat_curve_cache_t> HeatCurveCachePtr;
+
 
 /** 
    @brief STCThermal is a skeleton component model that does nothing.
@@ -121,6 +162,52 @@ public:
    */
   Temp getTempChange(mat_rsrc_ptr mat, int the_time);
 
+  /**
+     Returns the heat curve for the composition of a material. The curve is 
+     computed once per composition as a dense dot product of the mass 
+     fractions with the rows of the STC array, and the peak is found in the 
+     same pass. Later materials with the same composition, to within 
+     heat_key_digits() significant digits of each mass fraction, reuse it.
+
+     @param mat the material whose composition defines the curve
+     @return the heat curve per kg of mat
+    */
+  HeatCurvePtr heatCurve(mat_rsrc_ptr mat);
+
+  /**
+     Returns the temperature change due to kg of a composition some time 
+     after its emplacement. Times between the tabulated timesteps are 
+     interpolated linearly, and the last value is held past the end.
+
+     @param heat the heat curve of the composition, from heatCurve()
+     @param kg the mass of the composition [kg]
+     @param elapsed the time since emplacement 
+     @return the temperature change [K]
+    */
+  Temp getTempChange(HeatCurvePtr heat, double kg, int elapsed);
+
+  /// returns the timesteps that the heat curves run over, in ascending order
+  const std::vector<int>& heatTimes();
+
+  /**
+     Returns the composition of a material as a HeatKey, with each mass 
+     fraction rounded to heat_key_digits() significant digits, so that 
+     compositions differing only by roundoff share a heat curve.
+
+     @param mat the material
+     @return the rounded (isotope, mass fraction) pairs of mat
+    */
+  static HeatKey heatKey(mat_rsrc_ptr mat);
+
+  /// the number of significant digits of each mass fraction in a HeatKey
+  static int heat_key_digits(){return 6;};
+
+  /// the most heat curves that a cache holds
+  static int max_heat_curves(){return 256;};
+
+  /// returns the number of heat curves in the cache
+  int n_heat_curves(){return heat_curves_ ? heat_curves_->curves.size() : 0;};
+
   /**
      return the thermal model implementation type
      
@@ -175,14 +262,16 @@ public:
   const double k_th() const {return k_th_;};
   /// returns spacing_, the spacing between waste packages (uniform grid) [m]
   const double spacing() const {return spacing_;};
-  /// returns spacing_, the spacing between waste packages (uniform grid) [m]
-  const double r_calc() const {return spacing_;};
+  /// returns r_calc_, the radius at which the temperature is calculated [m]
+  const double r_calc() const {return r_calc_;};
   /// returns mat_, the mat_t material through which to transport heat
   const std::string mat() const {return mat_;};
 
 protected:
   /**
-     initializes the STC map from the STCDB.
+     initializes the STC map from the STCDB. Parameters that are not 
+     tabulated in the database are interpolated from the surrounding 
+     tabulated parameters.
 
      @param mat the mat_t struct defining the near field material:w
      */
@@ -194,6 +283,12 @@ protected:
     */
   STCDataTablePtr table_;
 
+  /**
+     The heat curves per kg of the most recently seen compositions. This is 
+     reset whenever table_ changes and is shared with copies of this model.
+    */
+  HeatCurveCachePtr heat_curves_;
+
   /// the thermal diffusivity []
   double alpha_th_;
   /// the thermal conductivity []
@@ -11,6 +11,7 @@
 #include "CycException.h"
 #include "SolLim.h"
 #include "Material.h"
+#include "MatTools.h"
 
 using namespace std;
 
@@ -51,6 +52,10 @@ double SolLim::m_mf(double m_T, double K_d, double V_s, double V_f, double d){
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 double SolLim::m_aff(double m_ff, double V_ff, double C_sol){
+  // an unlimited element keeps m_ff, even with no free fluid to limit it
+  if( unlimited(C_sol) ) {
+    return m_ff;
+  }
   return min(C_sol*V_ff, m_ff);
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -59,3 +64,45 @@ double SolLim::m_ps(double m_T, double K_d, double V_s, double V_f, double d, do
   return (mff - m_aff(mff, V_f, C_sol));
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+elem_inventory_t SolLim::inventory(CompMapPtr comp, double mass, 
+    double threshold){
+  elem_inventory_t inv;
+  CompMap::const_iterator it;
+  for(it = (*comp).begin(); it != (*comp).end(); ++it){
+    if( (*it).second < threshold ) {
+      continue;
+    }
+    int elem = MatTools::isoToElem((*it).first);
+    double m_iso = (*it).second*mass;
+    if( inv.elems.empty() || inv.elems.back() != elem ) {
+      inv.elems.push_back(elem);
+      inv.m_T.push_back(0);
+    }
+    inv.m_T.back() += m_iso;
+    inv.isos.push_back((*it).first);
+    inv.iso_elem.push_back(inv.elems.size() - 1);
+    inv.iso_m_T.push_back(m_iso);
+  }
+  return inv;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void SolLim::m_ff(const vector<double>& m_T, const vector<double>& K_d, 
+    double V_s, double V_f, double d, vector<double>& m_ff){
+  SolLim::m_ff<double>(m_T, K_d, V_s, V_f, d, m_ff);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void SolLim::m_aff(const vector<double>& m_ff, double V_ff, 
+    const vector<double>& C_sol, vector<double>& m_aff){
+  SolLim::m_aff<double>(m_ff, V_ff, C_sol, m_aff);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<double> SolLim::partition(const elem_inventory_t& inv, 
+    const vector<double>& K_d, const vector<double>& C_sol, double V_s, 
+    double V_f, double V_ff, double d){
+  return partition<double>(inv, K_d, C_sol, V_s, V_f, V_ff, d);
+}
+
@@ -11,10 +11,27 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <assert.h>
+#include <cmath>
 
+#include "Dual.h"
 #include "IsoVector.h"
 #include "Material.h"
 
+/**
+   An inventory grouped by element into contiguous arrays, for the array 
+   kernels of SolLim. Isotope ids sort by element, so the isotopes of an 
+   element are contiguous and share its sorption and solubility limits.
+ */
+typedef struct elem_inventory_t
+{
+  std::vector<int> elems; /**< the elements in the inventory, sorted >**/
+  std::vector<double> m_T; /**< the total mass of each element [kg] >**/
+  std::vector<int> isos; /**< the isotopes in the inventory, sorted >**/
+  std::vector<int> iso_elem; /**< the index in elems of each isotope's element >**/
+  std::vector<double> iso_m_T; /**< the total mass of each isotope [kg] >**/
+} elem_inventory_t;
+
 /** 
    @brief SolLim is a toolkit for manipulating materials under 
    solubility limited conditions 
@@ -108,6 +125,13 @@ public:
     */
   static double m_aff(double m_ff, double V_ff, double C_sol);
 
+  /// returns true if a solubility limit leaves its element unlimited
+  static bool unlimited(double C_sol){return std::isinf(C_sol);};
+
+  /// @see unlimited(double)
+  template <int N>
+  static bool unlimited(const Dual<N>& C_sol){return std::isinf(C_sol.val());};
+
   /**
     Returns m_ps the contaminant mass that has precipitated into a solid form [kg]
 
@@ -121,5 +145,137 @@ public:
     @return m_ps the contaminant mass that has precipitated into a solid form [kg]
     */
   static double m_ps(double m_T, double K_d, double V_s, double V_f, double d, double C_sol);
+
+  /**
+    Groups a composition by element.
+
+    @param comp the normalized, massified composition
+    @param mass the total mass of the composition [kg]
+    @param threshold isotopes with a mass fraction below this are dropped
+
+    @return the inventory of the composition, grouped by element
+    */
+  static elem_inventory_t inventory(CompMapPtr comp, double mass, 
+      double threshold);
+
+  /**
+    Fills m_ff with the contaminant mass in the free fluid volume of each 
+    element, as m_ff(m_T, K_d, V_s, V_f, d) does for one.
+
+    @param m_T the total mass of each element [kg]
+    @param K_d the distribution coefficient of each element [m^3/kg]
+    @param V_s the solid volume [m^3]
+    @param V_f the fluid volume [m^3]
+    @param d the amount this component has degraded (a fraction)
+    @param m_ff the contaminant mass in the free fluid volume [kg], filled
+    */
+  static void m_ff(const std::vector<double>& m_T, 
+      const std::vector<double>& K_d, double V_s, double V_f, double d, 
+      std::vector<double>& m_ff);
+
+  /**
+    Fills m_aff with the available contaminant mass in the free fluid volume 
+    of each element, as m_aff(m_ff, V_ff, C_sol) does for one. An infinite 
+    C_sol leaves the element unlimited.
+
+    @param m_ff the contaminant mass in the free fluid volume [kg]
+    @param V_ff the free fluid volume [m^3]
+    @param C_sol the solubility limit of each element [kg/m^3]
+    @param m_aff the available contaminant mass [kg], filled
+    */
+  static void m_aff(const std::vector<double>& m_ff, double V_ff, 
+      const std::vector<double>& C_sol, std::vector<double>& m_aff);
+
+  /**
+    Partitions an entire inventory at once. Sorption and solubility are 
+    applied to the total mass of each element, and the available mass of 
+    each element is shared among its isotopes in proportion to their mass.
+
+    @param inv the inventory, grouped by element
+    @param K_d the distribution coefficient of each element [m^3/kg]
+    @param C_sol the solubility limit of each element [kg/m^3]
+    @param V_s the solid volume [m^3]
+    @param V_f the fluid volume [m^3]
+    @param V_ff the free fluid volume [m^3]
+    @param d the amount this component has degraded (a fraction)
+
+    @return the available contaminant mass of each of inv.isos [kg]
+    */
+  static std::vector<double> partition(const elem_inventory_t& inv, 
+      const std::vector<double>& K_d, const std::vector<double>& C_sol, 
+      double V_s, double V_f, double V_ff, double d);
+
+  /**
+    The array kernels above, for any scalar type, such as a Dual that 
+    carries the sensitivities of the partition to the parameters. Only 
+    the inventory is held in doubles. The double versions evaluate these.
+    */
+  template <typename T>
+  static void m_ff(const std::vector<double>& m_T, const std::vector<T>& K_d, 
+      T V_s, T V_f, T d, std::vector<T>& m_ff);
+
+  /// @see m_ff(const std::vector<double>&, const std::vector<T>&, T, T, T, std::vector<T>&)
+  template <typename T>
+  static void m_aff(const std::vector<T>& m_ff, T V_ff, 
+      const std::vector<T>& C_sol, std::vector<T>& m_aff);
+
+  /// @see m_ff(const std::vector<double>&, const std::vector<T>&, T, T, T, std::vector<T>&)
+  template <typename T>
+  static std::vector<T> partition(const elem_inventory_t& inv, 
+      const std::vector<T>& K_d, const std::vector<T>& C_sol, T V_s, T V_f, 
+      T V_ff, T d);
 };
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+void SolLim::m_ff(const std::vector<double>& m_T, const std::vector<T>& K_d, 
+    T V_s, T V_f, T d, std::vector<T>& m_ff){
+  assert(m_T.size() == K_d.size());
+  T theta = (V_s == 0) ? T(1) : V_f/V_s;
+  int n = m_T.size();
+  m_ff.resize(n);
+  for(int e = 0; e < n; ++e){
+    m_ff[e] = d*m_T[e]*theta/(K_d[e] - K_d[e]*theta + theta);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+void SolLim::m_aff(const std::vector<T>& m_ff, T V_ff, 
+    const std::vector<T>& C_sol, std::vector<T>& m_aff){
+  assert(m_ff.size() == C_sol.size());
+  int n = m_ff.size();
+  m_aff.resize(n);
+  for(int e = 0; e < n; ++e){
+    // an unlimited element keeps m_ff, even with no free fluid to limit it
+    if( unlimited(C_sol[e]) ) {
+      m_aff[e] = m_ff[e];
+      continue;
+    }
+    T limit = C_sol[e]*V_ff;
+    m_aff[e] = (limit < m_ff[e]) ? limit : m_ff[e];
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+template <typename T>
+std::vector<T> SolLim::partition(const elem_inventory_t& inv, 
+    const std::vector<T>& K_d, const std::vector<T>& C_sol, T V_s, 
+    T V_f, T V_ff, T d){
+  std::vector<T> elem_ff, elem_aff;
+  m_ff(inv.m_T, K_d, V_s, V_f, d, elem_ff);
+  m_aff(elem_ff, V_ff, C_sol, elem_aff);
+
+  int n_elems = inv.elems.size();
+  std::vector<T> frac(n_elems, T(0));
+  for(int e = 0; e < n_elems; ++e){
+    frac[e] = (inv.m_T[e] > 0) ? elem_aff[e]/inv.m_T[e] : T(0);
+  }
+  int n_isos = inv.isos.size();
+  std::vector<T> to_ret(n_isos, T(0));
+  for(int i = 0; i < n_isos; ++i){
+    to_ret[i] = frac[inv.iso_elem[i]]*inv.iso_m_T[i];
+  }
+  return to_ret;
+}
 #endif
@@ -63,6 +63,7 @@ void StubNuclide::absorb(mat_rsrc_ptr matToAdd)
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRSNuc") << "StubNuclide is absorbing material: ";
   wastes_.push_back(matToAdd);
+  invalidate_bc();
   matToAdd->print();
 }
 
@@ -75,6 +76,7 @@ mat_rsrc_ptr StubNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_rem
   LOG(LEV_DEBUG2,"GRSNuc") << "StubNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
   mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  invalidate_bc();
   update(TI->time());
   return to_ret;
 }
@@ -92,19 +94,14 @@ void StubNuclide::transportNuclides(int time){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void StubNuclide::update(int the_time){
+  invalidate_bc();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void StubNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
   std::vector<NuclideModelPtr>::iterator daughter;
-  std::pair<IsoVector, double> source_term;
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
-    source_term = (*daughter)->source_term_bc();
-    if( source_term.second > 0 ){
-      CompMapPtr comp_to_ext = CompMapPtr(source_term.first.comp());
-      double kg_to_ext=source_term.second;
-      absorb(mat_rsrc_ptr((*daughter)->extract(comp_to_ext, kg_to_ext)));
-    }
+    absorb_source_term(*daughter);
   }
 }
 
@@ -97,3 +97,89 @@ TEST_F(ComponentTest, copy) {
   EXPECT_EQ("STUB_THERMAL", test_copy->thermal_model()->name());
   EXPECT_EQ("DEGRATE_NUCLIDE", test_copy->nuclide_model()->name());
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, fill) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, ref_disp_, ref_kd_, ref_sol_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  test_component_->geom()->set_length(length_);
+  EXPECT_FLOAT_EQ(0, test_component_->fill());
+  EXPECT_FALSE(test_component_->isFull());
+
+  // each loaded daughter adds its length to the cached fill
+  ComponentPtr daughter = ComponentPtr(new Component(NULL));
+  daughter->geom()->set_length(0.6*length_);
+  test_component_->load(type_, daughter);
+  EXPECT_FLOAT_EQ(0.6*length_, test_component_->fill());
+  EXPECT_FALSE(test_component_->isFull());
+
+  ComponentPtr other = ComponentPtr(new Component(NULL));
+  other->geom()->set_length(0.6*length_);
+  test_component_->load(type_, other);
+  EXPECT_FLOAT_EQ(1.2*length_, test_component_->fill());
+  EXPECT_TRUE(test_component_->isFull());
+
+  // a copy starts out empty
+  ComponentPtr test_copy = ComponentPtr(new Component(NULL));
+  test_copy->copy(test_component_);
+  EXPECT_FLOAT_EQ(0, test_copy->fill());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, inert) {
+  EXPECT_FLOAT_EQ(0, test_component_->inert_kg());
+  // screened mass accumulates in the waste form and is never released
+  test_component_->absorb_inert(2);
+  test_component_->absorb_inert(0.5);
+  EXPECT_FLOAT_EQ(2.5, test_component_->inert_kg());
+  EXPECT_THROW(test_component_->absorb_inert(-1), CycRangeException);
+  EXPECT_FLOAT_EQ(2.5, test_component_->inert_kg());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, prototype) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, ref_disp_, ref_kd_, ref_sol_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  // a template is its own prototype, and records its own params
+  EXPECT_EQ(test_component_, test_component_->prototype());
+  EXPECT_EQ(test_component_->ID(), test_component_->nuclide_model()->params_id());
+
+  // a copy shares the params of its prototype
+  ComponentPtr test_copy = ComponentPtr(new Component(NULL));
+  test_copy->copy(test_component_);
+  EXPECT_EQ(test_component_, test_copy->prototype());
+  EXPECT_NE(test_component_->ID(), test_copy->ID());
+  EXPECT_EQ(test_component_->ID(), test_copy->nuclide_model()->params_id());
+
+  // as does a copy of a copy
+  ComponentPtr copy_of_copy = ComponentPtr(new Component(NULL));
+  copy_of_copy->copy(test_copy);
+  EXPECT_EQ(test_component_, copy_of_copy->prototype());
+  EXPECT_EQ(test_component_->ID(), copy_of_copy->nuclide_model()->params_id());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, contaminantTolerance) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, ref_disp_, ref_kd_, ref_sol_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  // by default every contaminant is recorded at every timestep
+  EXPECT_FALSE(test_component_->delta_encoded());
+  EXPECT_THROW(test_component_->set_contaminant_tol(-0.1, 0, 0), CycRangeException);
+  EXPECT_THROW(test_component_->set_contaminant_tol(0.1, -1, 0), CycRangeException);
+  EXPECT_THROW(test_component_->set_contaminant_tol(0.1, 0, -1), CycRangeException);
+  EXPECT_FALSE(test_component_->delta_encoded());
+
+  EXPECT_NO_THROW(test_component_->set_contaminant_tol(0.01, 1e-12, 1e-9));
+  EXPECT_TRUE(test_component_->delta_encoded());
+  EXPECT_FLOAT_EQ(0.01, test_component_->rel_tol());
+  EXPECT_FLOAT_EQ(1e-12, test_component_->abs_tol());
+  EXPECT_FLOAT_EQ(1e-9, test_component_->abs_conc_tol());
+
+  // a copy encodes its contaminants the same way
+  ComponentPtr test_copy = ComponentPtr(new Component(NULL));
+  test_copy->copy(test_component_);
+  EXPECT_TRUE(test_copy->delta_encoded());
+  EXPECT_FLOAT_EQ(0.01, test_copy->rel_tol());
+  EXPECT_FLOAT_EQ(1e-12, test_copy->abs_tol());
+  EXPECT_FLOAT_EQ(1e-9, test_copy->abs_conc_tol());
+}
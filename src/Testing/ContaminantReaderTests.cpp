@@ -0,0 +1,160 @@
+// ContaminantReaderTests.cpp
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <boost/bind.hpp>
+
+#include "ContaminantReader.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class ContaminantReaderTest : public ::testing::Test {
+  protected:
+    int encoded_id_, copy_id_, full_id_, u235_, am241_;
+    string file_;
+
+    virtual void SetUp(){
+      encoded_id_ = 7;
+      copy_id_ = 9;
+      full_id_ = 8;
+      u235_ = 92235;
+      am241_ = 95241;
+      file_ = "contaminant_reader_test.sqlite";
+      remove(file_.c_str());
+      sqlite3* db;
+      sqlite3_open(file_.c_str(), &db);
+      stringstream sql;
+      sql << "CREATE TABLE contaminants (CompID INTEGER, Time INTEGER, "
+          << "IsoID INTEGER, MassKG REAL, AvailConc REAL);"
+          << "CREATE TABLE NuclideModelParams (CompID INTEGER, "
+          << "ParamName TEXT, ParamVal REAL);"
+          << "CREATE TABLE components (compID INTEGER, paramsID INTEGER);"
+          // the copy shares the parameters of the encoded component
+          << "INSERT INTO components VALUES (" << encoded_id_ << ", "
+          << encoded_id_ << ");"
+          << "INSERT INTO components VALUES (" << copy_id_ << ", "
+          << encoded_id_ << ");"
+          << "INSERT INTO components VALUES (" << full_id_ << ", "
+          << full_id_ << ");"
+          << "INSERT INTO NuclideModelParams VALUES (" << encoded_id_
+          << ", 'contaminant_rel_tol', 0.01);"
+          << "INSERT INTO NuclideModelParams VALUES (" << encoded_id_
+          << ", 'contaminant_abs_tol', 0);"
+          // the encoded component changes at 2, 5 and empties at 8
+          << "INSERT INTO contaminants VALUES (" << encoded_id_ << ", 2, "
+          << u235_ << ", 1, 0.1);"
+          << "INSERT INTO contaminants VALUES (" << encoded_id_ << ", 5, "
+          << u235_ << ", 3, 0.3);"
+          << "INSERT INTO contaminants VALUES (" << encoded_id_ << ", 8, "
+          << u235_ << ", 0, 0);"
+          // the full component holds americium at 3 and 4 only
+          << "INSERT INTO contaminants VALUES (" << full_id_ << ", 3, "
+          << am241_ << ", 2, 0.2);"
+          << "INSERT INTO contaminants VALUES (" << full_id_ << ", 4, "
+          << am241_ << ", 2, 0.2);";
+      sqlite3_exec(db, sql.str().c_str(), NULL, NULL, NULL);
+      sqlite3_close(db);
+    }
+
+    virtual void TearDown(){
+      remove(file_.c_str());
+    }
+
+  public:
+    /// notes the key and total mass of each history handed on by each()
+    void visit(vector<comp_iso_t>* keys, vector<double>* totals,
+        const comp_iso_t& key, const contaminant_series_t& history){
+      keys->push_back(key);
+      double total = 0;
+      for(size_t t = 0; t < history.kg.size(); ++t){
+        total += history.kg[t];
+      }
+      totals->push_back(total);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ContaminantReaderTest, encoded){
+  ContaminantReader reader(file_);
+  EXPECT_TRUE(reader.encoded(encoded_id_));
+  EXPECT_TRUE(reader.encoded(copy_id_));
+  EXPECT_FALSE(reader.encoded(full_id_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ContaminantReaderTest, series){
+  ContaminantReader reader(file_);
+  double kg[] = {0, 0, 1, 1, 1, 3, 3, 3, 0, 0};
+  contaminant_series_t held = reader.series(encoded_id_, u235_, 0, 10);
+  ASSERT_EQ(10, held.kg.size());
+  for(int t = 0; t < 10; ++t){
+    EXPECT_FLOAT_EQ(kg[t], held.kg[t]);
+    EXPECT_FLOAT_EQ(kg[t]/10, held.conc[t]);
+  }
+  // rows before t0 are held into the window
+  held = reader.series(encoded_id_, u235_, 6, 9);
+  ASSERT_EQ(3, held.kg.size());
+  EXPECT_FLOAT_EQ(3, held.kg[0]);
+  EXPECT_FLOAT_EQ(3, held.kg[1]);
+  EXPECT_FLOAT_EQ(0, held.kg[2]);
+
+  contaminant_series_t full = reader.series(full_id_, am241_, 0, 10);
+  for(int t = 0; t < 10; ++t){
+    EXPECT_FLOAT_EQ((t == 3 || t == 4) ? 2 : 0, full.kg[t]);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ContaminantReaderTest, all){
+  ContaminantReader reader(file_);
+  map<comp_iso_t, contaminant_series_t> histories = reader.all(0, 10);
+  ASSERT_EQ(2, histories.size());
+  contaminant_series_t held = reader.series(encoded_id_, u235_, 0, 10);
+  contaminant_series_t full = reader.series(full_id_, am241_, 0, 10);
+  EXPECT_EQ(held.kg, histories[make_pair(encoded_id_, u235_)].kg);
+  EXPECT_EQ(held.conc, histories[make_pair(encoded_id_, u235_)].conc);
+  EXPECT_EQ(full.kg, histories[make_pair(full_id_, am241_)].kg);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ContaminantReaderTest, each){
+  // each history is handed on in order, as soon as it is rebuilt
+  ContaminantReader reader(file_);
+  vector<comp_iso_t> keys;
+  vector<double> totals;
+  reader.each(0, 10, boost::bind(&ContaminantReaderTest::visit, this, &keys,
+        &totals, _1, _2));
+  map<comp_iso_t, contaminant_series_t> histories = reader.all(0, 10);
+  ASSERT_EQ(histories.size(), keys.size());
+  map<comp_iso_t, contaminant_series_t>::const_iterator history;
+  int i = 0;
+  for(history = histories.begin(); history != histories.end(); ++history){
+    EXPECT_EQ((*history).first, keys[i]);
+    double total = 0;
+    for(size_t t = 0; t < (*history).second.kg.size(); ++t){
+      total += (*history).second.kg[t];
+    }
+    EXPECT_FLOAT_EQ(total, totals[i]);
+    ++i;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ContaminantReaderTest, holdEndsWithRun){
+  ContaminantReader reader(file_);
+  EXPECT_EQ(8, reader.last_time());
+  // the last row is held through the end of the run, and no further
+  vector<contaminant_point_t> points;
+  contaminant_point_t point = {2, 1, 0.1};
+  points.push_back(point);
+  contaminant_series_t held = ContaminantReader::rebuild(points, true, 0, 10,
+      5);
+  for(int t = 0; t < 10; ++t){
+    EXPECT_FLOAT_EQ((t >= 2 && t <= 5) ? 1 : 0, held.kg[t]);
+    EXPECT_FLOAT_EQ((t >= 2 && t <= 5) ? 0.1 : 0, held.conc[t]);
+  }
+}
@@ -4,6 +4,8 @@
 
 #include "Cyder.h"
 #include "CyderTests.h"
+#include "MaterialDB.h"
+#include "STCDB.h"
 #include "XMLQueryEngine.h"
 #include "Timer.h"
 
@@ -23,6 +25,7 @@ void CyderTest::SetUp(){
   capacity_ = 100;
   t_lim_ = 100;
   in_commod_ = "in_commod";
+  other_commod_ = "other_commod";
   inventory_size_ = 70000;
   lifetime_ = 3000000;
   start_op_yr_ = 1; 
@@ -60,13 +63,19 @@ void CyderTest::SetUp(){
   (*cold_comp_)[Cs135_] = 1;
 
   hot_mat_ = mat_rsrc_ptr(new Material(hot_comp_));
+  hot_mat_->setQuantity(2000);
   cold_mat_ = mat_rsrc_ptr(new Material(cold_comp_));
+  cold_mat_->setQuantity(1);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void CyderTest::TearDown() { 
   delete src_facility_;
   delete incommod_market;
+  delete other_market;
+  // the facility froze the databases, which other tests still populate
+  MDB->thaw();
+  SDB->thaw();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -88,12 +97,19 @@ Cyder* CyderTest::initSrcFacility(){
          << "  <capacity>" << capacity_ << "</capacity>"
          << "  <limiting_temp>" << t_lim_ << "</limiting_temp>"
          << "  <incommodity>" << in_commod_ << "</incommodity>"
+         << "  <incommodity>" << other_commod_ << "</incommodity>"
          << "  <inventorysize>" << inventory_size_ << "</inventorysize>"
          << "  <lifetime>" << lifetime_ << "</lifetime>"
          << "  <startOperMonth>" << start_op_mo_ << "</startOperMonth>"
          << "  <startOperYear>" << start_op_yr_ << "</startOperYear>"
          << "  <thermalmodel>"
-         << "    <STCThermal/>"
+         << "    <STCThermal>"
+         << "      <alpha_th>2.5</alpha_th>"
+         << "      <k_th>0.25</k_th>"
+         << "      <material_data>clay</material_data>"
+         << "      <r_calc>2</r_calc>"
+         << "      <spacing>20</spacing>"
+         << "    </STCThermal>"
          << "  </thermalmodel>"
          << "  <component>"
          << "    <name>" << wfname_ << "</name>" 
@@ -110,6 +126,7 @@ Cyder* CyderTest::initSrcFacility(){
          << "      <StubNuclide/>"
          << "    </nuclidemodel>"
          << "    <allowedcommod>" << in_commod_ << "</allowedcommod>" 
+         << "    <allowedcommod>" << other_commod_ << "</allowedcommod>" 
          << "  </component>"
          << "  <component>"
          << "    <name>" << wpname_ << "</name>" 
@@ -172,6 +189,9 @@ void CyderTest::initWorld(){
   incommod_market = new TestMarket();
   incommod_market->setCommodity(in_commod_);
   MarketModel::registerMarket(incommod_market);
+  other_market = new TestMarket();
+  other_market->setCommodity(other_commod_);
+  MarketModel::registerMarket(other_market);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -183,6 +203,94 @@ TEST_F(CyderTest, initial_state) {
   EXPECT_EQ(t_lim_, src_facility_->t_lim());
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_F(CyderTest, running_totals) {
+  Transaction trans(src_facility_, OFFER);
+  trans.setCommod(in_commod_);
+  std::vector<rsrc_ptr> manifest;
+  manifest.push_back(boost::dynamic_pointer_cast<Resource>(cold_mat_));
+  manifest.push_back(boost::dynamic_pointer_cast<Resource>(hot_mat_));
+  double kg = cold_mat_->quantity() + hot_mat_->quantity();
+  ASSERT_NO_THROW(src_facility_->addResource(trans, manifest));
+  EXPECT_FLOAT_EQ(kg, src_facility_->checkStocks());
+  EXPECT_FLOAT_EQ(kg, src_facility_->checkStocks(in_commod_));
+  EXPECT_FLOAT_EQ(0, src_facility_->checkStocks(other_commod_));
+  EXPECT_FLOAT_EQ(0, src_facility_->checkInventory(in_commod_));
+  // the stocks of a commodity count against its monthly acceptance
+  EXPECT_FLOAT_EQ(std::max(0.0, capacity_ - kg), 
+      src_facility_->getCapacity(in_commod_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_F(CyderTest, plan_requests) {
+  EXPECT_EQ(PROPORTIONAL, Cyder::requestPolicyEnum("PROPORTIONAL"));
+  EXPECT_EQ(PRIORITY, Cyder::requestPolicyEnum("PRIORITY"));
+  EXPECT_EQ(THERMAL, Cyder::requestPolicyEnum("THERMAL"));
+  EXPECT_EQ(LAST_REQUEST_POLICY, Cyder::requestPolicyEnum("BOGUS"));
+
+  // with nothing received, the two incommodities split the capacity evenly
+  EXPECT_EQ(PROPORTIONAL, src_facility_->request_policy());
+  EXPECT_FLOAT_EQ(capacity_, src_facility_->getCapacity());
+  std::map<std::string, double> plan = src_facility_->planRequests();
+  ASSERT_EQ(2, plan.size());
+  EXPECT_FLOAT_EQ(capacity_/2, plan[in_commod_]);
+  EXPECT_FLOAT_EQ(capacity_/2, plan[other_commod_]);
+  src_facility_->set_request_policy(PRIORITY);
+  plan = src_facility_->planRequests();
+  EXPECT_FLOAT_EQ(capacity_*2/3, plan[in_commod_]);
+  EXPECT_FLOAT_EQ(capacity_/3, plan[other_commod_]);
+  src_facility_->set_request_policy(THERMAL);
+  plan = src_facility_->planRequests();
+  EXPECT_FLOAT_EQ(capacity_/2, plan[in_commod_]);
+  EXPECT_FLOAT_EQ(capacity_/2, plan[other_commod_]);
+
+  // the stocks count against the capacity, and PROPORTIONAL follows them
+  Transaction trans(src_facility_, OFFER);
+  trans.setCommod(in_commod_);
+  std::vector<rsrc_ptr> manifest;
+  manifest.push_back(boost::dynamic_pointer_cast<Resource>(cold_mat_));
+  ASSERT_NO_THROW(src_facility_->addResource(trans, manifest));
+  src_facility_->set_request_policy(PROPORTIONAL);
+  plan = src_facility_->planRequests();
+  double budget = capacity_ - cold_mat_->quantity();
+  double mean = cold_mat_->quantity()/2;
+  double in_weight = cold_mat_->quantity() + mean;
+  EXPECT_FLOAT_EQ(budget*in_weight/(in_weight + mean), plan[in_commod_]);
+  EXPECT_FLOAT_EQ(budget*mean/(in_weight + mean), plan[other_commod_]);
+  EXPECT_FLOAT_EQ(budget, plan[in_commod_] + plan[other_commod_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_F(CyderTest, plan_requests_redistributed) {
+  // a hot commodity is capped by the mass the thermal headroom could hold 
+  // and the cold commodity takes what it leaves unused
+  src_facility_->set_request_policy(THERMAL);
+  hot_mat_->setQuantity(1);
+  Transaction hot_trans(src_facility_, OFFER);
+  hot_trans.setCommod(in_commod_);
+  std::vector<rsrc_ptr> hot_manifest;
+  hot_manifest.push_back(boost::dynamic_pointer_cast<Resource>(hot_mat_));
+  ASSERT_NO_THROW(src_facility_->addResource(hot_trans, hot_manifest));
+  Transaction cold_trans(src_facility_, OFFER);
+  cold_trans.setCommod(other_commod_);
+  std::vector<rsrc_ptr> cold_manifest;
+  cold_manifest.push_back(boost::dynamic_pointer_cast<Resource>(cold_mat_));
+  ASSERT_NO_THROW(src_facility_->addResource(cold_trans, cold_manifest));
+
+  double budget = src_facility_->getCapacity();
+  double hot_cap = src_facility_->requestCap(in_commod_);
+  double cold_cap = src_facility_->requestCap(other_commod_);
+  EXPECT_GE(src_facility_->getCapacity(in_commod_), hot_cap);
+  EXPECT_LE(hot_cap, cold_cap);
+
+  std::map<std::string, double> plan = src_facility_->planRequests();
+  double hot_share = std::min(hot_cap, budget/2);
+  EXPECT_FLOAT_EQ(hot_share, plan[in_commod_]);
+  EXPECT_FLOAT_EQ(std::min(cold_cap, budget - hot_share), 
+      plan[other_commod_]);
+  EXPECT_GE(budget, plan[in_commod_] + plan[other_commod_]);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 TEST_F(CyderTest, assess_capacity_crude){
   EXPECT_NO_THROW(src_facility_->handleTick(time_));
@@ -18,12 +18,13 @@ protected:
   double binnerradius_, bouterradius_;
   double ffinnerradius_, ffouterradius_; 
   double x_,y_,z_,dx_,dy_,dz_,adv_vel_,capacity_,t_lim_,inventory_size_;
-  std::string in_commod_, cname_, componenttype_;
+  std::string in_commod_, other_commod_, cname_, componenttype_;
   std::string wfname_, wftype_;
   std::string wpname_, wptype_;
   std::string bname_, btype_;
   std::string ffname_, fftype_;
   TestMarket* incommod_market;
+  TestMarket* other_market;
 
   Temp high_t_lim_, low_t_lim_;
   Radius far_r_lim_, near_r_lim_;
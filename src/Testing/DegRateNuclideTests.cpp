@@ -418,6 +418,42 @@ TEST_F(DegRateNuclideTest, calc_conc_grad) {
   EXPECT_THROW( deg_rate_ptr_->calc_conc_grad(c_out, c_in, r_in, numeric_limits<double>::infinity()), CycRangeException); 
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, bc_snapshot){ 
+  deg_rate_= 1;
+  EXPECT_NO_THROW(deg_rate_ptr_->set_geom(geom_));
+  IsoConcMap zero_conc_map;
+  zero_conc_map[92235] = 0;
+  double outer_radius = nuc_model_ptr_->geom()->outer_radius();
+  ASSERT_NO_THROW(deg_rate_ptr_->set_deg_rate(deg_rate_));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_++));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
+
+  // the snapshot matches the full boundary conditions
+  const BCSnapshot& bc = nuc_model_ptr_->bc_snapshot(zero_conc_map, outer_radius*2);
+  EXPECT_FLOAT_EQ(nuc_model_ptr_->source_term_bc().second, bc.source_term.second);
+  IsoConcMap dirichlet = nuc_model_ptr_->dirichlet_bc();
+  EXPECT_EQ(dirichlet.size(), bc.dirichlet_map.size());
+  EXPECT_FLOAT_EQ(dirichlet[u235_], nuc_model_ptr_->dirichlet_bc(u235_));
+  EXPECT_FLOAT_EQ(test_size_, nuc_model_ptr_->source_term_bc(u235_));
+  ConcGradMap neumann = nuc_model_ptr_->neumann_bc(zero_conc_map, outer_radius*2);
+  EXPECT_FLOAT_EQ(neumann[u235_], 
+      nuc_model_ptr_->neumann_bc(zero_conc_map, outer_radius*2, u235_));
+  IsoFluxMap cauchy = nuc_model_ptr_->cauchy_bc(zero_conc_map, outer_radius*2);
+  EXPECT_FLOAT_EQ(cauchy[u235_], 
+      nuc_model_ptr_->cauchy_bc(zero_conc_map, outer_radius*2, u235_));
+  // isotopes that are not present are zero
+  EXPECT_FLOAT_EQ(0, nuc_model_ptr_->dirichlet_bc(1001));
+
+  // extraction invalidates the snapshot
+  CompMapPtr extract_comp = nuc_model_ptr_->source_term_bc().first.comp();
+  double extract_mass = nuc_model_ptr_->source_term_bc().second;
+  EXPECT_NO_THROW(nuc_model_ptr_->extract(extract_comp, extract_mass));
+  EXPECT_FLOAT_EQ(0, nuc_model_ptr_->bc_snapshot().source_term.second);
+  EXPECT_FLOAT_EQ(0, nuc_model_ptr_->dirichlet_bc(u235_));
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 INSTANTIATE_TEST_CASE_P(DegRateNuclideModel, NuclideModelTests, Values(&DegRateNuclideModelConstructor));
 
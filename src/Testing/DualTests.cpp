@@ -0,0 +1,60 @@
+// DualTests.cpp
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "Dual.h"
+
+using namespace std;
+
+typedef Dual<2> dual2_t;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(DualTest, seed){
+  dual2_t x = dual2_t::seed(3, 0);
+  EXPECT_FLOAT_EQ(3, x.val());
+  EXPECT_FLOAT_EQ(1, x.d(0));
+  EXPECT_FLOAT_EQ(0, x.d(1));
+  dual2_t c(5);
+  EXPECT_FLOAT_EQ(5, c.val());
+  EXPECT_FLOAT_EQ(0, c.d(0));
+  EXPECT_FLOAT_EQ(0, c.d(1));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(DualTest, arithmetic){
+  double x0 = 3;
+  double y0 = 2;
+  dual2_t x = dual2_t::seed(x0, 0);
+  dual2_t y = dual2_t::seed(y0, 1);
+  // f = x*y/(x+1) - 2y
+  dual2_t f = x*y/(x+1) - 2*y;
+  EXPECT_FLOAT_EQ(x0*y0/(x0+1) - 2*y0, f.val());
+  EXPECT_FLOAT_EQ(y0/((x0+1)*(x0+1)), f.d(0));
+  EXPECT_FLOAT_EQ(x0/(x0+1) - 2, f.d(1));
+  dual2_t g = -f;
+  EXPECT_FLOAT_EQ(-f.d(0), g.d(0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(DualTest, functions){
+  double x0 = 0.5;
+  dual2_t x = dual2_t::seed(x0, 0);
+  EXPECT_FLOAT_EQ(exp(x0), exp(x).d(0));
+  EXPECT_FLOAT_EQ(3*x0*x0, pow(x, 3).d(0));
+  EXPECT_FLOAT_EQ(0.5/sqrt(x0), sqrt(x).d(0));
+  EXPECT_FLOAT_EQ(x0, primal(x));
+  EXPECT_FLOAT_EQ(x0, primal(x0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(DualTest, comparisons){
+  // comparisons follow the values, so a min takes the double's branch
+  dual2_t x = dual2_t::seed(1, 0);
+  dual2_t y = dual2_t::seed(2, 1);
+  EXPECT_TRUE(x < y);
+  EXPECT_FALSE(x == y);
+  EXPECT_TRUE(x == 1);
+  dual2_t m = (y < x) ? y : x;
+  EXPECT_FLOAT_EQ(1, m.d(0));
+  EXPECT_FLOAT_EQ(0, m.d(1));
+}
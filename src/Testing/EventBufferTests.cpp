@@ -0,0 +1,99 @@
+// EventBufferTests.cpp
+#include <vector>
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "EventBuffer.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class EventBufferTest : public ::testing::Test {
+  protected:
+    int u235_, am241_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      am241_ = 95241;
+      EB->takeContaminants();
+      EB->takeParams();
+    }
+
+    virtual void TearDown(){
+      EB->takeContaminants();
+      EB->takeParams();
+    }
+
+  public:
+    /// adds the rows of one component over several timesteps
+    void addRows(int comp_id){
+      for(int t = 3; t >= 0; --t){
+        EB->addContaminant(t, comp_id, am241_, comp_id, 0);
+        EB->addContaminant(t, comp_id, u235_, comp_id, 0);
+      }
+      EB->addParam(comp_id, "porosity", 0.1);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(EventBufferTest, order){
+  addRows(2);
+  addRows(1);
+  EXPECT_EQ(18, EB->size());
+  vector<contaminant_row_t> rows = EB->takeContaminants();
+  ASSERT_EQ(16, rows.size());
+  EXPECT_EQ(0, rows.front().time);
+  EXPECT_EQ(1, rows.front().comp_id);
+  EXPECT_EQ(u235_, rows.front().iso);
+  EXPECT_EQ(3, rows.back().time);
+  EXPECT_EQ(2, rows.back().comp_id);
+  EXPECT_EQ(am241_, rows.back().iso);
+
+  vector<param_row_t> params = EB->takeParams();
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(1, params[0].comp_id);
+  EXPECT_EQ(0, EB->size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(EventBufferTest, threads){
+  // the merged rows are the same however the components were divided
+  for(int c = 0; c < 4; ++c){
+    addRows(c);
+  }
+  vector<contaminant_row_t> serial = EB->takeContaminants();
+  EB->takeParams();
+
+  boost::thread_group workers;
+  for(int c = 3; c >= 0; --c){
+    workers.create_thread(boost::bind(&EventBufferTest::addRows, this, c));
+  }
+  workers.join_all();
+  vector<contaminant_row_t> parallel = EB->takeContaminants();
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  for(size_t r = 0; r < serial.size(); ++r){
+    EXPECT_EQ(serial[r].time, parallel[r].time);
+    EXPECT_EQ(serial[r].comp_id, parallel[r].comp_id);
+    EXPECT_EQ(serial[r].iso, parallel[r].iso);
+  }
+  EXPECT_EQ(4, EB->takeParams().size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(EventBufferTest, prune){
+  // the buffers of exited threads are dropped once their rows are taken
+  addRows(0);
+  int live = EB->n_buffers();
+  boost::thread_group workers;
+  for(int c = 1; c < 4; ++c){
+    workers.create_thread(boost::bind(&EventBufferTest::addRows, this, c));
+  }
+  workers.join_all();
+  EXPECT_EQ(live + 3, EB->n_buffers());
+  EXPECT_EQ(32, EB->takeContaminants().size());
+  EXPECT_EQ(live + 3, EB->n_buffers());
+  EXPECT_EQ(4, EB->takeParams().size());
+  EXPECT_EQ(live, EB->n_buffers());
+}
@@ -0,0 +1,160 @@
+// FarFieldGridTests.cpp
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "CycException.h"
+#include "EventBuffer.h"
+#include "FarFieldGrid.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class FarFieldGridTest : public ::testing::Test {
+  protected:
+    double x_, y_, z_, v_, D_, kg_;
+    int nx_, ny_, nz_;
+    Iso u235_;
+    CompMapPtr comp_;
+    point_t center_;
+
+    virtual void SetUp(){
+      // odd counts of cubic cells, so the center cell is central
+      x_ = 90;
+      y_ = 50;
+      z_ = 50;
+      nx_ = 9;
+      ny_ = 5;
+      nz_ = 5;
+      // about 8 cells per month, so the advection is sub-cycled
+      v_ = 3e-5;
+      D_ = 1e-4;
+      kg_ = 10;
+      u235_ = 92235;
+      comp_ = CompMapPtr(new CompMap(MASS));
+      (*comp_)[u235_] = 1;
+      point_t center = {x_/2, y_/2, z_/2};
+      center_ = center;
+    }
+
+  public:
+    /// releases kg_ at the upstream end and transports for n months
+    FarFieldGridPtr run(double v, int n_blocks, int n){
+      FarFieldGridPtr grid = FarFieldGrid::create(x_, y_, z_, nx_, ny_, nz_,
+          v, D_, n_blocks);
+      grid->transportNuclides(0);
+      point_t loc = {x_/nx_/2, y_/2, z_/2};
+      grid->addRelease(v == 0 ? center_ : loc, comp_, kg_);
+      for(int t = 1; t <= n; ++t){
+        grid->transportNuclides(t);
+      }
+      return grid;
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, constructor){
+  FarFieldGridPtr grid = FarFieldGrid::create(x_, y_, z_, nx_, ny_, nz_, v_,
+      D_, 3);
+  EXPECT_EQ(nx_, grid->nx());
+  EXPECT_EQ(ny_, grid->ny());
+  EXPECT_EQ(nz_, grid->nz());
+  EXPECT_EQ(3, grid->n_blocks());
+  EXPECT_FLOAT_EQ(0, grid->mass(u235_));
+  // a slab is at least one plane thick
+  EXPECT_EQ(nx_, FarFieldGrid::create(x_, y_, z_, nx_, ny_, nz_, v_, D_,
+        2*nx_)->n_blocks());
+  EXPECT_THROW(FarFieldGrid::create(x_, y_, z_, 0, ny_, nz_, v_, D_, 1),
+      CycRangeException);
+  EXPECT_THROW(FarFieldGrid::create(x_, y_, z_, nx_, ny_, nz_, v_, D_, 0),
+      CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, addRelease){
+  FarFieldGridPtr grid = FarFieldGrid::create(x_, y_, z_, nx_, ny_, nz_, v_,
+      D_, 1);
+  grid->addRelease(center_, comp_, kg_);
+  double cell_vol = (x_/nx_)*(y_/ny_)*(z_/nz_);
+  EXPECT_FLOAT_EQ(kg_/cell_vol, grid->conc(center_, u235_));
+  EXPECT_FLOAT_EQ(kg_, grid->mass(u235_));
+  // releases beyond the domain land in the nearest cell
+  point_t outside = {2*x_, -y_, z_/2};
+  grid->addRelease(outside, comp_, kg_);
+  EXPECT_FLOAT_EQ(2*kg_, grid->mass(u235_));
+  EXPECT_FLOAT_EQ(kg_/cell_vol, grid->conc(outside, u235_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, conservation){
+  FarFieldGridPtr grid = run(v_, 1, 4);
+  EXPECT_GT(grid->outflow(u235_), 0);
+  EXPECT_GT(grid->mass(u235_), 0);
+  EXPECT_NEAR(kg_, grid->mass(u235_) + grid->outflow(u235_), 1e-9*kg_);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, blocks){
+  FarFieldGridPtr serial = run(v_, 1, 3);
+  FarFieldGridPtr parallel = run(v_, 4, 3);
+  EXPECT_DOUBLE_EQ(serial->outflow(u235_), parallel->outflow(u235_));
+  for(int i = 0; i < nx_; ++i){
+    point_t loc = {(i + 0.5)*x_/nx_, y_/2, z_/2};
+    EXPECT_DOUBLE_EQ(serial->conc(loc, u235_), parallel->conc(loc, u235_));
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, dispersion){
+  FarFieldGridPtr grid = run(0, 3, 2);
+  // nothing leaves and the release spreads evenly in every direction
+  EXPECT_FLOAT_EQ(0, grid->outflow(u235_));
+  EXPECT_NEAR(kg_, grid->mass(u235_), 1e-9*kg_);
+  double dx = x_/nx_;
+  point_t up = {center_.x_ - dx, center_.y_, center_.z_};
+  point_t down = {center_.x_ + dx, center_.y_, center_.z_};
+  point_t side = {center_.x_, center_.y_ - dx, center_.z_};
+  point_t below = {center_.x_, center_.y_, center_.z_ + dx};
+  double peak = grid->conc(center_, u235_);
+  EXPECT_GT(grid->conc(up, u235_), 0);
+  EXPECT_LT(grid->conc(up, u235_), peak);
+  EXPECT_NEAR(grid->conc(up, u235_), grid->conc(down, u235_), 1e-9*peak);
+  EXPECT_GT(grid->conc(side, u235_), 0);
+  EXPECT_NEAR(grid->conc(side, u235_), grid->conc(below, u235_), 1e-9*peak);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, large_dispersion){
+  // a dispersion number in the hundreds of thousands, far beyond what 
+  // Jacobi sweeps could converge, nearly evens out the release in a month
+  D_ = 10;
+  FarFieldGridPtr serial;
+  ASSERT_NO_THROW(serial = run(0, 1, 1));
+  EXPECT_NEAR(kg_, serial->mass(u235_), 1e-9*kg_);
+  double mean = kg_/(x_*y_*z_);
+  point_t corner = {0, 0, 0};
+  EXPECT_NEAR(mean, serial->conc(corner, u235_), 1e-3*mean);
+  EXPECT_NEAR(mean, serial->conc(center_, u235_), 1e-3*mean);
+
+  FarFieldGridPtr parallel = run(0, 4, 1);
+  for(int i = 0; i < nx_; ++i){
+    point_t loc = {(i + 0.5)*x_/nx_, 0, z_/2};
+    EXPECT_DOUBLE_EQ(serial->conc(loc, u235_), parallel->conc(loc, u235_));
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(FarFieldGridTest, record){
+  FarFieldGridPtr grid = run(0, 2, 1);
+  EB->takeFarFieldConcs();
+  grid->record(1);
+  vector<far_field_row_t> rows = EB->takeFarFieldConcs();
+  EXPECT_GT(rows.size(), 1);
+  EXPECT_LE(rows.size(), nx_*ny_*nz_);
+  // only the cells near the peak are recorded as the tolerance rises
+  grid->set_record_tol(1);
+  grid->record(1);
+  rows = EB->takeFarFieldConcs();
+  ASSERT_EQ(1, rows.size());
+  EXPECT_DOUBLE_EQ(grid->peak(u235_), rows[0].conc);
+  EXPECT_EQ(nx_/2, rows[0].i);
+}
@@ -102,3 +102,24 @@ TEST_F(GeometryTest, surface_area){
   EXPECT_NO_THROW(default_geom_->set_length(len_five_));
   EXPECT_FLOAT_EQ(2*M_PI*r_five_*(r_five_ + len_five_) , default_geom_->surface_area());
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(GeometryTest, revision){
+  // the derived quantities change only through the setters
+  int rev = test_geom_->revision();
+  EXPECT_EQ(rev, test_geom_->revision());
+  point_t origin = {0,0,0};
+  test_geom_->set_centroid(origin);
+  EXPECT_EQ(rev, test_geom_->revision());
+
+  test_geom_->set_length(2*len_five_);
+  EXPECT_NE(rev, test_geom_->revision());
+  EXPECT_FLOAT_EQ(2*M_PI*len_five_*(r_five_*r_five_-r_four_*r_four_), test_geom_->volume());
+  EXPECT_FLOAT_EQ(2*M_PI*r_five_*(r_five_+2*len_five_), test_geom_->surface_area());
+
+  rev = test_geom_->revision();
+  test_geom_->set_radius(INNER, 0);
+  EXPECT_NE(rev, test_geom_->revision());
+  EXPECT_FLOAT_EQ(r_five_/2.0, test_geom_->radial_midpoint());
+  EXPECT_FLOAT_EQ(2*M_PI*len_five_*r_five_*r_five_, test_geom_->volume());
+}
@@ -210,12 +210,16 @@ TEST_F(LumpedNuclideTest, transportNuclidesPFM){
   // fill it with some material
   EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
 
-  // check that the expected amt of material is offered as the source term in one timestep
+  // check that the expected amt of material is offered as the source term 
+  // once it has passed through the delay of t_t timesteps
   // TRANSPORT NUCLIDES
   ASSERT_EQ(0, time_);
   time_++;
   ASSERT_EQ(1, time_);
   EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
+  EXPECT_FLOAT_EQ(0, nuc_model_ptr_->dirichlet_bc(u235_));
+  time_++;
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
   double expected_conc = test_C_0_[u235_]*exp(-t_t_);
 
   // Source Term
@@ -235,7 +239,7 @@ TEST_F(LumpedNuclideTest, transportNuclidesPFM){
   EXPECT_NO_THROW(nuc_model_ptr_->extract(extract_comp, extract_mass));
   // TRANSPORT NUCLIDES
   time_++;
-  ASSERT_EQ(2, time_);
+  ASSERT_EQ(3, time_);
   EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
 
   /// @TODO add behavior for later timesteps.
@@ -260,9 +264,11 @@ TEST_F(LumpedNuclideTest, transportNuclidesDM){
   time_++;
   ASSERT_EQ(1, time_);
   EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
+  // the first step of the breakthrough of the contained concentration
+  double expected_conc = ResidenceTime::create(DM, Pe, t_t_)->step(
+      test_C_0_)[u235_];
   double pow_arg = (Pe/2)*(1-pow(1+4*t_t_/Pe, 0.5));
-  double exponent = exp(pow_arg);
-  double expected_conc = (test_C_0_[u235_]*exponent);
+  EXPECT_LT(expected_conc, test_C_0_[u235_]*exp(pow_arg));
 
   // Source Term
   EXPECT_FLOAT_EQ(expected_conc*(lumped_ptr_->V_f()), nuc_model_ptr_->source_term_bc().second);
@@ -304,7 +310,10 @@ TEST_F(LumpedNuclideTest, transportNuclidesEXPM){
   time_++;
   ASSERT_EQ(1, time_);
   EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
-  double expected_conc = test_C_0_[u235_]/(1+time_);
+  // the first step of the breakthrough of the contained concentration
+  double expected_conc = ResidenceTime::create(EXPM, lumped_ptr_->Pe(), 
+      t_t_)->step(test_C_0_)[u235_];
+  EXPECT_LT(expected_conc, test_C_0_[u235_]/(1+t_t_));
 
   // Source Term
   EXPECT_FLOAT_EQ(expected_conc*(lumped_ptr_->V_f()), nuc_model_ptr_->source_term_bc().second);
@@ -447,6 +456,66 @@ TEST_F(LumpedNuclideTest, C_LAST_FORMULATION_TYPE){
   EXPECT_THROW(lumped_ptr_->update_conc_hist(time_, mats), CycException);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(LumpedNuclideTest, residence_time_steady_state){
+  IsoConcMap conc_map;
+  conc_map[u235_] = 10;
+  double Pe = 8;
+  for(int type = 0; type < LAST_FORMULATION_TYPE; type++){
+    FormulationType formulation = (FormulationType)type;
+    ResidenceTimePtr rtd = ResidenceTime::create(formulation, Pe, t_t_);
+    IsoConcMap out;
+    for(int t = 0; t < 200; t++){
+      out = rtd->step(conc_map);
+    }
+    EXPECT_NEAR(10*ResidenceTime::gain(formulation, Pe, t_t_), out[u235_], 1e-9);
+  }
+  EXPECT_EQ(4, ResidenceTime::create(DM, Pe, t_t_)->n_tanks());
+  EXPECT_THROW(ResidenceTime::create(DM, 0, t_t_), CycRangeException);
+  EXPECT_THROW(ResidenceTime::create(EXPM, Pe, -1), CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(LumpedNuclideTest, residence_time_breakthrough){
+  IsoConcMap conc_map;
+  conc_map[u235_] = 10;
+
+  // the PFM passes the inflow through after t_t timesteps
+  ResidenceTimePtr pfm = ResidenceTime::create(PFM, 0, 3);
+  for(int t = 0; t < 3; t++){
+    EXPECT_FLOAT_EQ(0, pfm->step(conc_map)[u235_]);
+  }
+  EXPECT_FLOAT_EQ(10*exp(-3.0), pfm->step(conc_map)[u235_]);
+
+  // the EXPM rises monotonically toward its steady state
+  ResidenceTimePtr expm = ResidenceTime::create(EXPM, 0, t_t_);
+  double last = 0;
+  for(int t = 0; t < 10; t++){
+    double out = expm->step(conc_map)[u235_];
+    EXPECT_GT(out, last);
+    EXPECT_LE(out, 10*expm->gain());
+    last = out;
+  }
+  expm->clear();
+  EXPECT_LT(expm->step(conc_map)[u235_], last);
+}
+
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(LumpedNuclideTest, conc_hist_breakthrough){
+  // the recorded concentration is the breakthrough that drives the release
+  EXPECT_NO_THROW(lumped_ptr_->set_formulation(EXPM));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  ResidenceTimePtr expm = ResidenceTime::create(EXPM, 0, t_t_);
+  for(int t = 1; t < 6; t++){
+    EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(t));
+    EXPECT_FLOAT_EQ(expm->step(test_C_0_)[u235_], 
+        nuc_model_ptr_->dirichlet_bc(u235_));
+  }
+  // and it never offers more than the component holds
+  double held = nuc_model_ptr_->contained_mass(5);
+  EXPECT_LE(nuc_model_ptr_->source_term_bc().second, held);
+}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 INSTANTIATE_TEST_CASE_P(LumpedNuclideModel, NuclideModelTests, Values(&LumpedNuclideModelConstructor));
@@ -389,3 +389,50 @@ TEST_F(MatToolsTest, linspace){
   }
 }
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, convolve){
+  // short series are summed directly
+  vector<double> a(3, 1);
+  vector<double> b(2, 2);
+  vector<double> c = MatTools::convolve(a, b, 5);
+  ASSERT_EQ(5, c.size());
+  EXPECT_FLOAT_EQ(2, c[0]);
+  EXPECT_FLOAT_EQ(4, c[1]);
+  EXPECT_FLOAT_EQ(4, c[2]);
+  EXPECT_FLOAT_EQ(2, c[3]);
+  EXPECT_FLOAT_EQ(0, c[4]);
+  EXPECT_TRUE(MatTools::convolve(a, vector<double>(), 3)[2] == 0);
+
+  // long series are convolved by FFT, and match the direct sum
+  int n = 500;
+  vector<double> sched(n, 0), resp(n, 0);
+  for(int i = 0; i < n; ++i){
+    sched[i] = (i % 7 == 0) ? 1.5 : 0;
+    resp[i] = exp(-i/100.0) - exp(-i/10.0);
+  }
+  c = MatTools::convolve(sched, resp, n);
+  ASSERT_EQ(n, c.size());
+  for(int k = 0; k < n; k += 37){
+    double direct = 0;
+    for(int j = 0; j <= k; ++j){
+      direct += sched[j]*resp[k-j];
+    }
+    EXPECT_NEAR(direct, c[k], 1e-9);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, fft){
+  vector<complex<double> > data(8, 0);
+  data[1] = 1;
+  vector<complex<double> > orig = data;
+  EXPECT_NO_THROW(MatTools::fft(data, false));
+  EXPECT_NO_THROW(MatTools::fft(data, true));
+  for(int i = 0; i < 8; ++i){
+    EXPECT_NEAR(orig[i].real(), data[i].real(), 1e-12);
+    EXPECT_NEAR(orig[i].imag(), data[i].imag(), 1e-12);
+  }
+  vector<complex<double> > odd(6, 0);
+  EXPECT_THROW(MatTools::fft(odd, false), CycRangeException);
+}
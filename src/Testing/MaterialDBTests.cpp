@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
 #include "MaterialDBTests.h"
+#include "CycException.h"
 
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -50,6 +51,31 @@ TEST_F(MaterialDBTest, get_mat_table){
   EXPECT_NO_THROW(MDB->table("clay", 1, 1, 1));
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, freeze){
+  MatDataTablePtr clay = MDB->table("clay", 0, 0, 0);
+  int id = MDB->curr_table_id();
+  EXPECT_FALSE(MDB->frozen());
+  MDB->freeze();
+  EXPECT_TRUE(MDB->frozen());
+  // populated tables are shared from the snapshot 
+  EXPECT_EQ(clay, MDB->table("clay", 0, 0, 0));
+  // and nothing new is added
+  EXPECT_THROW(MDB->table("clay", 2, 2, 2), CycException);
+  EXPECT_THROW(MDB->table("salt", 0, 0, 0), CycException);
+  EXPECT_EQ(id, MDB->curr_table_id());
+  // thawing keeps the tables, and allows new ones
+  MDB->thaw();
+  EXPECT_FALSE(MDB->frozen());
+  EXPECT_EQ(clay, MDB->table("clay", 0, 0, 0));
+  EXPECT_NO_THROW(MDB->table("clay", 2, 2, 2));
+  MDB->freeze();
+  // clearing the tables begins a new population phase
+  MDB->clearTables();
+  EXPECT_FALSE(MDB->frozen());
+  EXPECT_NO_THROW(MDB->table("clay", 2, 2, 2));
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(MaterialDBTest, DISABLED_listAvailableElems){
   // the DB should include all elements for each mat
@@ -197,6 +197,28 @@ TEST_F(MixedCellNuclideTest, set_porosity){
   EXPECT_NE(mixed_cell_ptr_->porosity(), porosity_);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MixedCellNuclideTest, cached_volumes){ 
+  // the pore volumes follow the porosity, degradation, and geometry
+  ASSERT_NO_THROW(mixed_cell_ptr_->set_porosity(porosity_));
+  ASSERT_NO_THROW(mixed_cell_ptr_->set_tot_deg(0.5));
+  double V_T = geom_->volume();
+  EXPECT_FLOAT_EQ(porosity_*V_T, mixed_cell_ptr_->V_f());
+  EXPECT_FLOAT_EQ((1-porosity_)*V_T, mixed_cell_ptr_->V_s());
+  EXPECT_FLOAT_EQ(0.5*porosity_*V_T, mixed_cell_ptr_->V_ff());
+
+  ASSERT_NO_THROW(mixed_cell_ptr_->set_porosity(2*porosity_));
+  EXPECT_FLOAT_EQ(2*porosity_*V_T, mixed_cell_ptr_->V_f());
+  ASSERT_NO_THROW(mixed_cell_ptr_->set_tot_deg(1));
+  EXPECT_FLOAT_EQ(2*porosity_*V_T, mixed_cell_ptr_->V_ff());
+
+  // changing the shared geometry is tracked by its revision
+  geom_->set_length(2*len_five_);
+  EXPECT_FLOAT_EQ(2*V_T, mixed_cell_ptr_->V_T());
+  EXPECT_FLOAT_EQ(4*porosity_*V_T, mixed_cell_ptr_->V_f());
+  EXPECT_FLOAT_EQ(4*porosity_*V_T, mixed_cell_ptr_->V_ff());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(MixedCellNuclideTest, total_degradation){
   deg_rate_=0.3;
@@ -217,6 +239,68 @@ TEST_F(MixedCellNuclideTest, total_degradation){
   EXPECT_FLOAT_EQ(1, mixed_cell_ptr_->tot_deg());
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MixedCellNuclideTest, step_size_release){ 
+  // a parent that steps every K months takes as much from its solubility 
+  // limited daughter as one that steps monthly
+  int K = 4;
+  double released[2];
+  for(int run = 0; run < 2; ++run){
+    mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(test_comp_));
+    mat->setQuantity(test_size_);
+    MixedCellNuclidePtr daughter = MixedCellNuclidePtr(initNuclideModel());
+    daughter->set_mat_table(mat_table_);
+    daughter->set_geom(GeometryPtr(new Geometry(r_four_, r_five_, 
+            geom_->centroid(), len_five_)));
+    ASSERT_NO_THROW(daughter->set_deg_rate(1));
+    daughter->set_sol_limited(true);
+    EXPECT_NO_THROW(daughter->absorb(mat));
+
+    MixedCellNuclidePtr parent = MixedCellNuclidePtr(initNuclideModel());
+    parent->set_mat_table(mat_table_);
+    parent->set_geom(GeometryPtr(new Geometry(r_five_, 2*r_five_, 
+            geom_->centroid(), len_five_)));
+    ASSERT_NO_THROW(parent->set_step_size(run == 0 ? 1 : K));
+    vector<NuclideModelPtr> daughters(1, daughter);
+    for(int t = 0; t <= K; ++t){
+      EXPECT_NO_THROW(daughter->transportNuclides(t));
+      if( parent->transport_due(t) ) {
+        parent->start_transport(t);
+        EXPECT_NO_THROW(parent->update_inner_bc(t, daughters));
+        EXPECT_NO_THROW(parent->transportNuclides(t));
+      }
+    }
+    released[run] = boost::dynamic_pointer_cast<NuclideModel>(parent)->contained_mass(K);
+    EXPECT_FLOAT_EQ(test_size_, released[run] + daughter->contained_mass());
+  }
+  EXPECT_GT(released[0], 0);
+  EXPECT_FLOAT_EQ(released[0], released[1]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MixedCellNuclideTest, source_term_sensitivities){ 
+  // without sorption or solubility limits, the source term is tot_deg*m_T
+  ASSERT_NO_THROW(mixed_cell_ptr_->set_deg_rate(deg_rate_));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_++));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_++));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_++));
+
+  vector<Iso> isos;
+  vector<double> dkg = nuc_model_ptr_->source_term_sensitivities(isos);
+  ASSERT_EQ(LAST_SENS_PARAM*isos.size(), dkg.size());
+  double m_st = mixed_cell_ptr_->source_term_bc().second;
+  double d_deg = 0;
+  for(int i = 0; i < isos.size(); ++i){
+    EXPECT_FLOAT_EQ(0, dkg[i*LAST_SENS_PARAM + SENS_POROSITY]);
+    EXPECT_FLOAT_EQ(0, dkg[i*LAST_SENS_PARAM + SENS_REF_KD]);
+    EXPECT_FLOAT_EQ(0, dkg[i*LAST_SENS_PARAM + SENS_REF_SOL]);
+    d_deg += dkg[i*LAST_SENS_PARAM + SENS_DEG_RATE];
+  }
+  EXPECT_FLOAT_EQ(m_st/deg_rate_, d_deg);
+  EXPECT_EQ("degradation", NuclideModel::sens_param_name(SENS_DEG_RATE));
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(MixedCellNuclideTest, transportNuclidesDR0){ 
   // if the degradation rate is zero, nothing should be released
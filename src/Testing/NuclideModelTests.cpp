@@ -72,6 +72,80 @@ TEST_P(NuclideModelTests, getVolume) {
   EXPECT_NO_THROW(nuclide_model_->geom()->volume());
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_P(NuclideModelTests, step_size){
+  // by default, the model advances every timestep
+  EXPECT_EQ(1, nuclide_model_->step_size());
+  EXPECT_TRUE(nuclide_model_->transport_due(7));
+  EXPECT_THROW(nuclide_model_->set_step_size(0), CycRangeException);
+
+  // a slow model advances only at multiples of its step size
+  EXPECT_NO_THROW(nuclide_model_->set_step_size(12));
+  EXPECT_FALSE(nuclide_model_->transport_due(7));
+  EXPECT_TRUE(nuclide_model_->transport_due(12));
+
+  // and each step covers the interval since the last
+  nuclide_model_->start_transport(12);
+  EXPECT_EQ(12, nuclide_model_->interval());
+  nuclide_model_->start_transport(24);
+  EXPECT_EQ(12, nuclide_model_->interval());
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_P(NuclideModelTests, adaptive){
+  EXPECT_FALSE(nuclide_model_->adaptive());
+  EXPECT_FALSE(nuclide_model_->refine(1));
+  EXPECT_THROW(nuclide_model_->set_adaptive(0, 12), CycRangeException);
+  EXPECT_NO_THROW(nuclide_model_->set_adaptive(0.01, 12));
+  EXPECT_TRUE(nuclide_model_->adaptive());
+
+  // the first step is always due 
+  EXPECT_TRUE(nuclide_model_->transport_due(5));
+  nuclide_model_->start_transport(5);
+  nuclide_model_->end_transport();
+  // the empty model did not change, so the step grows
+  EXPECT_EQ(2, nuclide_model_->step_size());
+  EXPECT_FALSE(nuclide_model_->transport_due(6));
+  EXPECT_TRUE(nuclide_model_->transport_due(7));
+  for(int i = 0; i < 5; i++){
+    nuclide_model_->end_transport();
+  }
+  EXPECT_EQ(12, nuclide_model_->step_size());
+
+  // a release into the empty model does not pin it to single steps
+  EXPECT_FALSE(nuclide_model_->refine(0));
+  EXPECT_FALSE(nuclide_model_->refine(1));
+  EXPECT_EQ(12, nuclide_model_->step_size());
+
+  // once it holds mass, a release beyond the tolerance refines the step
+  EXPECT_NO_THROW(nuclide_model_->absorb(test_mat_));
+  nuclide_model_->end_transport();
+  EXPECT_EQ(6, nuclide_model_->step_size());
+  EXPECT_FALSE(nuclide_model_->refine(0));
+  EXPECT_TRUE(nuclide_model_->refine(test_size_));
+  EXPECT_EQ(1, nuclide_model_->step_size());
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_P(NuclideModelTests, adaptive_first_step){
+  // the first step is measured from the inventory the model starts with, so 
+  // a full model that holds steady is not refined
+  EXPECT_NO_THROW(nuclide_model_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuclide_model_->set_adaptive(0.01, 12));
+  nuclide_model_->start_transport(0);
+  nuclide_model_->end_transport();
+  EXPECT_EQ(2, nuclide_model_->step_size());
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_P(NuclideModelTests, bc_snapshot_geom){
+  EXPECT_NO_THROW(nuclide_model_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuclide_model_->transportNuclides(time_));
+  nuclide_model_->bc_snapshot();
+  // a geometry edited mid step is not read from the stale snapshot
+  EXPECT_NO_THROW(geom_->set_radius(OUTER, 2*r_five_));
+  EXPECT_EQ(nuclide_model_->dirichlet_bc(), 
+      nuclide_model_->bc_snapshot().dirichlet_map);
+  EXPECT_FLOAT_EQ(nuclide_model_->source_term_bc().second, 
+      nuclide_model_->bc_snapshot().source_term.second);
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 TEST_P(NuclideModelTests, crude_source_term){
   // check that the source term bc doesn't throw
   // before any contaminants, it had best be 0
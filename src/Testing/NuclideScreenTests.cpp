@@ -0,0 +1,152 @@
+// NuclideScreenTests.cpp
+#include <gtest/gtest.h>
+
+#include "CycException.h"
+#include "Material.h"
+#include "NuclideScreen.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class NuclideScreenTest : public ::testing::Test {
+  protected:
+    Iso u238_, u235_, pu239_, cs137_, i131_, rem_;
+    IsoConcMap kg_;
+
+    virtual void SetUp(){
+      u238_ = 92238;
+      u235_ = 92235;
+      pu239_ = 94239;
+      cs137_ = 55137;
+      i131_ = 53131;
+      rem_ = 92236;
+      kg_[u238_] = 940;
+      kg_[u235_] = 50;
+      kg_[pu239_] = 9;
+      kg_[cs137_] = 0.9;
+      kg_[i131_] = 0.1;
+    }
+
+    /// sets the decay data of the stream's nuclides
+    void setNuclides(NuclideScreenPtr screen){
+      screen->set_nuclide(u238_, 4.468e9, 4.5e-8);
+      screen->set_nuclide(u235_, 7.04e8, 4.7e-8);
+      screen->set_nuclide(pu239_, 24110, 2.5e-7);
+      screen->set_nuclide(cs137_, 30.17, 1.3e-8);
+      screen->set_nuclide(i131_, 0.022, 2.2e-8);
+    }
+
+    /// returns the total mass of a stream
+    double total(const IsoConcMap& kg){
+      double to_ret = 0;
+      IsoConcMap::const_iterator entry;
+      for(entry = kg.begin(); entry != kg.end(); ++entry){
+        to_ret += (*entry).second;
+      }
+      return to_ret;
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(NuclideScreenTest, create){
+  NuclideScreenPtr screen = NuclideScreen::create(MASS_SCREEN, 0.99, 1, rem_);
+  EXPECT_EQ(MASS_SCREEN, screen->criterion());
+  EXPECT_FLOAT_EQ(0.99, screen->keep_fraction());
+  EXPECT_FLOAT_EQ(1, screen->min_half_life());
+  EXPECT_EQ(rem_, screen->remainder());
+  EXPECT_THROW(NuclideScreen::create(MASS_SCREEN, 0, 0, rem_),
+      CycRangeException);
+  EXPECT_THROW(NuclideScreen::create(MASS_SCREEN, 1.5, 0, rem_),
+      CycRangeException);
+  EXPECT_THROW(NuclideScreen::create(MASS_SCREEN, 1, -1, rem_),
+      CycRangeException);
+  // the screened mass always has a remainder to go to
+  EXPECT_THROW(NuclideScreen::create(MASS_SCREEN, 1, 0, 0), CycRangeException);
+  EXPECT_THROW(screen->set_nuclide(u238_, -1), CycRangeException);
+
+  EXPECT_EQ(ACTIVITY_SCREEN, NuclideScreen::criterionEnum("ACTIVITY"));
+  EXPECT_EQ(TOXICITY_SCREEN, NuclideScreen::criterionEnum("TOXICITY"));
+  EXPECT_EQ(LAST_SCREEN_CRITERION, NuclideScreen::criterionEnum("DOSE"));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(NuclideScreenTest, mass){
+  NuclideScreenPtr screen = NuclideScreen::create(MASS_SCREEN, 0.99, 0, rem_);
+  set<Iso> tracked = screen->significant(kg_);
+  ASSERT_EQ(2, tracked.size());
+  EXPECT_EQ(1, tracked.count(u238_));
+  EXPECT_EQ(1, tracked.count(u235_));
+
+  // the screened mass joins the remainder, not a tracked isotope
+  IsoConcMap screened = screen->screen(kg_);
+  ASSERT_EQ(3, screened.size());
+  EXPECT_FLOAT_EQ(940, screened[u238_]);
+  EXPECT_FLOAT_EQ(50, screened[u235_]);
+  EXPECT_FLOAT_EQ(10, screened[rem_]);
+  EXPECT_FLOAT_EQ(total(kg_), total(screened));
+  EXPECT_FLOAT_EQ(10, screen->lumped_kg());
+
+  // a keep_fraction of one tracks everything
+  EXPECT_EQ(kg_, NuclideScreen::create(MASS_SCREEN, 1, 0, rem_)->screen(kg_));
+
+  // a remainder that is a nuclide of the stream is refused
+  EXPECT_THROW(NuclideScreen::create(MASS_SCREEN, 0.99, 0, u238_)->screen(kg_),
+      CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(NuclideScreenTest, activity){
+  NuclideScreenPtr screen = NuclideScreen::create(ACTIVITY_SCREEN, 0.999, 0,
+      rem_);
+  setNuclides(screen);
+  // the short lived iodine dominates the activity
+  EXPECT_GT(screen->score(i131_, kg_[i131_]), screen->score(cs137_,
+        kg_[cs137_]));
+  EXPECT_GT(screen->score(cs137_, kg_[cs137_]), screen->score(u238_,
+        kg_[u238_]));
+  EXPECT_FLOAT_EQ(0, screen->score(26056, 1));
+  set<Iso> tracked = screen->significant(kg_);
+  EXPECT_EQ(1, tracked.count(i131_));
+  EXPECT_EQ(1, tracked.count(cs137_));
+  EXPECT_EQ(0, tracked.count(u238_));
+
+  // the screened mass is lumped into the remainder
+  IsoConcMap screened = screen->screen(kg_);
+  EXPECT_FLOAT_EQ(total(kg_), total(screened));
+  EXPECT_LT(0, screened[rem_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(NuclideScreenTest, timeScale){
+  NuclideScreenPtr screen = NuclideScreen::create(TOXICITY_SCREEN, 1, 1,
+      rem_);
+  setNuclides(screen);
+  // the iodine decays before transport matters, however toxic it is
+  set<Iso> tracked = screen->significant(kg_);
+  EXPECT_EQ(0, tracked.count(i131_));
+  EXPECT_EQ(4, tracked.size());
+  IsoConcMap screened = screen->screen(kg_);
+  EXPECT_FLOAT_EQ(kg_[i131_], screened[rem_]);
+  EXPECT_FLOAT_EQ(total(kg_), total(screened));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(NuclideScreenTest, material){
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  IsoConcMap::const_iterator entry;
+  for(entry = kg_.begin(); entry != kg_.end(); ++entry){
+    (*comp)[(*entry).first] = (*entry).second;
+  }
+  mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(comp));
+  mat->setQuantity(total(kg_));
+
+  // the remainder is split off rather than carried in the material
+  NuclideScreenPtr screen = NuclideScreen::create(MASS_SCREEN, 0.99, 0, rem_);
+  pair<mat_rsrc_ptr, double> screened = screen->screen(mat);
+  ASSERT_TRUE(screened.first);
+  EXPECT_FLOAT_EQ(10, screened.second);
+  EXPECT_FLOAT_EQ(total(kg_), screened.first->quantity() + screened.second);
+  EXPECT_FLOAT_EQ(0, screened.first->mass(rem_));
+  EXPECT_FLOAT_EQ(0, screened.first->mass(pu239_));
+  EXPECT_FLOAT_EQ(940, screened.first->mass(u238_));
+}
@@ -522,6 +522,47 @@ TEST_F(OneDimPPMNuclideTest, calculate_conc_diff_zero){
 TEST_F(OneDimPPMNuclideTest, calculate_conc_diff_real){
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(OneDimPPMNuclideTest, integrate_conc_diff){
+  // the cached kernel agrees with the trapezoidal rule over the profile
+  double a = r_four_;
+  double b = r_five_;
+  int n = 100;
+  IsoConcMap C_0, C_i;
+  C_0[u235_] = Co_;
+  C_i[u235_] = Ci_;
+  C_i[am241_] = Ci_;
+  time_ = 20;
+
+  map<double, IsoConcMap> f_map;
+  vector<double> calc_points = MatTools::linspace(a, b, n);
+  vector<double>::const_iterator pt;
+  for(pt = calc_points.begin(); pt != calc_points.end(); ++pt){
+    f_map.insert(make_pair(*pt, one_dim_ppm_ptr_->calculate_conc_diff(C_0, 
+            C_i, (*pt)-a, time_-1, time_)));
+  }
+  IsoConcMap expected = one_dim_ppm_ptr_->trap_rule(a, b, n-1, f_map);
+
+  KC->clear();
+  IsoConcMap actual = one_dim_ppm_ptr_->integrate_conc_diff(C_0, C_i, b-a, 
+      n, time_-1, time_);
+  EXPECT_NEAR(expected[u235_], actual[u235_], 1e-9*Co_*(b-a));
+  EXPECT_FLOAT_EQ(expected[am241_], actual[am241_]);
+  EXPECT_EQ(1, KC->size());
+
+  // a copy with the same material and step reuses the kernel
+  OneDimPPMNuclidePtr copy = OneDimPPMNuclidePtr(OneDimPPMNuclide::create());
+  copy->copy(*one_dim_ppm_ptr_);
+  copy->set_mat_table(mat_table_);
+  actual = copy->integrate_conc_diff(C_0, C_i, b-a, n, time_-1, time_);
+  EXPECT_NEAR(expected[u235_], actual[u235_], 1e-9*Co_*(b-a));
+  EXPECT_EQ(1, KC->size());
+
+  // a different step length needs its own kernel
+  one_dim_ppm_ptr_->integrate_conc_diff(C_0, C_i, b-a, n, time_-2, time_);
+  EXPECT_EQ(2, KC->size());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(OneDimPPMNuclideTest, contained_mass){ 
   time_++;
@@ -0,0 +1,168 @@
+// ReducerTests.cpp
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+
+#include "CycException.h"
+#include "Reducer.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class ReducerTest : public ::testing::Test {
+  protected:
+    int n_runs_, wf_id_, buffer_id_, template_id_, u235_, am241_;
+    vector<string> files_;
+
+    virtual void SetUp(){
+      n_runs_ = 5;
+      wf_id_ = 12;
+      buffer_id_ = 13;
+      template_id_ = 2;
+      u235_ = 92235;
+      am241_ = 95241;
+      for(int run = 0; run < n_runs_; ++run){
+        stringstream name;
+        name << "reducer_test_" << run << ".sqlite";
+        files_.push_back(name.str());
+        writeRun(name.str(), run);
+      }
+    }
+
+    virtual void TearDown(){
+      for(size_t run = 0; run < files_.size(); ++run){
+        remove(files_[run].c_str());
+      }
+    }
+
+  public:
+    /// the mass of an isotope in the waste form of a run at a time
+    double kg(int run, int iso, int t){
+      return (run + 1)*(iso == u235_ ? 2.0 : 0.5)*t;
+    }
+
+    /// writes a run whose waste form degrades at 0.1*(run + 1)
+    void writeRun(string file, int run){
+      remove(file.c_str());
+      sqlite3* db;
+      sqlite3_open(file.c_str(), &db);
+      stringstream sql;
+      sql << "CREATE TABLE contaminants (CompID INTEGER, Time INTEGER, "
+          << "IsoID INTEGER, MassKG REAL, AvailConc REAL);"
+          << "CREATE TABLE components (compID INTEGER, parentID INTEGER, "
+          << "compType INTEGER, name TEXT, material_data TEXT, "
+          << "nuclidemodel TEXT, paramsID INTEGER);"
+          << "CREATE TABLE NuclideModelParams (CompID INTEGER, "
+          << "ParamName TEXT, ParamVal REAL);"
+          << "INSERT INTO components VALUES (" << wf_id_
+          << ", 0, 2, 'wf', 'uox', 'DegRateNuclide', " << template_id_ << ");"
+          << "INSERT INTO components VALUES (" << buffer_id_
+          << ", 0, 0, 'buffer', 'clay', 'MixedCellNuclide', -1);"
+          << "INSERT INTO NuclideModelParams VALUES (" << template_id_
+          << ", 'degradation', " << 0.1*(run + 1) << ");"
+          << "INSERT INTO NuclideModelParams VALUES (" << template_id_
+          << ", 'advective_velocity', " << run % 2 << ");";
+      for(int t = 0; t < 10; ++t){
+        sql << "INSERT INTO contaminants VALUES (" << wf_id_ << ", " << t
+            << ", " << u235_ << ", " << kg(run, u235_, t) << ", 0);"
+            << "INSERT INTO contaminants VALUES (" << wf_id_ << ", " << t
+            << ", " << am241_ << ", " << kg(run, am241_, t) << ", 0);"
+            << "INSERT INTO contaminants VALUES (" << buffer_id_ << ", " << t
+            << ", " << u235_ << ", 1, 0);";
+      }
+      sqlite3_exec(db, sql.str().c_str(), NULL, NULL, NULL);
+      sqlite3_close(db);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ReducerTest, constructor){
+  Reducer reducer(0, 10, 3);
+  EXPECT_EQ(0, reducer.t0());
+  EXPECT_EQ(10, reducer.tf());
+  EXPECT_EQ(3, reducer.n_threads());
+  EXPECT_THROW(Reducer(10, 10, 1), CycRangeException);
+  EXPECT_NO_THROW(Reducer(0, -1, 1));
+  EXPECT_THROW(Reducer(0, 10, 0), CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ReducerTest, reduceRun){
+  run_summary_t run = Reducer::reduceRun(files_[1], 2, 8);
+  ASSERT_EQ(2, run.comp_mass.size());
+  ASSERT_EQ(6, run.comp_mass[wf_id_].size());
+  for(int t = 2; t < 8; ++t){
+    EXPECT_FLOAT_EQ(kg(1, u235_, t) + kg(1, am241_, t),
+        run.comp_mass[wf_id_][t - 2]);
+    EXPECT_FLOAT_EQ(kg(1, u235_, t) + 1, run.iso_mass[u235_][t - 2]);
+    EXPECT_FLOAT_EQ(kg(1, am241_, t), run.iso_mass[am241_][t - 2]);
+  }
+  EXPECT_FLOAT_EQ(kg(1, u235_, 5) + kg(1, am241_, 5),
+      Reducer::compMass(run, wf_id_, 5));
+  EXPECT_FLOAT_EQ(kg(1, u235_, 7) + kg(1, am241_, 7),
+      Reducer::compMass(run, wf_id_, -1));
+  EXPECT_THROW(Reducer::compMass(run, wf_id_, 9), CycRangeException);
+  // the waste form shares the params of its template
+  EXPECT_FLOAT_EQ(0.2, Reducer::param(run, wf_id_, "degradation"));
+  EXPECT_THROW(Reducer::param(run, buffer_id_, "degradation"),
+      CycException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ReducerTest, reduceToEnd){
+  // a negative tf reduces through the last timestep of the database
+  run_summary_t run = Reducer::reduceRun(files_[1], 2, -1);
+  ASSERT_EQ(8, run.comp_mass[wf_id_].size());
+  EXPECT_FLOAT_EQ(kg(1, u235_, 9) + kg(1, am241_, 9),
+      Reducer::compMass(run, wf_id_, 9));
+  EXPECT_THROW(Reducer::compMass(run, wf_id_, 10), CycRangeException);
+  vector<run_summary_t> runs = Reducer(0, -1, 2).reduce(files_);
+  EXPECT_EQ(10, runs[0].iso_mass[u235_].size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ReducerTest, reduce){
+  vector<run_summary_t> serial = Reducer(0, 10, 1).reduce(files_);
+  vector<run_summary_t> parallel = Reducer(0, 10, 3).reduce(files_);
+  ASSERT_EQ(n_runs_, serial.size());
+  ASSERT_EQ(n_runs_, parallel.size());
+  for(int run = 0; run < n_runs_; ++run){
+    EXPECT_EQ(files_[run], parallel[run].file);
+    EXPECT_EQ(serial[run].comp_mass, parallel[run].comp_mass);
+    EXPECT_EQ(serial[run].iso_mass, parallel[run].iso_mass);
+  }
+  vector<string> missing(files_);
+  missing.push_back("reducer_test_missing.sqlite");
+  EXPECT_THROW(Reducer(0, 10, 3).reduce(missing), CycException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ReducerTest, writePivot){
+  vector<run_summary_t> runs = Reducer(0, 10, 2).reduce(files_);
+  stringstream out;
+  Reducer::writePivot(out, runs, wf_id_, "degradation", "advective_velocity",
+      3);
+  string line;
+  getline(out, line);
+  EXPECT_EQ("File,degradation,advective_velocity,MassKG", line);
+  for(int run = 0; run < n_runs_; ++run){
+    getline(out, line);
+    stringstream expected;
+    expected.precision(15);
+    expected << files_[run] << "," << 0.1*(run + 1) << "," << run % 2 << ","
+      << kg(run, u235_, 3) + kg(run, am241_, 3);
+    EXPECT_EQ(expected.str(), line);
+  }
+
+  stringstream series;
+  Reducer::writeCompSeries(series, runs);
+  int n_lines = 0;
+  while( getline(series, line) ) {
+    ++n_lines;
+  }
+  // a header and a row per run, component and time
+  EXPECT_EQ(1 + n_runs_*2*10, n_lines);
+}
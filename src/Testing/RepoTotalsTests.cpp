@@ -0,0 +1,89 @@
+// RepoTotalsTests.cpp
+#include <gtest/gtest.h>
+
+#include "EventBuffer.h"
+#include "RepoTotals.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class RepoTotalsTest : public ::testing::Test {
+  protected:
+    Iso u235_, am241_;
+    RepoTotalsPtr totals_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      am241_ = 95241;
+      totals_ = RepoTotals::create();
+      EB->takeRepoTotals();
+      EB->takeRepoReleases();
+      EB->takeRepoPeaks();
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(RepoTotalsTest, addMass){
+  totals_->addMass(1, WF, u235_, 2, 0.5);
+  totals_->addMass(1, WF, u235_, 3, 0.25);
+  totals_->addMass(1, BUFFER, u235_, 1, 0.125);
+  totals_->addMass(1, WF, am241_, 4, 1);
+  EXPECT_FLOAT_EQ(5, totals_->mass(WF, u235_));
+  EXPECT_FLOAT_EQ(1, totals_->mass(BUFFER, u235_));
+  EXPECT_FLOAT_EQ(4, totals_->mass(WF, am241_));
+  EXPECT_FLOAT_EQ(0, totals_->mass(FF, u235_));
+  // the totals restart each tock
+  totals_->record(1);
+  EXPECT_FLOAT_EQ(0, totals_->mass(WF, u235_));
+  totals_->addMass(2, WF, u235_, 1, 0.1);
+  EXPECT_FLOAT_EQ(1, totals_->mass(WF, u235_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(RepoTotalsTest, releases){
+  totals_->addRelease(u235_, 2);
+  totals_->addRelease(u235_, 1);
+  EXPECT_FLOAT_EQ(3, totals_->released(u235_));
+  EXPECT_FLOAT_EQ(3, totals_->cumulative(u235_));
+  totals_->record(1);
+  // the cumulative release carries over
+  totals_->addRelease(u235_, 4);
+  EXPECT_FLOAT_EQ(4, totals_->released(u235_));
+  EXPECT_FLOAT_EQ(7, totals_->cumulative(u235_));
+  EXPECT_FLOAT_EQ(0, totals_->cumulative(am241_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(RepoTotalsTest, peak){
+  EXPECT_FLOAT_EQ(0, totals_->peak(WP, u235_).conc);
+  totals_->addMass(1, WP, u235_, 1, 0.5);
+  totals_->addMass(1, WP, u235_, 1, 0.75);
+  totals_->record(1);
+  totals_->addMass(2, WP, u235_, 1, 0.25);
+  totals_->record(2);
+  // the peak is the highest concentration in any component at any time
+  EXPECT_FLOAT_EQ(0.75, totals_->peak(WP, u235_).conc);
+  EXPECT_EQ(1, totals_->peak(WP, u235_).time);
+  totals_->addMass(3, WP, u235_, 1, 2);
+  EXPECT_FLOAT_EQ(2, totals_->peak(WP, u235_).conc);
+  EXPECT_EQ(3, totals_->peak(WP, u235_).time);
+  EXPECT_FLOAT_EQ(0, totals_->peak(WF, u235_).conc);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(RepoTotalsTest, record){
+  // the rows wait in the EventBuffer, in order, until it is flushed
+  totals_->addMass(1, WF, am241_, 4, 1);
+  totals_->addMass(1, WF, u235_, 2, 0.5);
+  totals_->addRelease(u235_, 3);
+  totals_->record(1);
+  vector<repo_total_row_t> rows = EB->takeRepoTotals();
+  ASSERT_EQ(2, rows.size());
+  EXPECT_EQ(u235_, rows[0].iso);
+  EXPECT_EQ(Component::componentTypeName(WF), rows[0].comp_type);
+  EXPECT_FLOAT_EQ(2, rows[0].kg);
+  vector<repo_release_row_t> releases = EB->takeRepoReleases();
+  ASSERT_EQ(1, releases.size());
+  EXPECT_FLOAT_EQ(3, releases[0].cumulative);
+  EXPECT_EQ(2, EB->takeRepoPeaks().size());
+}
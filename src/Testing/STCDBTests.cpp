@@ -1,6 +1,7 @@
 // STCDBTests.cpp
 #include <gtest/gtest.h>
 #include "STCDBTests.h"
+#include "CycException.h"
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(STCDBTest, createInstance){
@@ -26,6 +27,22 @@ TEST_F(STCDBTest, stcFromMatTopeTime){
  EXPECT_GT(SDB->stc(salt_struct_, Am241_, 2),0);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, freeze){
+  STCDataTablePtr salt = SDB->table(salt_struct_);
+  std::vector<double> k_range = SDB->k_th_range();
+  SDB->freeze();
+  EXPECT_TRUE(SDB->frozen());
+  EXPECT_EQ(salt, SDB->table(salt_struct_));
+  EXPECT_EQ(k_range, SDB->k_th_range());
+  EXPECT_FLOAT_EQ(salt->stc(Am241_, 2), SDB->stc(salt_struct_, Am241_, 2));
+  th_params_t other;
+  other.a(alpha_).k(k_).s(spacing_ + 1.5).r(r_calc_);
+  EXPECT_THROW(SDB->table(other), CycException);
+  SDB->thaw();
+  EXPECT_FALSE(SDB->frozen());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(STCDBTest, DISABLED_get_data_elem){
   // from a row object,
@@ -38,3 +55,110 @@ TEST_F(STCDBTest, DISABLED_get_temp_change){
   // the DB should give appropriate temperature changes for the materials
 }
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, tableIDThrowsForMissingParams){
+  th_params_t missing;
+  missing.a(-1).k(-1).s(-1).r(-1);
+  EXPECT_THROW(SDB->table_id(missing), CycException);
+  EXPECT_NO_THROW(SDB->table_id(salt_struct_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, stcArrayIndices){
+  std::map<Iso, int> iso_index;
+  std::map<int, int> time_index;
+  boost::multi_array<double, 2> arr = SDB->stc_array(SDB->table_id(salt_struct_), 
+      iso_index, time_index);
+  EXPECT_EQ(iso_index.size(), arr.shape()[0]);
+  EXPECT_EQ(time_index.size(), arr.shape()[1]);
+  // the indices are numbered in ascending order of their values
+  int expected = 0;
+  std::map<int, int>::iterator it;
+  for(it = time_index.begin(); it != time_index.end(); ++it){
+    EXPECT_EQ(expected++, (*it).second);
+  }
+  ASSERT_FALSE(iso_index.find(Am241_) == iso_index.end());
+  EXPECT_FLOAT_EQ(SDB->stc(salt_struct_, Am241_, 2), 
+      arr[iso_index[Am241_]][time_index[2]]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, ranges){
+  std::vector<double> k_range = SDB->k_th_range();
+  ASSERT_FALSE(k_range.empty());
+  for(int i = 1; i < k_range.size(); ++i){
+    EXPECT_LT(k_range[i-1], k_range[i]);
+  }
+  EXPECT_FALSE(SDB->alpha_th_range().empty());
+  EXPECT_FALSE(SDB->spacing_range().empty());
+  EXPECT_FALSE(SDB->r_calc_range().empty());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, weightsSumToOne){
+  // tabulated parameters have a single corner with weight one
+  STCWeights exact = SDB->weights(salt_struct_);
+  ASSERT_EQ(1, exact.size());
+  EXPECT_FLOAT_EQ(1, exact.front().second);
+
+  // between two tabulated k_th values, both neighbors contribute
+  std::vector<double> k_range = SDB->k_th_range();
+  ASSERT_LT(1, k_range.size());
+  th_params_t between = salt_struct_;
+  between.k(0.5*(k_range[0] + k_range[1]));
+  STCWeights mid = SDB->weights(between);
+  double w_tot = 0;
+  for(int i = 0; i < mid.size(); ++i){
+    w_tot += mid[i].second;
+  }
+  EXPECT_LE(2, mid.size());
+  EXPECT_FLOAT_EQ(1, w_tot);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, interpolateBetweenTabulated){
+  // bracket the fixture's tabulated k_th with the next tabulated value
+  th_params_t lo = salt_struct_;
+  th_params_t hi = salt_struct_;
+  hi.k(k_hi_);
+  ASSERT_TRUE(SDB->tabulated(lo));
+  ASSERT_TRUE(SDB->tabulated(hi));
+  th_params_t between = salt_struct_;
+  between.k(0.5*(k_ + k_hi_));
+  EXPECT_FALSE(SDB->tabulated(between));
+  double stc_lo = SDB->stc(lo, Am241_, 2);
+  double stc_hi = SDB->stc(hi, Am241_, 2);
+  double stc_mid;
+  EXPECT_NO_THROW(stc_mid = SDB->stc(between, Am241_, 2));
+  EXPECT_FLOAT_EQ(0.5*(stc_lo + stc_hi), stc_mid);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCDBTest, stcBetweenTimes){
+  // a table tabulated at times 2, 4 and 10
+  std::map<Iso, int> iso_index;
+  iso_index[Am241_] = 0;
+  std::map<int, int> time_index;
+  time_index[2] = 0;
+  time_index[4] = 1;
+  time_index[10] = 2;
+  boost::multi_array<double, 2> arr(boost::extents[1][3]);
+  arr[0][0] = 1;
+  arr[0][1] = 3;
+  arr[0][2] = 6;
+  STCDataTable table("test", arr, iso_index, time_index);
+  // it ramps up from zero at time zero
+  EXPECT_FLOAT_EQ(0, table.stc(Am241_, -1));
+  EXPECT_FLOAT_EQ(0, table.stc(Am241_, 0));
+  EXPECT_FLOAT_EQ(0.5, table.stc(Am241_, 1));
+  // is exact on the tabulated times and linear between them
+  EXPECT_FLOAT_EQ(1, table.stc(Am241_, 2));
+  EXPECT_FLOAT_EQ(2, table.stc(Am241_, 3));
+  EXPECT_FLOAT_EQ(3, table.stc(Am241_, 4));
+  EXPECT_FLOAT_EQ(4.5, table.stc(Am241_, 7));
+  EXPECT_FLOAT_EQ(6, table.stc(Am241_, 10));
+  // and holds its last value
+  EXPECT_FLOAT_EQ(6, table.stc(Am241_, 1000));
+  EXPECT_FLOAT_EQ(0, table.stc(Cs137_, 4));
+}
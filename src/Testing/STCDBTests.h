@@ -9,7 +9,7 @@ class STCDBTest : public ::testing::Test {
     std::vector<int> iso_ids_;
     Iso Cs135_, Cs137_, Sr90_, Am241_;
     th_params_t salt_struct_;
-    double alpha_, k_, spacing_, r_calc_;
+    double alpha_, k_, k_hi_, spacing_, r_calc_;
 
 
     virtual void SetUp(){
@@ -22,6 +22,8 @@ class STCDBTest : public ::testing::Test {
       alpha_ = 1;
       /// @TODO these values are not valid
       k_=1;
+      // the next tabulated k_th above k_
+      k_hi_=1.5;
       spacing_= 10;
       r_calc_= 2;
       iso_ids_.push_back(Cs135_);
@@ -32,5 +34,6 @@ class STCDBTest : public ::testing::Test {
     }
 
     virtual void TearDown(){
+      SDB->thaw();
     }
 };
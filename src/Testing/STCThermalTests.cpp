@@ -278,3 +278,62 @@ TEST_F(STCThermalTest, DISABLED_SuperimposeIsos){}
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 INSTANTIATE_TEST_CASE_P(STCThermalModel, ThermalModelTests, Values(&STCThermalModelConstructor));
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCThermalTest, r_calc){
+  EXPECT_FLOAT_EQ(r_calc_, stc_ptr_->r_calc());
+  STCThermalPtr test_copy = STCThermalPtr(STCThermal::create());
+  test_copy->copy(*stc_ptr_);
+  EXPECT_FLOAT_EQ(r_calc_, test_copy->r_calc());
+  EXPECT_FLOAT_EQ(stc_ptr_->getTempChange(Cs137_, 2), 
+      test_copy->getTempChange(Cs137_, 2));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCThermalTest, maxTempChange){
+  std::map<int, Temp> hist = stc_ptr_->getTempChange(hot_mat_);
+  std::pair<int, Temp> peak = stc_ptr_->getMaxTempChange(hot_mat_);
+  ASSERT_FALSE(hist.empty());
+  std::map<int, Temp>::iterator it;
+  for(it = hist.begin(); it != hist.end(); ++it){
+    EXPECT_LE((*it).second, peak.second);
+  }
+  EXPECT_FLOAT_EQ(hist[peak.first], peak.second);
+  EXPECT_FLOAT_EQ(hist[peak.first], stc_ptr_->getTempChange(hot_mat_, peak.first));
+  // the same recipe in twice the quantity has twice the temperature change
+  mat_rsrc_ptr twice_mat = mat_rsrc_ptr(new Material(hot_comp_));
+  twice_mat->setQuantity(2*hot_mat_->quantity());
+  EXPECT_EQ(peak.first, stc_ptr_->getMaxTempChange(twice_mat).first);
+  EXPECT_FLOAT_EQ(2*peak.second, stc_ptr_->getMaxTempChange(twice_mat).second);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCThermalTest, heatCurveReuse){
+  // each placement mixes the same recipe in a different quantity
+  HeatCurvePtr first = stc_ptr_->heatCurve(hot_mat_);
+  int n_curves = stc_ptr_->n_heat_curves();
+  for(int i = 1; i <= 10; ++i){
+    mat_rsrc_ptr placed = mat_rsrc_ptr(new Material(hot_comp_));
+    placed->setQuantity(hot_mat_->quantity()/3.0*i);
+    EXPECT_EQ(first, stc_ptr_->heatCurve(placed));
+  }
+  // so the cache does not grow
+  EXPECT_EQ(n_curves, stc_ptr_->n_heat_curves());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(STCThermalTest, heatCurveCacheBounded){
+  HeatCurvePtr hot = stc_ptr_->heatCurve(hot_mat_);
+  for(int i = 1; i <= 2*STCThermal::max_heat_curves(); ++i){
+    CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+    (*comp)[Cs135_] = 1000;
+    (*comp)[Cs137_] = i;
+    mat_rsrc_ptr mixed = mat_rsrc_ptr(new Material(comp));
+    mixed->setQuantity(1000 + i);
+    stc_ptr_->heatCurve(mixed);
+    EXPECT_GE(STCThermal::max_heat_curves(), stc_ptr_->n_heat_curves());
+    // a composition in constant use stays cached
+    EXPECT_EQ(hot, stc_ptr_->heatCurve(hot_mat_));
+  }
+  EXPECT_EQ(STCThermal::max_heat_curves(), stc_ptr_->n_heat_curves());
+}
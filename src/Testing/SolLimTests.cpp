@@ -201,3 +201,132 @@ TEST_F(SolLimTest, m_ps){
 
 
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(SolLimTest, inventory){
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 0.25;
+  (*comp)[92238] = 0.5;
+  (*comp)[55137] = 0.25;
+  (*comp)[1001] = 1e-20;
+  elem_inventory_t inv = SolLim::inventory(comp, test_size_, 1e-10);
+  ASSERT_EQ(2, inv.elems.size());
+  EXPECT_EQ(55, inv.elems[0]);
+  EXPECT_EQ(92, inv.elems[1]);
+  EXPECT_FLOAT_EQ(0.25*test_size_, inv.m_T[0]);
+  EXPECT_FLOAT_EQ(0.75*test_size_, inv.m_T[1]);
+  ASSERT_EQ(3, inv.isos.size());
+  EXPECT_EQ(1, inv.iso_elem[1]);
+  EXPECT_EQ(1, inv.iso_elem[2]);
+  EXPECT_FLOAT_EQ(0.5*test_size_, inv.iso_m_T[2]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(SolLimTest, array_kernels){
+  double V_f, V_ff, V_s, d;
+  vector<double> m_T, K_d, C_sol, m_ff, m_aff;
+  for(int i=1; i<10; i++){
+    m_T.push_back(0.1*i);
+    K_d.push_back(K_d_*i);
+    C_sol.push_back(0.01*i);
+  }
+  C_sol.back() = numeric_limits<double>::infinity();
+  for(int i=1; i<10; i++){
+    V_f=0.1*i;
+    V_s=0.2*i;
+    d=0.1*i;
+    V_ff=V_f*d;
+    SolLim::m_ff(m_T, K_d, V_s, V_f, d, m_ff);
+    SolLim::m_aff(m_ff, V_ff, C_sol, m_aff);
+    ASSERT_EQ(m_T.size(), m_aff.size());
+    for(int e=0; e<m_T.size(); e++){
+      EXPECT_FLOAT_EQ(SolLim::m_ff(m_T[e], K_d[e], V_s, V_f, d), m_ff[e]);
+      EXPECT_FLOAT_EQ(SolLim::m_aff(m_ff[e], V_ff, C_sol[e]), m_aff[e]);
+    }
+  }
+  // an unlimited element is unlimited even without free fluid
+  SolLim::m_aff(m_ff, 0, C_sol, m_aff);
+  EXPECT_FLOAT_EQ(m_ff.back(), m_aff.back());
+  EXPECT_FLOAT_EQ(m_ff.back(), SolLim::m_aff(m_ff.back(), 0, C_sol.back()));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(SolLimTest, partition_shares_element_limit){
+  // two uranium isotopes share the uranium solubility limit
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 0.25;
+  (*comp)[92238] = 0.75;
+  elem_inventory_t inv = SolLim::inventory(comp, test_size_, 0);
+  vector<double> K_d(1, 0);
+  vector<double> C_sol(1, 0.1);
+  double V_f = 1;
+  double V_s = 1;
+  double d = 1;
+  double V_ff = V_f*d;
+  vector<double> m_aff = SolLim::partition(inv, K_d, C_sol, V_s, V_f, V_ff, d);
+  ASSERT_EQ(2, m_aff.size());
+  EXPECT_FLOAT_EQ(C_sol[0]*V_ff, m_aff[0] + m_aff[1]);
+  EXPECT_FLOAT_EQ(3*m_aff[0], m_aff[1]);
+
+  // without a limit, everything degraded is available
+  C_sol[0] = numeric_limits<double>::infinity();
+  m_aff = SolLim::partition(inv, K_d, C_sol, V_s, V_f, V_ff, d);
+  EXPECT_FLOAT_EQ(0.25*test_size_, m_aff[0]);
+  EXPECT_FLOAT_EQ(0.75*test_size_, m_aff[1]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(SolLimTest, partition_sensitivities){
+  // the Dual partition agrees with a finite difference of the double one
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 0.25;
+  (*comp)[95241] = 0.75;
+  elem_inventory_t inv = SolLim::inventory(comp, test_size_, 0);
+  vector<double> K_d(2, K_d_);
+  vector<double> C_sol(2, numeric_limits<double>::infinity());
+  C_sol[1] = 0.001;
+  double V_T = 10;
+  double theta = 0.3;
+  double d = 0.5;
+
+  vector<sens_t> K_d_sens(2), C_sol_sens(2);
+  for(int e=0; e<2; e++){
+    K_d_sens[e] = sens_t::seed(K_d[e], SENS_REF_KD);
+    C_sol_sens[e] = sens_t(C_sol[e]);
+  }
+  C_sol_sens[1].set_d(SENS_REF_SOL, 1);
+  sens_t theta_sens = sens_t::seed(theta, SENS_POROSITY);
+  sens_t d_sens = sens_t::seed(d, SENS_DEG_RATE);
+  sens_t V_T_sens(V_T);
+  vector<sens_t> m_sens = SolLim::partition(inv, K_d_sens, C_sol_sens, 
+      MatTools::V_s(V_T_sens, theta_sens), MatTools::V_f(V_T_sens, theta_sens), 
+      MatTools::V_ff(V_T_sens, theta_sens, d_sens), d_sens);
+
+  double h = 1e-6;
+  vector<double> hi = SolLim::partition(inv, K_d, C_sol, 
+      MatTools::V_s(V_T, theta+h), MatTools::V_f(V_T, theta+h), 
+      MatTools::V_ff(V_T, theta+h, d), d);
+  vector<double> lo = SolLim::partition(inv, K_d, C_sol, 
+      MatTools::V_s(V_T, theta-h), MatTools::V_f(V_T, theta-h), 
+      MatTools::V_ff(V_T, theta-h, d), d);
+  ASSERT_EQ(hi.size(), m_sens.size());
+  for(int i=0; i<m_sens.size(); i++){
+    EXPECT_NEAR((hi[i]-lo[i])/(2*h), m_sens[i].d(SENS_POROSITY), 1e-4);
+  }
+
+  vector<double> K_d_hi(2, K_d_+h);
+  vector<double> K_d_lo(2, K_d_-h);
+  hi = SolLim::partition(inv, K_d_hi, C_sol, MatTools::V_s(V_T, theta), 
+      MatTools::V_f(V_T, theta), MatTools::V_ff(V_T, theta, d), d);
+  lo = SolLim::partition(inv, K_d_lo, C_sol, MatTools::V_s(V_T, theta), 
+      MatTools::V_f(V_T, theta), MatTools::V_ff(V_T, theta, d), d);
+  for(int i=0; i<m_sens.size(); i++){
+    EXPECT_NEAR((hi[i]-lo[i])/(2*h), m_sens[i].d(SENS_REF_KD), 1e-4);
+  }
+
+  // the solubility limited americium depends only on its limit
+  double V_ff = MatTools::V_ff(V_T, theta, d);
+  EXPECT_FLOAT_EQ(V_ff, m_sens[1].d(SENS_REF_SOL));
+  EXPECT_FLOAT_EQ(0, m_sens[1].d(SENS_REF_KD));
+  EXPECT_FLOAT_EQ(0, m_sens[0].d(SENS_REF_SOL));
+}
@@ -0,0 +1,192 @@
+// ThermalFieldTests.cpp
+#include <gtest/gtest.h>
+
+#include "ThermalFieldTests.h"
+#include "CycException.h"
+#include "XMLQueryEngine.h"
+
+using namespace std;
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void ThermalFieldTest::SetUp(){
+  k_th_ = 0.25;
+  alpha_th_ = 2.5;
+  spacing_ = 20;
+  r_calc_= 2;
+  cutoff_ = 50;
+  mat_name_ = "clay";
+
+  Cs135_ = 55135;
+  Cs137_ = 55137;
+  hot_comp_ = CompMapPtr(new CompMap(MASS));
+  (*hot_comp_)[Cs135_] = 1000;
+  (*hot_comp_)[Cs137_] = 1000;
+  hot_mat_ = mat_rsrc_ptr(new Material(hot_comp_));
+  hot_mat_->setQuantity(2000);
+
+  mat_table_ = MDB->table(mat_name_);
+  stc_ptr_ = initThermalModel();
+  stc_ptr_->set_mat_table(mat_table_);
+  peak_time_ = stc_ptr_->getMaxTempChange(hot_mat_).first;
+  field_ = ThermalField::create(stc_ptr_, cutoff_);
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void ThermalFieldTest::TearDown() {
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+STCThermalPtr ThermalFieldTest::initThermalModel(){
+  stringstream ss("");
+  ss << "<start>"
+     << "  <alpha_th>" << alpha_th_ << "</alpha_th>"
+     << "  <k_th>" << k_th_ << "</k_th>"
+     << "  <material_data>" << mat_name_ << "</material_data>"
+     << "  <r_calc>" << r_calc_ << "</r_calc>"
+     << "  <spacing>" << spacing_ << "</spacing>"
+     << "</start>";
+
+  XMLParser parser;
+  parser.init(ss);
+  XMLQueryEngine* engine = new XMLQueryEngine(parser);
+  STCThermalPtr to_ret = STCThermalPtr(STCThermal::create());
+  to_ret->initModuleMembers(engine);
+  delete engine;
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, constructor){
+  EXPECT_FLOAT_EQ(cutoff_, field_->cutoff());
+  EXPECT_FLOAT_EQ(0, field_->peak_temp());
+  EXPECT_THROW(ThermalField::create(STCThermalPtr(), cutoff_), CycException);
+  EXPECT_THROW(ThermalField::create(stc_ptr_, -1), CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, singleSource){
+  point_t origin = {0,0,0};
+  EXPECT_NO_THROW(field_->addSource(origin, 0, hot_mat_));
+  // at its own centroid, a lone source matches the STC model
+  EXPECT_FLOAT_EQ(stc_ptr_->getTempChange(hot_mat_, peak_time_), 
+      field_->temp(origin, peak_time_));
+  EXPECT_NO_THROW(field_->transportHeat(peak_time_));
+  EXPECT_FLOAT_EQ(field_->temp(origin, peak_time_), field_->peak_temp());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, superposition){
+  point_t left = {0,0,0};
+  point_t right = {2*spacing_,0,0};
+  point_t mid = {spacing_,0,0};
+  field_->addSource(left, 0, hot_mat_);
+  Temp one = field_->temp(mid, peak_time_);
+  field_->addSource(right, 0, hot_mat_);
+  // two symmetric sources heat the midpoint twice as much as one
+  EXPECT_GT(one, 0);
+  EXPECT_FLOAT_EQ(2*one, field_->temp(mid, peak_time_));
+  // and heat each other equally
+  field_->transportHeat(peak_time_);
+  ASSERT_EQ(2, field_->temps().size());
+  EXPECT_FLOAT_EQ(field_->temps()[0], field_->temps()[1]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, cutoff){
+  point_t origin = {0,0,0};
+  point_t far = {2*cutoff_,0,0};
+  field_->addSource(far, 0, hot_mat_);
+  EXPECT_FLOAT_EQ(0, field_->temp(origin, peak_time_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, mat_acceptable){
+  point_t origin = {0,0,0};
+  point_t next = {spacing_,0,0};
+  Temp alone = field_->projected_peak(next, 0, hot_mat_);
+  EXPECT_TRUE(field_->mat_acceptable(next, 0, hot_mat_, 2*alone));
+  // a neighbor raises the projected peak
+  field_->addSource(origin, 0, hot_mat_);
+  EXPECT_GT(field_->projected_peak(next, 0, hot_mat_), alone);
+  EXPECT_FALSE(field_->mat_acceptable(next, 0, hot_mat_, alone));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, projectedPeakMatchesSuperposition){
+  point_t origin = {0,0,0};
+  point_t next = {spacing_,0,0};
+  // the same field, with and without the candidate emplaced at time 3
+  ThermalFieldPtr with = ThermalField::create(stc_ptr_, cutoff_);
+  for(int t = 0; t < 3; ++t){
+    field_->addSource(origin, t, hot_mat_);
+    with->addSource(origin, t, hot_mat_);
+  }
+  with->addSource(next, 3, hot_mat_);
+  Temp brute = 0;
+  const vector<int>& times = stc_ptr_->heatTimes();
+  for(int t = 0; t < times.size(); ++t){
+    brute = max(brute, with->temp(next, 3 + times[t]));
+  }
+  EXPECT_NEAR(brute, field_->projected_peak(next, 3, hot_mat_), 
+      1e-6*(1 + brute));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, history){
+  point_t loc = {spacing_/2,0,0};
+  int end_time = 3*peak_time_ + 10;
+  // a package every other month, alternating sides
+  for(int t = 0; t < end_time; t += 2){
+    point_t src = {(t % 4 == 0) ? 0 : spacing_, 0, 0};
+    field_->addSource(src, t, hot_mat_);
+  }
+  vector<Temp> hist = field_->history(loc, end_time);
+  ASSERT_EQ(end_time + 1, hist.size());
+  for(int t = 0; t <= end_time; ++t){
+    EXPECT_NEAR(field_->temp(loc, t), hist[t], 1e-6*(1+hist[t]));
+  }
+  EXPECT_TRUE(field_->history(loc, -1).empty());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, projectedPeakCools){
+  point_t origin = {0,0,0};
+  point_t next = {spacing_,0,0};
+  field_->addSource(origin, 0, hot_mat_);
+  field_->transportHeat(peak_time_);
+  // without a candidate, the projection is the field alone over the window
+  const vector<int>& times = stc_ptr_->heatTimes();
+  int late = peak_time_ + 1;
+  Temp brute = 0;
+  for(int t = 0; t < times.size(); ++t){
+    brute = max(brute, field_->temp(next, late + times[t]));
+  }
+  EXPECT_NEAR(brute, field_->projected_peak(next, late), 1e-6*(1 + brute));
+  // the running peak never falls, but the projection does once it cools
+  int cooled = 10*times.back();
+  EXPECT_LT(field_->projected_peak(origin, cooled), field_->peak_temp());
+  EXPECT_FLOAT_EQ(field_->temp(origin, peak_time_), field_->peak_temp());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ThermalFieldTest, responsesBounded){
+  point_t loc = {spacing_/2,0,0};
+  int n = STCThermal::max_heat_curves() + 10;
+  // more distinct compositions than the caches hold, evicting hot_mat_'s 
+  // heat curve before it is emplaced again
+  field_->addSource(loc, 0, hot_mat_);
+  for(int i = 1; i <= n; ++i){
+    CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+    (*comp)[Cs135_] = 1000;
+    (*comp)[Cs137_] = 1000 + i;
+    mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(comp));
+    mat->setQuantity(1);
+    field_->addSource(loc, 0, mat);
+    field_->history(loc, 1);
+  }
+  field_->addSource(loc, 1, hot_mat_);
+  EXPECT_GE(STCThermal::max_heat_curves(), field_->n_responses());
+  // the recreated curve shares the response of its composition
+  vector<Temp> hist = field_->history(loc, peak_time_);
+  EXPECT_NEAR(field_->temp(loc, peak_time_), hist[peak_time_], 
+      1e-6*(1 + hist[peak_time_]));
+  EXPECT_GE(STCThermal::max_heat_curves(), field_->n_responses());
+}
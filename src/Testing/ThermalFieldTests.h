@@ -0,0 +1,32 @@
+// ThermalFieldTests.h
+#include <gtest/gtest.h>
+
+#include "ThermalField.h"
+#include "MatDataTable.h"
+#include "MaterialDB.h"
+#include <string>
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class ThermalFieldTest : public ::testing::Test {
+protected:
+  
+  ThermalFieldPtr field_;
+  STCThermalPtr stc_ptr_;
+  double r_calc_;
+  double alpha_th_;
+  double k_th_;
+  double spacing_;
+  double cutoff_;
+  std::string mat_name_;
+  MatDataTablePtr mat_table_;
+  int peak_time_;
+
+  int Cs135_, Cs137_;
+  CompMapPtr hot_comp_;
+  mat_rsrc_ptr hot_mat_;
+  
+  virtual void SetUp();
+  virtual void TearDown();
+  STCThermalPtr initThermalModel();
+};
+
@@ -0,0 +1,214 @@
+/*! \file ThermalField.cpp
+    \brief Implements the ThermalField class, which superposes the heat of the
+    emplaced waste packages over the repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "MatTools.h"
+#include "ThermalField.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThermalField::ThermalField(STCThermalPtr model, double cutoff) :
+  model_(model),
+  cutoff_(cutoff),
+  cell_size_(cutoff > 0 ? cutoff : 1),
+  peak_temp_(0)
+{
+  if( model_ == NULL ) {
+    string err = "The ThermalField requires an STCThermal model.";
+    LOG(LEV_ERROR, "CydThF") << err;
+    throw CycException(err);
+  }
+  MatTools::validate_finite_pos(cutoff);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThermalField::cell_t ThermalField::cell(point_t loc){
+  return make_pair(int(floor(loc.x_/cell_size_)), int(floor(loc.y_/cell_size_)));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalField::addSource(point_t loc, int the_time, mat_rsrc_ptr mat){
+  heat_source_t src;
+  src.loc = loc;
+  src.time = the_time;
+  src.kg = mat->quantity();
+  src.heat = model_->heatCurve(mat);
+  src.key = STCThermal::heatKey(mat);
+  grid_[cell(loc)].push_back(sources_.size());
+  sources_.push_back(src);
+  temps_.push_back(0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::contribution(const heat_source_t& src, point_t loc,
+    int the_time){
+  return falloff(distance(src, loc))*model_->getTempChange(src.heat, src.kg, the_time - src.time);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ThermalField::distance(const heat_source_t& src, point_t loc){
+  double dx = loc.x_ - src.loc.x_;
+  double dy = loc.y_ - src.loc.y_;
+  double dz = loc.z_ - src.loc.z_;
+  return sqrt(dx*dx + dy*dy + dz*dz);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ThermalField::falloff(double r){
+  if( r > cutoff_ ) {
+    return 0;
+  }
+  // the heat curve is the temperature change at r_calc. within r_calc,
+  // including the source's own centroid, it is taken as is.
+  double r_calc = model_->r_calc();
+  return (r > r_calc && r > 0) ? r_calc/r : 1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<int> ThermalField::neighbors(point_t loc){
+  vector<int> to_ret;
+  cell_t center = cell(loc);
+  map<cell_t, vector<int> >::iterator found;
+  for(int i = center.first - 1; i <= center.first + 1; ++i){
+    for(int j = center.second - 1; j <= center.second + 1; ++j){
+      found = grid_.find(make_pair(i, j));
+      if( found != grid_.end() ) {
+        to_ret.insert(to_ret.end(), (*found).second.begin(), 
+            (*found).second.end());
+      }
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::temp(point_t loc, int the_time){
+  Temp to_ret = 0;
+  vector<int> inds = neighbors(loc);
+  for(int s = 0; s < inds.size(); ++s){
+    to_ret += contribution(sources_[inds[s]], loc, the_time);
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<Temp> ThermalField::history(point_t loc, int end_time){
+  int n = end_time + 1;
+  vector<Temp> to_ret(max(n, 0), 0);
+  if( n <= 0 ) {
+    return to_ret;
+  }
+
+  // the emplacement schedule, as kg at r_calc emplaced at each timestep, 
+  // for each distinct composition, and a heat curve of that composition
+  map<HeatKey, vector<double> > schedules;
+  map<HeatKey, HeatCurvePtr> curves;
+  vector<int> inds = neighbors(loc);
+  for(int s = 0; s < inds.size(); ++s){
+    const heat_source_t& src = sources_[inds[s]];
+    double weight = falloff(distance(src, loc));
+    if( weight == 0 || src.time < 0 || src.time > end_time ) {
+      continue;
+    }
+    vector<double>& schedule = schedules[src.key];
+    if( schedule.empty() ) {
+      schedule.resize(n, 0);
+      curves[src.key] = src.heat;
+    }
+    schedule[src.time] += src.kg*weight;
+  }
+
+  // each schedule convolved with its per kg response
+  map<HeatKey, vector<double> >::iterator it;
+  for(it = schedules.begin(); it != schedules.end(); ++it){
+    vector<double> temps = MatTools::convolve((*it).second, 
+        response((*it).first, curves[(*it).first], n), n);
+    for(int t = 0; t < n; ++t){
+      to_ret[t] += temps[t];
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const vector<Temp>& ThermalField::response(const HeatKey& key, 
+    HeatCurvePtr heat, int n){
+  map<HeatKey, pair<vector<Temp>, list<HeatKey>::iterator> >::iterator 
+    found = responses_.find(key);
+  if( found != responses_.end() ) {
+    // move the composition to the front of the recency list
+    recent_.splice(recent_.begin(), recent_, (*found).second.second);
+  } else {
+    // make room by dropping the least recently used response
+    if( responses_.size() >= STCThermal::max_heat_curves() ) {
+      responses_.erase(recent_.back());
+      recent_.pop_back();
+    }
+    recent_.push_front(key);
+    found = responses_.insert(make_pair(key, 
+          make_pair(vector<Temp>(), recent_.begin()))).first;
+  }
+  vector<Temp>& to_ret = (*found).second.first;
+  for(int t = to_ret.size(); t < n; ++t){
+    to_ret.push_back(model_->getTempChange(heat, 1, t));
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalField::transportHeat(int the_time){
+  for(int s = 0; s < sources_.size(); ++s){
+    temps_[s] = temp(sources_[s].loc, the_time);
+    peak_temp_ = max(peak_temp_, temps_[s]);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::projected_peak(point_t loc, int the_time, mat_rsrc_ptr mat){
+  heat_source_t src;
+  src.loc = loc;
+  src.time = the_time;
+  src.kg = mat->quantity();
+  src.heat = model_->heatCurve(mat);
+  src.key = STCThermal::heatKey(mat);
+  return window_peak(loc, the_time, &src);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::projected_peak(point_t loc, int the_time){
+  return window_peak(loc, the_time, NULL);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::window_peak(point_t loc, int the_time, 
+    const heat_source_t* src){
+  Temp to_ret = 0;
+  const vector<int>& times = model_->heatTimes();
+  if( times.empty() ) {
+    return to_ret;
+  }
+  // the heat of the emplaced sources, convolved once over the whole window
+  vector<Temp> field = history(loc, the_time + times.back());
+  for(int t = 0; t < times.size(); ++t){
+    int when = the_time + times[t];
+    if( when < 0 || when >= field.size() ) {
+      continue;
+    }
+    Temp own = (src == NULL) ? 0 : contribution(*src, loc, when);
+    to_ret = max(to_ret, field[when] + own);
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThermalField::mat_acceptable(point_t loc, int the_time, mat_rsrc_ptr mat,
+    Temp t_lim){
+  return projected_peak(loc, the_time, mat) < t_lim;
+}
@@ -0,0 +1,241 @@
+/*! \file ThermalField.h
+  \brief Declares the ThermalField class, which superposes the heat of the
+  emplaced waste packages over the repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_THERMALFIELD_H)
+#define _THERMALFIELD_H
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "Geometry.h"
+#include "STCThermal.h"
+
+/// A shared pointer for the ThermalField object
+class ThermalField;
+typedef boost::shared_ptr<ThermalField> ThermalFieldPtr;
+
+/**
+   Defines a heat source, a waste package emplaced in the repository.
+ */
+typedef struct heat_source_t
+{
+  point_t loc; /**< the centroid of the source [m] >**/
+  int time; /**< the timestep at which the source was emplaced >**/
+  double kg; /**< the mass of the source [kg] >**/
+  HeatCurvePtr heat; /**< the heat curve per kg of the source composition >**/
+  HeatKey key; /**< the rounded composition of the source >**/
+} heat_source_t;
+
+/**
+   @brief ThermalField superposes the STC heat of every emplaced package.
+
+   Each emplaced waste package is a heat source whose temperature change at
+   r_calc over time is given by the STCThermal heat curve of its
+   composition. The temperature change at a point is the sum of the
+   time-shifted curves of the sources around it. The contribution of a
+   source at distance r > r_calc is scaled by r_calc/r, the steady
+   conduction falloff of a point source. This bounds the transient falloff
+   from above, so the field is conservative.
+
+   Sources farther than the cutoff radius are neglected. The sources are
+   binned on an x/y grid with cells as wide as the cutoff, so a query only
+   visits the neighboring cells. Updating the temperature at every source
+   is then O(N log N) rather than O(N^2) in the number of sources.
+ */
+class ThermalField {
+private:
+  /**
+     The constructor for the ThermalField.
+
+     @param model the STCThermal model providing heat curves and r_calc
+     @param cutoff the radius beyond which sources are neglected [m]
+   */
+  ThermalField(STCThermalPtr model, double cutoff);
+
+public:
+  /**
+     A constructor for the ThermalField that returns a shared pointer.
+
+     @param model the STCThermal model providing heat curves and r_calc
+     @param cutoff the radius beyond which sources are neglected [m]
+    */
+  static ThermalFieldPtr create(STCThermalPtr model, double cutoff){
+    return ThermalFieldPtr(new ThermalField(model, cutoff)); };
+
+  /// Default destructor
+  ~ThermalField() {};
+
+  /**
+     Adds a heat source to the field.
+
+     @param loc the centroid of the source [m]
+     @param the_time the timestep at which the source was emplaced
+     @param mat the material in the source
+    */
+  void addSource(point_t loc, int the_time, mat_rsrc_ptr mat);
+
+  /**
+     Returns the temperature change at a point due to all sources within the
+     cutoff radius.
+
+     @param loc the point at which to find the temperature change [m]
+     @param the_time the timestep at which to find the temperature change
+     @return the temperature change [K]
+    */
+  Temp temp(point_t loc, int the_time);
+
+  /**
+     Returns the temperature change at a point at every timestep from 0 to
+     end_time. The sources around the point are grouped by heat curve into
+     emplacement schedules, and each schedule is convolved with its sampled
+     heat curve by FFT. This costs O(T log T) per heat curve, rather than
+     the O(T^2) of calling temp() at every timestep.
+
+     @param loc the point at which to find the temperature change [m]
+     @param end_time the last timestep of the history
+     @return the temperature change at each timestep [K]
+    */
+  std::vector<Temp> history(point_t loc, int end_time);
+
+  /**
+     Updates the temperature change at the centroid of every source and the
+     peak temperature change over all sources and times so far.
+
+     @param the_time the timestep at which to transport the heat
+    */
+  void transportHeat(int the_time);
+
+  /**
+     Returns the projected peak temperature change at loc if mat were
+     emplaced there at the_time. The projection is evaluated at each
+     tabulated time after the_time. The heat of the sources already
+     emplaced comes from a single history() over that window, so a check
+     costs O(T log T) rather than a temp() per tabulated time.
+
+     @param loc the point at which mat would be emplaced [m]
+     @param the_time the timestep at which mat would be emplaced
+     @param mat the material that would be emplaced
+     @return the projected peak temperature change [K]
+    */
+  Temp projected_peak(point_t loc, int the_time, mat_rsrc_ptr mat);
+
+  /**
+     Returns the projected peak temperature change at loc due to the sources
+     already emplaced, over the window in which a package emplaced there at
+     the_time would be checked. Unlike peak_temp(), this falls again once
+     the field cools.
+
+     @param loc the point at which a package would be emplaced [m]
+     @param the_time the timestep at which a package would be emplaced
+     @return the projected peak temperature change [K]
+    */
+  Temp projected_peak(point_t loc, int the_time);
+
+  /**
+     Returns true if emplacing mat at loc at the_time keeps the projected
+     peak temperature change at loc below t_lim.
+
+     @param loc the point at which mat would be emplaced [m]
+     @param the_time the timestep at which mat would be emplaced
+     @param mat the material that would be emplaced
+     @param t_lim the limiting temperature [K]
+    */
+  bool mat_acceptable(point_t loc, int the_time, mat_rsrc_ptr mat, Temp t_lim);
+
+  /// returns the peak temperature change at any source centroid so far [K]
+  Temp peak_temp(){return peak_temp_;};
+
+  /// returns the temperature change at each source as of the last update [K]
+  const std::vector<Temp>& temps(){return temps_;};
+
+  /// returns the heat sources, in order of emplacement
+  const std::vector<heat_source_t>& sources(){return sources_;};
+
+  /// returns the radius beyond which sources are neglected [m]
+  double cutoff(){return cutoff_;};
+
+  /// returns the number of sampled heat curves in the cache
+  int n_responses(){return responses_.size();};
+
+protected:
+  /// The x/y grid cell of a heat source
+  typedef std::pair<int, int> cell_t;
+
+  /// returns the grid cell holding loc
+  cell_t cell(point_t loc);
+
+  /**
+     Returns the temperature change at loc due to one source.
+
+     @param src the heat source
+     @param loc the point at which to find the temperature change [m]
+     @param the_time the timestep at which to find the temperature change
+    */
+  Temp contribution(const heat_source_t& src, point_t loc, int the_time);
+
+  /// returns the distance from a source to loc [m]
+  double distance(const heat_source_t& src, point_t loc);
+
+  /// returns the scaling of a heat curve at distance r from its source
+  double falloff(double r);
+
+  /// returns the indices of the sources in the cells neighboring loc
+  std::vector<int> neighbors(point_t loc);
+
+  /**
+     Returns the peak over the projection window of the_time of the field
+     of the emplaced sources, plus that of src if it is given.
+
+     @param loc the point at which to find the peak [m]
+     @param the_time the timestep at which the window starts
+     @param src the candidate source, or NULL for none
+    */
+  Temp window_peak(point_t loc, int the_time, const heat_source_t* src);
+
+  /**
+     Returns the per kg temperature change of a composition at each timestep 
+     after emplacement, for at least n timesteps. The responses are cached 
+     by composition, and at most STCThermal::max_heat_curves() of them are 
+     kept, the least recently used being dropped first.
+
+     @param key the rounded composition
+     @param heat the heat curve of the composition
+     @param n the number of timesteps
+    */
+  const std::vector<Temp>& response(const HeatKey& key, HeatCurvePtr heat, 
+      int n);
+
+  /// the STCThermal model providing heat curves and r_calc
+  STCThermalPtr model_;
+
+  /// the radius beyond which sources are neglected [m]
+  double cutoff_;
+
+  /// the width of a grid cell [m]
+  double cell_size_;
+
+  /// the heat sources, in order of emplacement
+  std::vector<heat_source_t> sources_;
+
+  /// the indices of the sources in each grid cell
+  std::map<cell_t, std::vector<int> > grid_;
+
+  /// the temperature change at each source as of the last update [K]
+  std::vector<Temp> temps_;
+
+  /// the peak temperature change at any source centroid so far [K]
+  Temp peak_temp_;
+
+  /// the per kg heat curves sampled at each timestep, by composition, and 
+  /// their place in recent_
+  std::map<HeatKey, std::pair<std::vector<Temp>, 
+    std::list<HeatKey>::iterator> > responses_;
+
+  /// the compositions in responses_, most recently used first
+  std::list<HeatKey> recent_;
+};
+
+#endif
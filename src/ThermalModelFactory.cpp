@@ -18,8 +18,8 @@ using boost::lexical_cast;
 
 std::string ThermalModelFactory::thermal_type_names_[] = {
   "LumpedThermal",
-  "STCThermal",
-  "StubThermal"
+  "StubThermal",
+  "STCThermal"
 };
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -27,17 +27,18 @@ ThermalModelPtr ThermalModelFactory::thermalModel(QueryEngine* qe){
   ThermalModelPtr to_ret;
 
   std::string model_name = qe->getElementName();;
+  QueryEngine* input = qe->queryElement(model_name);
   
   switch(thermalEnum(model_name))
   {
     case LUMPED_THERMAL:
-      to_ret = ThermalModelPtr(LumpedThermal::create(qe));
+      to_ret = ThermalModelPtr(LumpedThermal::create(input));
       break;
     case STUB_THERMAL:
-      to_ret = ThermalModelPtr(StubThermal::create(qe));
+      to_ret = ThermalModelPtr(StubThermal::create(input));
       break;
     case STC_THERMAL:
-      to_ret = ThermalModelPtr(LumpedThermal::create(qe));
+      to_ret = ThermalModelPtr(STCThermal::create(input));
       break;
     default:
       throw CycException("Unknown thermal model enum value encountered."); 
@@ -68,7 +69,7 @@ ThermalModelPtr ThermalModelFactory::thermalModel(ThermalModelPtr src,
       to_ret = ThermalModelPtr(StubThermal::create());
       break;
     case STC_THERMAL: 
-      to_ret = ThermalModelPtr(LumpedThermal::create());
+      to_ret = ThermalModelPtr(STCThermal::create());
       break;
     default:
       throw CycException("Unknown thermal model enum value encountered when copying."); 